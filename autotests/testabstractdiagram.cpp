@@ -5,6 +5,7 @@
 // this forces the header to be self-contained.
 #include "abstractdiagram.h"
 
+#include "helperconstants.h"
 #include "helpermath.h"
 #include <qbrush.h>
 #include <qcolor.h>
@@ -16,6 +17,7 @@
 #include <qsize.h>
 #include <qtest.h>
 #include <qtestcase.h>
+#include <qwidget.h>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -182,6 +184,46 @@ private Q_SLOTS:
         QCOMPARE(temp.handleColorFromBackgroundLightness(100), QColor(Qt::black));
         QCOMPARE(temp.handleColorFromBackgroundLightness(101), QColor(Qt::black));
     }
+
+    void testResizeRenderDelay()
+    {
+        AbstractDiagram temp;
+        QCOMPARE(temp.resizeRenderDelay(), diagramResizeRenderDelay);
+        temp.setResizeRenderDelay(10);
+        QCOMPARE(temp.resizeRenderDelay(), 10);
+        temp.setResizeRenderDelay(-1);
+        QCOMPARE(temp.resizeRenderDelay(), 0);
+    }
+
+    void testIsResizing()
+    {
+        QWidget parent;
+        AbstractDiagram temp(&parent);
+        temp.setResizeRenderDelay(50);
+        parent.show();
+        QTRY_VERIFY(!temp.isResizing());
+        temp.resize(100, 100);
+        QVERIFY(temp.isResizing());
+        QTRY_VERIFY(!temp.isResizing());
+    }
+
+    void testInteraction()
+    {
+        AbstractDiagram temp;
+        QVERIFY(!temp.isInteracting());
+        QCOMPARE(temp.renderScale(), 1.);
+        // A single change is not yet an interaction.
+        temp.registerInteraction();
+        QVERIFY(!temp.isInteracting());
+        QCOMPARE(temp.renderScale(), 1.);
+        // Further changes in quick succession are.
+        temp.registerInteraction();
+        QVERIFY(temp.isInteracting());
+        QCOMPARE(temp.renderScale(), diagramInteractionRenderScale);
+        // The interaction ends when no further change occurs.
+        QTRY_VERIFY(!temp.isInteracting());
+        QCOMPARE(temp.renderScale(), 1.);
+    }
 };
 
 } // namespace PerceptualColor
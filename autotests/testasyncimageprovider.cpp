@@ -6,9 +6,12 @@
 #include "asyncimageprovider.h"
 
 #include "asyncimagerendercallback.h"
+#include <atomic>
 #include <qglobal.h>
 #include <qimage.h>
+#include <qlist.h>
 #include <qmetatype.h>
+#include <qnamespace.h>
 #include <qobject.h>
 #include <qtest.h>
 #include <qtestcase.h>
@@ -104,6 +107,33 @@ public:
 };
 Q_DECLARE_METATYPE(MockupParameters)
 
+// Renders an image of the given width and counts the render calls.
+struct CountingParameters {
+public:
+    int imageWidth = 1;
+    [[nodiscard]] bool operator==(const CountingParameters other) const
+    {
+        return (imageWidth == other.imageWidth);
+    }
+    static void render( //
+        const QVariant &variantParameters, //
+        PerceptualColor::AsyncImageRenderCallback &callbackObject)
+    {
+        ++renderCount;
+        const auto parameters = variantParameters.value<CountingParameters>();
+        QImage image(parameters.imageWidth, 1, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        callbackObject.deliverInterlacingPass( //
+            image,
+            variantParameters,
+            PerceptualColor::AsyncImageRenderCallback::InterlacingState::Final);
+    }
+    static std::atomic<int> renderCount;
+};
+std::atomic<int> CountingParameters::renderCount{0};
+
+Q_DECLARE_METATYPE(CountingParameters)
+
 namespace PerceptualColor
 {
 class TestAsyncImageProvider : public QObject
@@ -207,7 +237,10 @@ private Q_SLOTS:
     void testOnExampleImplementationNoCrashProcessInterlacingPassResult()
     {
         AsyncImageProvider<MockupParameters> image;
-        image.processInterlacingPassResult(QImage{});
+        image.processInterlacingPassResult( //
+            QImage{},
+            QVariant(),
+            AsyncImageRenderCallback::InterlacingState::Final);
     }
 
     void testImageParameters()
@@ -235,6 +268,157 @@ private Q_SLOTS:
         Q_UNUSED(test.getCache())
     }
 
+    void testHistoryCacheDisabledByDefault()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        QCOMPARE(test.historyCacheLimitInBytes(), static_cast<qsizetype>(0));
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 10);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(0));
+        QCOMPARE(test.historyCacheHitCount(), static_cast<qint64>(0));
+        QCOMPARE(test.historyCacheMissCount(), static_cast<qint64>(0));
+    }
+
+    void testHistoryCache()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        test.setHistoryCacheLimitInBytes(1000000);
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 10);
+        parameters.imageWidth = 20;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 20);
+        QCOMPARE(test.historyCacheMissCount(), static_cast<qint64>(2));
+        QCOMPARE(test.historyCacheHitCount(), static_cast<qint64>(0));
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>((10 + 20) * 4));
+
+        // Going back is served synchronously without rendering.
+        const int renderCount = CountingParameters::renderCount.load();
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshAsync();
+        QCOMPARE(test.getCache().width(), 10);
+        QCOMPARE(test.historyCacheHitCount(), static_cast<qint64>(1));
+        QCOMPARE(test.historyCacheMissCount(), static_cast<qint64>(2));
+        test.refreshSync();
+        QCOMPARE(CountingParameters::renderCount.load(), renderCount);
+    }
+
+    void testHistoryCacheLimit()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        // Enough memory for only one image of 10 pixels
+        test.setHistoryCacheLimitInBytes(10 * 4);
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 10);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(10 * 4));
+        // Too big for the history cache
+        parameters.imageWidth = 11;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 11);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(10 * 4));
+        // Replaces the least recently used image
+        parameters.imageWidth = 5;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 5);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(5 * 4));
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshAsync();
+        QCOMPARE(test.historyCacheHitCount(), static_cast<qint64>(0));
+        QTRY_COMPARE(test.getCache().width(), 10);
+        // Reducing the limit frees memory.
+        test.setHistoryCacheLimitInBytes(0);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(0));
+    }
+
+    void testPrefetch()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        test.setHistoryCacheLimitInBytes(1000000);
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 10);
+        CountingParameters first;
+        first.imageWidth = 11;
+        CountingParameters second;
+        second.imageWidth = 12;
+        test.prefetchAsync({first, second});
+        // Both images are rendered in the background into the history cache.
+        QTRY_COMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>((10 + 11 + 12) * 4));
+        // Prefetching does not count as history cache miss.
+        QCOMPARE(test.historyCacheMissCount(), static_cast<qint64>(1));
+        // Requesting a prefetched image does not render anything.
+        const int renderCount = CountingParameters::renderCount.load();
+        test.setImageParameters(second);
+        test.refreshAsync();
+        QCOMPARE(test.getCache().width(), 12);
+        QCOMPARE(test.historyCacheHitCount(), static_cast<qint64>(1));
+        QCOMPARE(CountingParameters::renderCount.load(), renderCount);
+    }
+
+    void testPrefetchWaitsForRealRequest()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        test.setHistoryCacheLimitInBytes(1000000);
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshAsync();
+        CountingParameters prediction;
+        prediction.imageWidth = 11;
+        test.prefetchAsync({prediction});
+        // The final image of the real request has not yet been processed
+        // (this needs the event loop), so no prefetch is running.
+        QVERIFY(!test.m_prefetchRenderingParameters.has_value());
+        QVERIFY(test.m_prefetchQueue == QList<CountingParameters>{prediction});
+        // Once the real request is done, the prefetch starts.
+        QTRY_COMPARE(test.getCache().width(), 10);
+        QTRY_COMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>((10 + 11) * 4));
+    }
+
+    void testPrefetchWithoutHistoryCache()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        CountingParameters parameters;
+        parameters.imageWidth = 11;
+        const int renderCount = CountingParameters::renderCount.load();
+        test.prefetchAsync({parameters});
+        QTest::qWait(100);
+        QCOMPARE(CountingParameters::renderCount.load(), renderCount);
+        QCOMPARE(test.historyCacheSizeInBytes(), static_cast<qsizetype>(0));
+    }
+
+    void testPrefetchSkipsCachedImages()
+    {
+        AsyncImageProvider<CountingParameters> test;
+        test.setHistoryCacheLimitInBytes(1000000);
+        CountingParameters parameters;
+        parameters.imageWidth = 10;
+        test.setImageParameters(parameters);
+        test.refreshSync();
+        QTRY_COMPARE(test.getCache().width(), 10);
+        const int renderCount = CountingParameters::renderCount.load();
+        // The image is yet in the history cache.
+        test.prefetchAsync({parameters});
+        QTest::qWait(100);
+        QCOMPARE(CountingParameters::renderCount.load(), renderCount);
+    }
+
 #endif
 };
 
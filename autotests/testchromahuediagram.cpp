@@ -8,6 +8,7 @@
 #include "chromahuediagram_p.h" // IWYU pragma: keep
 
 #include "constpropagatinguniquepointer.h"
+#include "helperconstants.h"
 #include "lchdouble.h"
 #include "polarpointf.h"
 #include "rgbcolorspacefactory.h"
@@ -24,6 +25,7 @@
 #include <qsize.h>
 #include <qtest.h>
 #include <qtestcase.h>
+#include <qwidget.h>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -267,6 +269,63 @@ private Q_SLOTS:
                  QPoint(testPosition, testPosition) + QPointF(0.5, 0.5));
     }
 
+    void testResizeRenderCount()
+    {
+        // A child widget gets its resize events immediately.
+        QWidget parent;
+        ChromaHueDiagram myDiagram{m_rgbColorSpace, &parent};
+        myDiagram.setResizeRenderDelay(50);
+        myDiagram.resize(200, 200);
+        parent.show();
+        const auto &image = myDiagram.d_pointer->m_chromaHueImage;
+        QTRY_VERIFY(!image.getCache().isNull());
+        QTRY_VERIFY(!myDiagram.isResizing());
+        QTest::qWait(100);
+        const qint64 renderCount = image.renderCount();
+
+        // An interactive resize does not render the intermediate sizes,
+        // but paints the existing image scaled.
+        for (int i = 1; i <= 20; ++i) {
+            myDiagram.resize(200 + 5 * i, 200 + 5 * i);
+            myDiagram.repaint();
+        }
+        QCOMPARE(image.renderCount(), renderCount);
+
+        // Once the size is stable, exactly one rendering takes place.
+        QTRY_COMPARE(image.renderCount(), renderCount + 1);
+        QTest::qWait(200);
+        QCOMPARE(image.renderCount(), renderCount + 1);
+        QCOMPARE(image.imageParameters().imageSizePhysical, //
+                 myDiagram.maximumPhysicalSquareSize());
+    }
+
+    void testInteractionRenderScale()
+    {
+        QWidget parent;
+        ChromaHueDiagram myDiagram{m_rgbColorSpace, &parent};
+        myDiagram.resize(200, 200);
+        parent.show();
+        QTRY_VERIFY(!myDiagram.isResizing());
+        const auto &image = myDiagram.d_pointer->m_chromaHueImage;
+        const int fullSize = myDiagram.maximumPhysicalSquareSize();
+
+        // Quick changes of the lightness (like a moving slider) are
+        // rendered at reduced resolution.
+        LchDouble color = myDiagram.currentColor();
+        for (int i = 0; i < 5; ++i) {
+            color.l = 40 + i;
+            myDiagram.setCurrentColor(color);
+            myDiagram.repaint();
+        }
+        QVERIFY(myDiagram.isInteracting());
+        QCOMPARE(image.imageParameters().imageSizePhysical, //
+                 qRound(fullSize * diagramInteractionRenderScale));
+
+        // Once the interaction has ended, the full resolution is rendered.
+        QTRY_COMPARE(image.imageParameters().imageSizePhysical, fullSize);
+        QTRY_COMPARE(image.getCache().width(), fullSize);
+    }
+
     void testVerySmallWidgetSizes()
     {
         // Also very small widget sizes should not crash the widget.
@@ -6,19 +6,24 @@
 #include "chromahueimageparameters.h"
 
 #include "asyncimagerendercallback.h"
+#include "cielchd50values.h"
 #include "helpermath.h"
 #include "lchdouble.h"
 #include "rgbcolorspacefactory.h"
+#include <lcms2.h>
 #include <qbenchmark.h>
 #include <qcolor.h>
+#include <qdebug.h>
 #include <qglobal.h>
 #include <qimage.h>
 #include <qobject.h>
+#include <qrgb.h>
 #include <qsharedpointer.h>
 #include <qsize.h>
 #include <qtest.h>
 #include <qtestcase.h>
 #include <qtestdata.h>
+#include <qthreadpool.h>
 #include <qvariant.h>
 #include <rgbcolorspace.h>
 
@@ -29,6 +34,8 @@
 #include <qstring.h>
 #endif
 
+Q_DECLARE_METATYPE(PerceptualColor::ChromaHueImageParameters::Algorithm)
+
 namespace PerceptualColor
 {
 class Mockup : public AsyncImageRenderCallback
@@ -490,6 +497,153 @@ private Q_SLOTS:
         }
     }
 
+    void testFinalImageMatchesSingleConversion()
+    {
+        // The renderer converts whole lines at once. The result must be
+        // identical to the conversion of each single pixel.
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        Mockup myMockup;
+        constexpr int size = 51; // an odd number
+        constexpr int border = 5;
+        testProperties.algorithm = ChromaHueImageParameters::Algorithm::Exhaustive;
+        // Without anti-aliasing, each pixel has exactly the color of
+        // its middle.
+        testProperties.antialiasing = false;
+        testProperties.borderPhysical = border;
+        testProperties.lightness = 60;
+        testProperties.imageSizePhysical = size;
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        const QImage image = myMockup.lastDeliveredImage();
+        QCOMPARE(image.size(), QSize(size, size));
+        const QRgb neutralGray = testProperties //
+                                     .rgbColorSpace //
+                                     ->fromCielchD50ToQRgbBound(CielchD50Values::neutralGray);
+        const auto chromaRange = //
+            testProperties.rgbColorSpace->profileMaximumCielchD50Chroma();
+        const qreal scaleFactor = 2 * chromaRange / (size - 2 * border);
+        const qreal circleRadius = (size - 2 * border) / 2.;
+        cmsCIELab cielabD50;
+        cielabD50.L = testProperties.lightness;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const qreal dx = x + 0.5 - size / 2.;
+                const qreal dy = y + 0.5 - size / 2.;
+                if (dx * dx + dy * dy >= (circleRadius - 1) * (circleRadius - 1)) {
+                    // Pixels near to the border of the circle depend
+                    // on the overlap and are not tested here.
+                    continue;
+                }
+                cielabD50.a = (x + 0.5 - border) * scaleFactor - chromaRange;
+                cielabD50.b = chromaRange - (y + 0.5 - border) * scaleFactor;
+                QRgb expected = testProperties //
+                                    .rgbColorSpace //
+                                    ->fromCielabD50ToQRgbOrTransparent(cielabD50);
+                if (qAlpha(expected) == 0) {
+                    expected = neutralGray;
+                }
+                QCOMPARE(image.pixel(x, y), expected);
+            }
+        }
+    }
+
+    void testAntialiasing()
+    {
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        testProperties.borderPhysical = 4;
+        testProperties.lightness = 60;
+        testProperties.imageSizePhysical = 151;
+        Mockup aliasedMockup;
+        testProperties.antialiasing = false;
+        testProperties.render(QVariant::fromValue(testProperties), aliasedMockup);
+        Mockup antialiasedMockup;
+        testProperties.antialiasing = true;
+        testProperties.render(QVariant::fromValue(testProperties), antialiasedMockup);
+        const QImage aliasedImage = aliasedMockup.lastDeliveredImage();
+        const QImage antialiasedImage = antialiasedMockup.lastDeliveredImage();
+        QCOMPARE(antialiasedImage.size(), aliasedImage.size());
+
+        // Only a small part of the image changes, and the image stays
+        // opaque.
+        int changedPixels = 0;
+        for (int y = 0; y < aliasedImage.height(); ++y) {
+            for (int x = 0; x < aliasedImage.width(); ++x) {
+                QCOMPARE(qAlpha(antialiasedImage.pixel(x, y)), 255);
+                if (antialiasedImage.pixel(x, y) != aliasedImage.pixel(x, y)) {
+                    ++changedPixels;
+                }
+            }
+        }
+        QVERIFY(changedPixels > 0);
+        QVERIFY(changedPixels < aliasedImage.width() * aliasedImage.height() / 10);
+    }
+
+    void testThreadCountDoesNotChangeImage()
+    {
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        Mockup myMockup;
+        testProperties.borderPhysical = 3;
+        testProperties.lightness = 70;
+        testProperties.imageSizePhysical = 201;
+        testProperties.threadCount = 1;
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        const QImage singleThreadImage = myMockup.lastDeliveredImage();
+        testProperties.threadCount = 8;
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        QCOMPARE(myMockup.lastDeliveredImage(), singleThreadImage);
+    }
+
+    void testThreadCountIsIgnoredByEqualOperator()
+    {
+        ChromaHueImageParameters first;
+        ChromaHueImageParameters second;
+        second.threadCount = 4;
+        QVERIFY(first == second);
+    }
+
+    void testPolarBoundary_data()
+    {
+        QTest::addColumn<qreal>("lightness");
+        QTest::newRow("3") << 3.;
+        QTest::newRow("30") << 30.;
+        QTest::newRow("50") << 50.;
+        QTest::newRow("70") << 70.;
+        QTest::newRow("97") << 97.;
+    }
+
+    void testPolarBoundary()
+    {
+        // The polar boundary must give the same result as the exact gamut
+        // test of each pixel. Some pixels might differ because of rounding
+        // errors within the tolerance of the gamut test.
+        QFETCH(qreal, lightness);
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        testProperties.borderPhysical = 4;
+        testProperties.lightness = lightness;
+        testProperties.imageSizePhysical = 301;
+        Mockup exhaustiveMockup;
+        testProperties.algorithm = ChromaHueImageParameters::Algorithm::Exhaustive;
+        testProperties.render(QVariant::fromValue(testProperties), exhaustiveMockup);
+        Mockup polarBoundaryMockup;
+        testProperties.algorithm = ChromaHueImageParameters::Algorithm::PolarBoundary;
+        testProperties.render(QVariant::fromValue(testProperties), polarBoundaryMockup);
+        const QImage exhaustiveImage = exhaustiveMockup.lastDeliveredImage();
+        const QImage polarBoundaryImage = polarBoundaryMockup.lastDeliveredImage();
+        QCOMPARE(polarBoundaryImage.size(), exhaustiveImage.size());
+        int differentPixels = 0;
+        for (int y = 0; y < exhaustiveImage.height(); ++y) {
+            for (int x = 0; x < exhaustiveImage.width(); ++x) {
+                if (polarBoundaryImage.pixel(x, y) != exhaustiveImage.pixel(x, y)) {
+                    ++differentPixels;
+                }
+            }
+        }
+        QVERIFY(differentPixels <= exhaustiveImage.width() * exhaustiveImage.height() / 1000);
+    }
+
     void benchmarkGetImage()
     {
         ChromaHueImageParameters testProperties;
@@ -508,6 +662,107 @@ private Q_SLOTS:
                                   myMockup);
         }
     }
+
+    void benchmarkGetImageAlgorithm_data()
+    {
+        QTest::addColumn<ChromaHueImageParameters::Algorithm>("algorithm");
+        QTest::addColumn<qreal>("lightness");
+        QTest::newRow("Exhaustive 10") //
+            << ChromaHueImageParameters::Algorithm::Exhaustive << 10.;
+        QTest::newRow("PolarBoundary 10") //
+            << ChromaHueImageParameters::Algorithm::PolarBoundary << 10.;
+        QTest::newRow("Exhaustive 50") //
+            << ChromaHueImageParameters::Algorithm::Exhaustive << 50.;
+        QTest::newRow("PolarBoundary 50") //
+            << ChromaHueImageParameters::Algorithm::PolarBoundary << 50.;
+        QTest::newRow("Exhaustive 90") //
+            << ChromaHueImageParameters::Algorithm::Exhaustive << 90.;
+        QTest::newRow("PolarBoundary 90") //
+            << ChromaHueImageParameters::Algorithm::PolarBoundary << 90.;
+    }
+
+    void benchmarkGetImageAlgorithm()
+    {
+        QFETCH(ChromaHueImageParameters::Algorithm, algorithm);
+        QFETCH(qreal, lightness);
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        Mockup myMockup;
+        testProperties.algorithm = algorithm;
+        testProperties.borderPhysical = 0;
+        testProperties.imageSizePhysical = 1000; // an even number
+        testProperties.lightness = lightness;
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        QBENCHMARK {
+            testProperties.lightness = lightness + 1;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+            testProperties.lightness = lightness;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+        }
+    }
+
+    void benchmarkGetImageThreadCount_data()
+    {
+        QTest::addColumn<int>("threadCount");
+        QTest::newRow("1") << 1;
+        QTest::newRow("2") << 2;
+        QTest::newRow("4") << 4;
+        QTest::newRow("8") << 8;
+    }
+
+    void benchmarkGetImageThreadCount()
+    {
+        // Scaling of the parallel rendering: Compare the results of the
+        // rows. Thread counts beyond QThreadPool::globalInstance()’s
+        // maximum cannot scale further.
+        QFETCH(int, threadCount);
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        Mockup myMockup;
+        testProperties.borderPhysical = 0;
+        testProperties.lightness = 50;
+        testProperties.imageSizePhysical = 1000; // an even number
+        testProperties.threadCount = threadCount;
+        // Report the threads that are actually available, which is
+        // necessary to interpret the results of the rows.
+        qInfo().noquote().nospace() //
+            << QTest::currentDataTag() //
+            << ": available pool threads: " //
+            << QThreadPool::globalInstance()->maxThreadCount();
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        QBENCHMARK {
+            testProperties.lightness = 51;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+            testProperties.lightness = 50;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+        }
+    }
+
+    void benchmarkGetImageWithBorder()
+    {
+        // A typical size for a widget on a high-DPI screen, with an odd
+        // size and a border, so that partial rectangles are written at the
+        // right and the bottom of the image.
+        ChromaHueImageParameters testProperties;
+        testProperties.rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+        Mockup myMockup;
+        testProperties.borderPhysical = 20;
+        testProperties.lightness = 50;
+        testProperties.imageSizePhysical = 601; // an odd number
+        testProperties.render(QVariant::fromValue(testProperties), myMockup);
+        QBENCHMARK {
+            testProperties.lightness = 51;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+            testProperties.lightness = 50;
+            testProperties.render(QVariant::fromValue(testProperties), //
+                                  myMockup);
+        }
+    }
 };
 
 } // namespace PerceptualColor
@@ -6,29 +6,64 @@
 #include "chromalightnessimageparameters.h"
 
 #include "asyncimageprovider.h"
+#include "asyncimagerendercallback.h"
+#include "gamutboundaryantialiasing.h"
 #include "helper.h"
+#include "rgbcolorspace.h"
 #include "rgbcolorspacefactory.h"
+#include <cmath>
+#include <cstddef>
+#include <lcms2.h>
 #include <qcolor.h>
+#include <qdebug.h>
 #include <qglobal.h>
 #include <qimage.h>
+#include <qlist.h>
+#include <qmath.h>
 #include <qobject.h>
+#include <qrgb.h>
 #include <qsharedpointer.h>
 #include <qsize.h>
+#include <qstring.h>
 #include <qtest.h>
 #include <qtestcase.h>
 #include <qtestdata.h>
+#include <qvariant.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
 #else
 #include <qobjectdefs.h>
-#include <qstring.h>
 #endif
 
+Q_DECLARE_METATYPE(PerceptualColor::ChromaLightnessImageParameters::Algorithm)
+
 namespace PerceptualColor
 {
 class RgbColorSpace;
 
+class Mockup : public AsyncImageRenderCallback
+{
+public:
+    virtual bool shouldAbort() const override;
+    virtual void deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state) override;
+    QList<QImage> deliveredImages;
+    QList<InterlacingState> deliveredStates;
+};
+
+bool Mockup::shouldAbort() const
+{
+    return false;
+}
+
+void Mockup::deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state)
+{
+    Q_UNUSED(parameters)
+    deliveredImages.append(image);
+    deliveredStates.append(state);
+}
+
 class TestChromaLightnessImageParameters : public QObject
 {
     Q_OBJECT
@@ -175,6 +210,51 @@ private Q_SLOTS:
         QCOMPARE(m_image.pixelColor(0, 101).isValid(), false);
     }
 
+    void testInterlacing()
+    {
+        ChromaLightnessImageParameters myImageParameters;
+        myImageParameters.rgbColorSpace = m_rgbColorSpace;
+        myImageParameters.hue = 150;
+        myImageParameters.imageSizePhysical = QSize(101, 77);
+        // Without anti-aliasing, each pixel has exactly the color of
+        // its middle.
+        myImageParameters.antialiasing = false;
+        Mockup myMockup;
+        ChromaLightnessImageParameters::render( //
+            QVariant::fromValue(myImageParameters),
+            myMockup);
+
+        // Various passes are delivered, and only the last one is final.
+        QVERIFY(myMockup.deliveredStates.count() > 1);
+        QCOMPARE(myMockup.deliveredStates.last(), //
+                 AsyncImageRenderCallback::InterlacingState::Final);
+        for (int i = 0; i < myMockup.deliveredStates.count() - 1; ++i) {
+            QCOMPARE(myMockup.deliveredStates.at(i), //
+                     AsyncImageRenderCallback::InterlacingState::Intermediate);
+        }
+
+        // Already the first pass covers the whole image.
+        const QImage firstImage = myMockup.deliveredImages.first();
+        QCOMPARE(firstImage.size(), myImageParameters.imageSizePhysical);
+        QCOMPARE(firstImage.pixel(100, 76), firstImage.pixel(96, 64));
+
+        // The final image has the exact color of each pixel.
+        const QImage finalImage = myMockup.deliveredImages.last();
+        const auto height = myImageParameters.imageSizePhysical.height();
+        const double hueRadian = qDegreesToRadians(myImageParameters.hue);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < myImageParameters.imageSizePhysical.width(); ++x) {
+                const double lightness = 100 - (y + 0.5) * 100.0 / height;
+                const double chroma = (x + 0.5) * 100.0 / height;
+                const cmsCIELab cielabD50{lightness, //
+                                          chroma * std::cos(hueRadian),
+                                          chroma * std::sin(hueRadian)};
+                QCOMPARE(finalImage.pixel(x, y), //
+                         m_rgbColorSpace->fromCielabD50ToQRgbOrTransparent(cielabD50));
+            }
+        }
+    }
+
     void testSetHue_data()
     {
         QTest::addColumn<qreal>("hue");
@@ -256,6 +336,201 @@ private Q_SLOTS:
         Q_UNUSED(m_imageProvider.getCache())
     }
 
+    void testBoundaryTracing_data()
+    {
+        QTest::addColumn<qreal>("hue");
+        for (int hue = 0; hue < 360; hue += 30) {
+            QTest::newRow(QString::number(hue).toUtf8().constData()) << static_cast<qreal>(hue);
+        }
+    }
+
+    void testBoundaryTracing()
+    {
+        // The boundary tracing must give the same result as the exact
+        // gamut test of each pixel. Some pixels might differ because of
+        // rounding errors within the tolerance of the gamut test.
+        QFETCH(qreal, hue);
+        ChromaLightnessImageParameters myImageParameters;
+        myImageParameters.rgbColorSpace = m_rgbColorSpace;
+        myImageParameters.hue = hue;
+        myImageParameters.imageSizePhysical = QSize(301, 200);
+        Mockup exhaustiveMockup;
+        myImageParameters.algorithm = //
+            ChromaLightnessImageParameters::Algorithm::Exhaustive;
+        ChromaLightnessImageParameters::render( //
+            QVariant::fromValue(myImageParameters),
+            exhaustiveMockup);
+        Mockup boundaryTracingMockup;
+        myImageParameters.algorithm = //
+            ChromaLightnessImageParameters::Algorithm::BoundaryTracing;
+        ChromaLightnessImageParameters::render( //
+            QVariant::fromValue(myImageParameters),
+            boundaryTracingMockup);
+        const QImage exhaustiveImage = exhaustiveMockup.deliveredImages.last();
+        const QImage boundaryTracingImage = //
+            boundaryTracingMockup.deliveredImages.last();
+        QCOMPARE(boundaryTracingImage.size(), exhaustiveImage.size());
+        int differentPixels = 0;
+        for (int y = 0; y < exhaustiveImage.height(); ++y) {
+            for (int x = 0; x < exhaustiveImage.width(); ++x) {
+                if (boundaryTracingImage.pixel(x, y) != exhaustiveImage.pixel(x, y)) {
+                    ++differentPixels;
+                }
+            }
+        }
+        QVERIFY(differentPixels <= exhaustiveImage.width() * exhaustiveImage.height() / 1000);
+    }
+
+    void testConvertLineFallback()
+    {
+        // An in-gamut region that is not a single interval beginning at
+        // the gray axis: In-gamut gray, then out-of-gamut colors with
+        // high chroma, then again in-gamut gray.
+        std::vector<cmsCIELab> lab(200, cmsCIELab{50, 0, 0});
+        for (std::size_t i = 50; i < 100; ++i) {
+            lab[i] = cmsCIELab{50, 150, 150};
+        }
+        std::vector<QRgb> result(lab.size());
+        ChromaLightnessImageParameters::TransformStatistics statistics;
+        ChromaLightnessImageParameters::convertLine( //
+            *m_rgbColorSpace,
+            lab.data(),
+            result.data(),
+            static_cast<qsizetype>(lab.size()),
+            ChromaLightnessImageParameters::Algorithm::BoundaryTracing,
+            &statistics);
+        for (std::size_t i = 0; i < lab.size(); ++i) {
+            QCOMPARE(result[i], m_rgbColorSpace->fromCielabD50ToQRgbOrTransparent(lab[i]));
+        }
+        // The verification has detected the non-convex gamut and all
+        // colors have been tested exactly.
+        QVERIFY(statistics.roundtrip >= static_cast<qint64>(lab.size()));
+    }
+
+    void testAntialiasing()
+    {
+        ChromaLightnessImageParameters myImageParameters;
+        myImageParameters.rgbColorSpace = m_rgbColorSpace;
+        myImageParameters.hue = 150;
+        myImageParameters.imageSizePhysical = QSize(201, 150);
+        myImageParameters.antialiasing = false;
+        Mockup aliasedMockup;
+        ChromaLightnessImageParameters::render( //
+            QVariant::fromValue(myImageParameters),
+            aliasedMockup);
+        myImageParameters.antialiasing = true;
+        Mockup antialiasedMockup;
+        ChromaLightnessImageParameters::TransformStatistics statistics;
+        ChromaLightnessImageParameters::renderWithStatistics( //
+            QVariant::fromValue(myImageParameters),
+            antialiasedMockup,
+            &statistics);
+        const QImage aliasedImage = aliasedMockup.deliveredImages.last();
+        const QImage antialiasedImage = antialiasedMockup.deliveredImages.last();
+        QCOMPARE(antialiasedImage.size(), aliasedImage.size());
+
+        // Only some pixels at the boundary are supersampled.
+        const auto pixelCount = static_cast<qint64>(aliasedImage.width()) //
+            * aliasedImage.height();
+        QVERIFY(statistics.antialiasing.edgePixels > 0);
+        QVERIFY(statistics.antialiasing.edgePixels < pixelCount / 10);
+        QCOMPARE(statistics.antialiasing.subsamples,
+                 statistics.antialiasing.edgePixels //
+                     * GamutBoundaryAntialiasing::subsamplesPerAxis //
+                     * GamutBoundaryAntialiasing::subsamplesPerAxis);
+
+        // The gamut membership of each pixel does not change, and some
+        // in-gamut pixels get a partial alpha.
+        int partialPixels = 0;
+        for (int y = 0; y < aliasedImage.height(); ++y) {
+            for (int x = 0; x < aliasedImage.width(); ++x) {
+                const int aliasedAlpha = qAlpha(aliasedImage.pixel(x, y));
+                const int antialiasedAlpha = qAlpha(antialiasedImage.pixel(x, y));
+                QCOMPARE(antialiasedAlpha != 0, aliasedAlpha != 0);
+                if ((antialiasedAlpha != 0) && (antialiasedAlpha != 255)) {
+                    ++partialPixels;
+                }
+            }
+        }
+        QVERIFY(partialPixels > 0);
+        QVERIFY(partialPixels <= statistics.antialiasing.edgePixels);
+    }
+
+    void benchmarkRender_data()
+    {
+        QTest::addColumn<ChromaLightnessImageParameters::Algorithm>("algorithm");
+        QTest::newRow("Exhaustive") << ChromaLightnessImageParameters::Algorithm::Exhaustive;
+        QTest::newRow("BoundaryTracing") << ChromaLightnessImageParameters::Algorithm::BoundaryTracing;
+    }
+
+    void benchmarkRender()
+    {
+        QFETCH(ChromaLightnessImageParameters::Algorithm, algorithm);
+        ChromaLightnessImageParameters myImageParameters;
+        myImageParameters.rgbColorSpace = m_rgbColorSpace;
+        myImageParameters.imageSizePhysical = QSize(1000, 500);
+        myImageParameters.algorithm = algorithm;
+
+        // Report the number of transformed colors for the final
+        // resolution.
+        ChromaLightnessImageParameters::TransformStatistics statistics;
+        const auto width = myImageParameters.imageSizePhysical.width();
+        const auto height = myImageParameters.imageSizePhysical.height();
+        std::vector<cmsCIELab> lab(static_cast<std::size_t>(width));
+        std::vector<QRgb> result(lab.size());
+        for (int hue = 0; hue < 360; hue += 30) {
+            const double hueRadian = qDegreesToRadians(static_cast<double>(hue));
+            for (int y = 0; y < height; ++y) {
+                const double lightness = 100 - (y + 0.5) * 100.0 / height;
+                for (int x = 0; x < width; ++x) {
+                    const double chroma = (x + 0.5) * 100.0 / height;
+                    lab[static_cast<std::size_t>(x)] = cmsCIELab{lightness, //
+                                                                 chroma * std::cos(hueRadian),
+                                                                 chroma * std::sin(hueRadian)};
+                }
+                ChromaLightnessImageParameters::convertLine( //
+                    *m_rgbColorSpace,
+                    lab.data(),
+                    result.data(),
+                    width,
+                    algorithm,
+                    &statistics);
+            }
+        }
+        qInfo().noquote().nospace() //
+            << QTest::currentDataTag() //
+            << ": forward transforms: " << statistics.forward //
+            << ", round-trip transforms: " << statistics.roundtrip //
+            << ", LittleCMS transform calls per color: " //
+            << static_cast<double>(statistics.forward + 2 * statistics.roundtrip) //
+                / static_cast<double>(12 * width * height);
+
+        // Report the extra work of the anti-aliasing.
+        ChromaLightnessImageParameters::TransformStatistics renderStatistics;
+        Mockup statisticsMockup;
+        myImageParameters.hue = 150;
+        ChromaLightnessImageParameters::renderWithStatistics( //
+            QVariant::fromValue(myImageParameters),
+            statisticsMockup,
+            &renderStatistics);
+        qInfo().noquote().nospace() //
+            << QTest::currentDataTag() //
+            << ": anti-aliased pixels: " << renderStatistics.antialiasing.edgePixels //
+            << ", anti-aliasing subsamples: " << renderStatistics.antialiasing.subsamples;
+
+        Mockup myMockup;
+        QBENCHMARK {
+            myImageParameters.hue = 150;
+            ChromaLightnessImageParameters::render( //
+                QVariant::fromValue(myImageParameters),
+                myMockup);
+            myImageParameters.hue = 151;
+            ChromaLightnessImageParameters::render( //
+                QVariant::fromValue(myImageParameters),
+                myMockup);
+        }
+    }
+
 #endif
 };
 
@@ -0,0 +1,162 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "colorbuffer.h"
+
+#include <cstdint>
+#include <qglobal.h>
+#include <qobject.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <type_traits>
+#include <utility>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+namespace PerceptualColor
+{
+class TestColorBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestColorBuffer(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    [[nodiscard]] static bool isAligned(const double *pointer)
+    {
+        return (reinterpret_cast<std::uintptr_t>(pointer) % 64) == 0;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testConstructor()
+    {
+        const LabBuffer lab(10);
+        QCOMPARE(lab.size(), 10);
+        const LchBuffer lch(0);
+        QCOMPARE(lch.size(), 0);
+        const RgbBuffer rgb;
+        QCOMPARE(rgb.size(), 0);
+        const RgbBuffer negative(-5);
+        QCOMPARE(negative.size(), 0);
+    }
+
+    void testZeroInitialized()
+    {
+        const LabBuffer buffer(17);
+        for (qsizetype i = 0; i < buffer.size(); ++i) {
+            QCOMPARE(buffer.l()[i], 0.);
+            QCOMPARE(buffer.a()[i], 0.);
+            QCOMPARE(buffer.b()[i], 0.);
+        }
+    }
+
+    void testAlignment_data()
+    {
+        QTest::addColumn<int>("size");
+        QTest::newRow("1") << 1;
+        QTest::newRow("7") << 7;
+        QTest::newRow("8") << 8;
+        QTest::newRow("9") << 9;
+        QTest::newRow("1000") << 1000;
+    }
+
+    void testAlignment()
+    {
+        QFETCH(int, size);
+        RgbBuffer buffer(size);
+        QVERIFY(isAligned(buffer.red()));
+        QVERIFY(isAligned(buffer.green()));
+        QVERIFY(isAligned(buffer.blue()));
+        buffer.resize(size + 3);
+        QVERIFY(isAligned(buffer.red()));
+        QVERIFY(isAligned(buffer.green()));
+        QVERIFY(isAligned(buffer.blue()));
+    }
+
+    void testChannelsDoNotOverlap()
+    {
+        LchBuffer buffer(9);
+        for (qsizetype i = 0; i < buffer.size(); ++i) {
+            buffer.l()[i] = 1;
+            buffer.c()[i] = 2;
+            buffer.h()[i] = 3;
+        }
+        for (qsizetype i = 0; i < buffer.size(); ++i) {
+            QCOMPARE(buffer.l()[i], 1.);
+            QCOMPARE(buffer.c()[i], 2.);
+            QCOMPARE(buffer.h()[i], 3.);
+        }
+    }
+
+    void testResize()
+    {
+        LabBuffer buffer(3);
+        buffer.resize(100);
+        QCOMPARE(buffer.size(), 100);
+        // All values must be writable.
+        for (qsizetype i = 0; i < buffer.size(); ++i) {
+            buffer.l()[i] = 1;
+            buffer.a()[i] = 2;
+            buffer.b()[i] = 3;
+        }
+        buffer.resize(0);
+        QCOMPARE(buffer.size(), 0);
+    }
+
+    void testCopyAndMove()
+    {
+        LabBuffer original(5);
+        original.a()[4] = 42;
+        LabBuffer copy = original;
+        QCOMPARE(copy.size(), 5);
+        QCOMPARE(copy.a()[4], 42.);
+        // Deep copy
+        copy.a()[4] = 0;
+        QCOMPARE(original.a()[4], 42.);
+        LabBuffer moved = std::move(original);
+        QCOMPARE(moved.size(), 5);
+        QCOMPARE(moved.a()[4], 42.);
+    }
+
+    void testTypes()
+    {
+        static_assert(!std::is_convertible_v<LabBuffer, LchBuffer>);
+        static_assert(!std::is_convertible_v<LchBuffer, LabBuffer>);
+        static_assert(std::is_nothrow_move_constructible_v<RgbBuffer>);
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestColorBuffer)
+// The following “include” is necessary because we do not use a header file:
+#include "testcolorbuffer.moc"
@@ -0,0 +1,272 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "colordifference.h"
+
+#include "colorkernels.h"
+#include "helpermath.h"
+#include "instructionset.h"
+#include <cmath>
+#include <lcms2.h>
+#include <qglobal.h>
+#include <qobject.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtestdata.h>
+#include <vector>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qstring.h>
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+Q_DECLARE_METATYPE(cmsCIELab)
+
+namespace PerceptualColor
+{
+class TestColorDifference : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestColorDifference(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    // Test data from Gaurav Sharma, Wencheng Wu, Edul N. Dalal: “The
+    // CIEDE2000 Color-Difference Formula: Implementation Notes,
+    // Supplementary Test Data, and Mathematical Observations”, Table 1.
+    // The expected color differences are rounded to 4 decimal places.
+    struct SharmaPair {
+        cmsCIELab first;
+        cmsCIELab second;
+        double deltaE;
+    };
+
+    static std::vector<SharmaPair> sharmaData()
+    {
+        // clang-format off
+        return std::vector<SharmaPair>{
+            {{50.0000, 2.6772, -79.7751}, {50.0000, 0.0000, -82.7485}, 2.0425},
+            {{50.0000, 3.1571, -77.2803}, {50.0000, 0.0000, -82.7485}, 2.8615},
+            {{50.0000, 2.8361, -74.0200}, {50.0000, 0.0000, -82.7485}, 3.4412},
+            {{50.0000, -1.3802, -84.2814}, {50.0000, 0.0000, -82.7485}, 1.0000},
+            {{50.0000, -1.1848, -84.8006}, {50.0000, 0.0000, -82.7485}, 1.0000},
+            {{50.0000, -0.9009, -85.5211}, {50.0000, 0.0000, -82.7485}, 1.0000},
+            {{50.0000, 0.0000, 0.0000}, {50.0000, -1.0000, 2.0000}, 2.3669},
+            {{50.0000, -1.0000, 2.0000}, {50.0000, 0.0000, 0.0000}, 2.3669},
+            {{50.0000, 2.4900, -0.0010}, {50.0000, -2.4900, 0.0009}, 7.1792},
+            {{50.0000, 2.4900, -0.0010}, {50.0000, -2.4900, 0.0010}, 7.1792},
+            {{50.0000, 2.4900, -0.0010}, {50.0000, -2.4900, 0.0011}, 7.2195},
+            {{50.0000, 2.4900, -0.0010}, {50.0000, -2.4900, 0.0012}, 7.2195},
+            {{50.0000, -0.0010, 2.4900}, {50.0000, 0.0009, -2.4900}, 4.8045},
+            {{50.0000, -0.0010, 2.4900}, {50.0000, 0.0010, -2.4900}, 4.8045},
+            {{50.0000, -0.0010, 2.4900}, {50.0000, 0.0011, -2.4900}, 4.7461},
+            {{50.0000, 2.5000, 0.0000}, {50.0000, 0.0000, -2.5000}, 4.3065},
+            {{50.0000, 2.5000, 0.0000}, {73.0000, 25.0000, -18.0000}, 27.1492},
+            {{50.0000, 2.5000, 0.0000}, {61.0000, -5.0000, 29.0000}, 22.8977},
+            {{50.0000, 2.5000, 0.0000}, {56.0000, -27.0000, -3.0000}, 31.9030},
+            {{50.0000, 2.5000, 0.0000}, {58.0000, 24.0000, 15.0000}, 19.4535},
+            {{50.0000, 2.5000, 0.0000}, {50.0000, 3.1736, 0.5854}, 1.0000},
+            {{50.0000, 2.5000, 0.0000}, {50.0000, 3.2972, 0.0000}, 1.0000},
+            {{50.0000, 2.5000, 0.0000}, {50.0000, 1.8634, 0.5757}, 1.0000},
+            {{50.0000, 2.5000, 0.0000}, {50.0000, 3.2592, 0.3350}, 1.0000},
+            {{60.2574, -34.0099, 36.2677}, {60.4626, -34.1751, 39.4387}, 1.2644},
+            {{63.0109, -31.0961, -5.8663}, {62.8187, -29.7946, -4.0864}, 1.2630},
+            {{61.2901, 3.7196, -5.3901}, {61.4292, 2.2480, -4.9620}, 1.8731},
+            {{35.0831, -44.1164, 3.7933}, {35.0232, -40.0716, 1.5901}, 1.8645},
+            {{22.7233, 20.0904, -46.6940}, {23.0331, 14.9730, -42.5619}, 2.0373},
+            {{36.4612, 47.8580, 18.3852}, {36.2715, 50.5065, 21.2231}, 1.4146},
+            {{90.8027, -2.0831, 1.4410}, {91.1528, -1.6435, 0.0447}, 1.4441},
+            {{90.9257, -0.5406, -0.9208}, {88.6381, -0.8985, -0.7239}, 1.5381},
+            {{6.7747, -0.2908, -2.4247}, {5.8714, -0.0985, -2.2286}, 0.6377},
+            {{2.0776, 0.0795, -1.1350}, {0.9033, -0.0636, -0.5514}, 0.9082}};
+        // clang-format on
+    }
+
+    // Tolerance for the comparison with values that are rounded
+    // to 4 decimal places
+    static constexpr double sharmaTolerance = 0.00005;
+
+    // Pairs of colors that cover the CIELab range and go a little bit beyond.
+    static void sampleCielabPairs(std::vector<cmsCIELab> &first, std::vector<cmsCIELab> &second)
+    {
+        for (int l = 0; l <= 100; l += 25) {
+            for (int a = -120; a <= 120; a += 20) {
+                for (int b = -120; b <= 120; b += 20) {
+                    first.push_back(cmsCIELab{static_cast<double>(l), //
+                                              static_cast<double>(a),
+                                              static_cast<double>(b)});
+                    second.push_back(cmsCIELab{100. - l, //
+                                               b / 3.,
+                                               a * 0.7});
+                    // Similar colors
+                    first.push_back(first.back());
+                    second.push_back(cmsCIELab{l + 0.5, a - 1.25, b + 2.});
+                }
+            }
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testDeltaE2000SharmaData_data()
+    {
+        QTest::addColumn<cmsCIELab>("first");
+        QTest::addColumn<cmsCIELab>("second");
+        QTest::addColumn<double>("deltaE");
+        const auto data = sharmaData();
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            QTest::newRow(qPrintable(QString::number(i + 1))) //
+                << data.at(i).first << data.at(i).second << data.at(i).deltaE;
+        }
+    }
+
+    void testDeltaE2000SharmaData()
+    {
+        QFETCH(cmsCIELab, first);
+        QFETCH(cmsCIELab, second);
+        QFETCH(double, deltaE);
+        QVERIFY(std::abs(deltaE2000(first, second) - deltaE) < sharmaTolerance);
+        // CIEDE2000 is symmetric.
+        QVERIFY(std::abs(deltaE2000(second, first) - deltaE) < sharmaTolerance);
+    }
+
+    void testDeltaE2000BatchSharmaData()
+    {
+        const auto data = sharmaData();
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        for (const auto &pair : data) {
+            first.push_back(pair.first);
+            second.push_back(pair.second);
+        }
+        const auto count = static_cast<qsizetype>(data.size());
+        std::vector<double> result(data.size());
+        std::vector<double> swappedResult(data.size());
+        const auto list = availableInstructionSets();
+        for (const auto instructionSet : list) {
+            const auto &kernels = colorKernels(instructionSet);
+            kernels.ciede2000(first.data(), second.data(), result.data(), count);
+            kernels.ciede2000(second.data(), first.data(), swappedResult.data(), count);
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                QVERIFY(std::abs(result.at(i) - data.at(i).deltaE) < sharmaTolerance);
+                QVERIFY(std::abs(swappedResult.at(i) - data.at(i).deltaE) < sharmaTolerance);
+            }
+        }
+        // Also the public batch function
+        deltaE2000(first.data(), second.data(), result.data(), count);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            QVERIFY(std::abs(result.at(i) - data.at(i).deltaE) < sharmaTolerance);
+        }
+    }
+
+    void testDeltaE2000IdenticalColors()
+    {
+        const cmsCIELab colors[] = {{0, 0, 0}, {50, 0, 0}, {50, 20, -30}, {100, 0, 0}};
+        for (const auto &color : colors) {
+            QCOMPARE(deltaE2000(color, color), 0.);
+        }
+    }
+
+    void testDeltaE2000BatchMatchesSingleValue()
+    {
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> result(first.size());
+        deltaE2000(first.data(), second.data(), result.data(), count);
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            const double expected = deltaE2000(first.at(i), second.at(i));
+            QVERIFY(std::abs(result.at(i) - expected) <= deltaE2000BatchMaximumError);
+        }
+    }
+
+    void testDeltaE76()
+    {
+        QCOMPARE(deltaE76(cmsCIELab{50, 0, 0}, cmsCIELab{50, 3, 4}), 5.);
+        QCOMPARE(deltaE76(cmsCIELab{50, 3, 4}, cmsCIELab{50, 0, 0}), 5.);
+        QCOMPARE(deltaE76(cmsCIELab{10, 20, 30}, cmsCIELab{10, 20, 30}), 0.);
+        QCOMPARE(deltaE76(cmsCIELab{0, 0, 0}, cmsCIELab{100, 0, 0}), 100.);
+    }
+
+    void testDeltaE76Batch()
+    {
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> result(first.size());
+        deltaE76(first.data(), second.data(), result.data(), count);
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            QVERIFY(isNearlyEqual(result.at(i), deltaE76(first.at(i), second.at(i)), 1e-12));
+        }
+    }
+
+    void testDeltaEOklab()
+    {
+        QCOMPARE(deltaEOklab(cmsCIELab{0.5, 0, 0}, cmsCIELab{0.5, 0.03, 0.04}), 0.05);
+        const cmsCIELab first[] = {{0.5, 0, 0}, {0.2, 0.1, -0.1}};
+        const cmsCIELab second[] = {{0.5, 0.03, 0.04}, {0.2, 0.1, -0.1}};
+        double result[2];
+        deltaEOklab(first, second, result, 2);
+        QVERIFY(isNearlyEqual(result[0], 0.05, 1e-12));
+        QCOMPARE(result[1], 0.);
+    }
+
+    void benchmarkDeltaE2000SingleValue()
+    {
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        std::vector<double> result(first.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < first.size(); ++i) {
+                result[i] = deltaE2000(first[i], second[i]);
+            }
+        }
+    }
+
+    void benchmarkDeltaE2000Batch()
+    {
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> result(first.size());
+        QBENCHMARK {
+            deltaE2000(first.data(), second.data(), result.data(), count);
+        }
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestColorDifference)
+// The following “include” is necessary because we do not use a header file:
+#include "testcolordifference.moc"
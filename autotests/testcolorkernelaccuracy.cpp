@@ -0,0 +1,714 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "colorkernels.h"
+
+#include "colordifference.h"
+#include "helperconstants.h"
+#include "helperconversion.h"
+#include "helpermath.h"
+#include "instructionset.h"
+#include "lchdouble.h"
+#include "rgbcolorspace.h"
+#include "rgbcolorspace_p.h" // IWYU pragma: keep
+#include "rgbcolorspacefactory.h"
+#include "rgbdouble.h"
+#include <algorithm>
+#include <cmath>
+#include <lcms2.h>
+#include <limits>
+#include <memory>
+#include <qcolor.h>
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+#include <qglobal.h>
+#include <qmath.h>
+#include <qobject.h>
+#include <qrandom.h>
+#include <qrgb.h>
+#include <qsharedpointer.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <vector>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qstring.h>
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+// This is a validation harness rather than a classic unit test: It compares
+// the fast code paths (batch kernels, approximations) with the reference
+// behaviour (LittleCMS, the standard library, the single-value functions).
+// The reference of the gamut decisions is a round-trip that calls LittleCMS
+// directly, value by value. For each fast path, it reports the maximum error, the
+// median and some high percentiles of the error, the disagreement rate of
+// gamut decisions (where applicable) and the run time of both paths. It
+// fails if an error exceeds the documented accuracy contract.
+//
+// The samples are a dense grid plus random points (with a fixed seed,
+// so that the results are reproducible).
+//
+// By default, the harness works with the built-in sRGB color space. To
+// select another color space, set the environment variable
+// PERCEPTUALCOLOR_ACCURACY_PROFILE to the file name of an ICC profile.
+
+namespace PerceptualColor
+{
+class TestColorKernelAccuracy : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestColorKernelAccuracy(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    /** @brief Statistics about the errors of a fast code path. */
+    struct ErrorStatistics {
+        /** @brief Maximum error */
+        double maximum = 0;
+        /** @brief Median of the error */
+        double median = 0;
+        /** @brief 99th percentile of the error */
+        double percentile99 = 0;
+        /** @brief 99.9th percentile of the error */
+        double percentile999 = 0;
+    };
+
+    /** @brief Number of random samples in addition to the grid samples. */
+    static constexpr int randomSampleCount = 50000;
+
+    /** @brief Seed for the random samples. */
+    static constexpr quint32 randomSeed = 20240101;
+
+    QSharedPointer<RgbColorSpace> m_colorSpace;
+
+    /** @brief Calculates the statistics.
+     *
+     * @param errors The errors. Empty lists are allowed.
+     *
+     * @returns The statistics. */
+    [[nodiscard]] static ErrorStatistics statistics(std::vector<double> errors)
+    {
+        ErrorStatistics result;
+        if (errors.empty()) {
+            return result;
+        }
+        std::sort(errors.begin(), errors.end());
+        const auto percentile = [&errors](const double fraction) {
+            const auto index = static_cast<std::size_t>( //
+                fraction * static_cast<double>(errors.size() - 1));
+            return errors.at(index);
+        };
+        result.maximum = errors.back();
+        result.median = percentile(0.5);
+        result.percentile99 = percentile(0.99);
+        result.percentile999 = percentile(0.999);
+        return result;
+    }
+
+    /** @brief Measures the run time.
+     *
+     * @param function The function to measure. It is called several times,
+     *        so it must be idempotent.
+     *
+     * @returns The fastest run time, measured in nanoseconds. */
+    template<typename Function>
+    [[nodiscard]] static qint64 nanoseconds(Function function)
+    {
+        constexpr int runs = 3;
+        qint64 result = std::numeric_limits<qint64>::max();
+        QElapsedTimer timer;
+        for (int i = 0; i < runs; ++i) {
+            timer.start();
+            function();
+            result = qMin(result, timer.nsecsElapsed());
+        }
+        return result;
+    }
+
+    /** @brief Prints a report line about the errors.
+     *
+     * @param name Name of the fast code path
+     * @param errors Statistics about the errors
+     * @param unit Unit of the errors */
+    static void reportErrors(const char *name, const ErrorStatistics &errors, const char *unit)
+    {
+        qInfo().noquote().nospace() //
+            << name << ": error (" << unit << ") " //
+            << "max " << errors.maximum //
+            << ", median " << errors.median //
+            << ", p99 " << errors.percentile99 //
+            << ", p99.9 " << errors.percentile999;
+    }
+
+    /** @brief Prints a report line about the run time.
+     *
+     * @param name Name of the fast code path
+     * @param referenceNanoseconds Run time of the reference code path
+     * @param fastNanoseconds Run time of the fast code path
+     * @param count Number of values that have been processed */
+    static void reportTime(const char *name, const qint64 referenceNanoseconds, const qint64 fastNanoseconds, const qsizetype count)
+    {
+        const double divisor = static_cast<double>(qMax<qsizetype>(count, 1));
+        const double referenceTime = static_cast<double>(referenceNanoseconds) / divisor;
+        const double fastTime = static_cast<double>(fastNanoseconds) / divisor;
+        qInfo().noquote().nospace() //
+            << name << ": " << count << " values, " //
+            << "reference " << referenceTime << " ns/value, " //
+            << "fast " << fastTime << " ns/value, " //
+            << "speedup " << referenceTime / qMax(fastTime, 1e-9) << "×";
+    }
+
+    /** @brief Prints a report line about gamut decisions.
+     *
+     * @param name Name of the fast code path
+     * @param disagreements Number of values for which the fast code path
+     *        and the reference came to a different gamut decision
+     * @param count Number of values that have been processed */
+    static void reportDisagreement(const char *name, const qsizetype disagreements, const qsizetype count)
+    {
+        qInfo().noquote().nospace() //
+            << name << ": gamut decision disagreement " //
+            << disagreements << " of " << count << " values (rate " //
+            << static_cast<double>(disagreements) / static_cast<double>(qMax<qsizetype>(count, 1)) //
+            << ")";
+    }
+
+    /** @brief Reference for the gamut decision.
+     *
+     * A round-trip that calls LittleCMS directly, value by value, with the
+     * transforms of @ref m_colorSpace. It uses neither the kernels nor the
+     * gamut occupancy grid.
+     *
+     * @param lab The color
+     *
+     * @returns <tt>true</tt> if the color is in-gamut. */
+    [[nodiscard]] bool isCielabD50InGamutReference(const cmsCIELab &lab) const
+    {
+        if ((lab.L < 0) || (lab.L > 100)) {
+            return false;
+        }
+        const double maximumChroma = m_colorSpace->profileMaximumCielchD50Chroma();
+        if (lab.a * lab.a + lab.b * lab.b > maximumChroma * maximumChroma) {
+            return false;
+        }
+        RgbDouble rgb;
+        cmsDoTransform(m_colorSpace->d_pointer->m_transformCielabD50ToRgbHandle, &lab, &rgb, 1);
+        const auto isInUnitRange = [](const double value) {
+            return (value >= 0) && (value <= 1);
+        };
+        if (!isInUnitRange(rgb.red) || !isInUnitRange(rgb.green) || !isInUnitRange(rgb.blue)) {
+            return false;
+        }
+        cmsCIELab roundtrip;
+        cmsDoTransform(m_colorSpace->d_pointer->m_transformRgbToCielabD50Handle, &rgb, &roundtrip, 1);
+        const double deviationSquare = //
+            (lab.L - roundtrip.L) * (lab.L - roundtrip.L) //
+            + (lab.a - roundtrip.a) * (lab.a - roundtrip.a) //
+            + (lab.b - roundtrip.b) * (lab.b - roundtrip.b);
+        return deviationSquare <= //
+            RgbColorSpacePrivate::cielabDeviationLimit * RgbColorSpacePrivate::cielabDeviationLimit;
+    }
+
+    /** @brief If a color pair is at the discontinuity of CIEDE2000.
+     *
+     * CIEDE2000 is discontinuous where the hue difference (of the hues
+     * h′ with the adjusted a′ axis) is 180°. Within the error of
+     * @ref fastAtan2Degree() of this discontinuity, the batch version
+     * and the single-value version might legitimately end up on different
+     * sides. See @ref deltaE2000BatchMaximumError for details.
+     *
+     * @param first The first color
+     * @param second The second color
+     *
+     * @returns <tt>true</tt> if the pair is at the discontinuity. */
+    [[nodiscard]] static bool isAtCiede2000Discontinuity(const cmsCIELab &first, const cmsCIELab &second)
+    {
+        constexpr double pow25To7 = 6103515625.; // 25⁷
+        const double cMean = (std::hypot(first.a, first.b) + std::hypot(second.a, second.b)) / 2;
+        const double cMeanPow7 = std::pow(cMean, 7);
+        const double g = 0.5 * (1 - std::sqrt(cMeanPow7 / (cMeanPow7 + pow25To7)));
+        const double h1Prime = qRadiansToDegrees(std::atan2(first.b, (1 + g) * first.a));
+        const double h2Prime = qRadiansToDegrees(std::atan2(second.b, (1 + g) * second.a));
+        const double hueDifference = std::abs(h1Prime - h2Prime);
+        // Both hues might have the error of fastAtan2Degree().
+        constexpr double tolerance = 4 * fastAtan2MaximumErrorDegree;
+        return std::abs(hueDifference - 180) <= tolerance;
+    }
+
+    /** @brief Samples in CIELab-D50.
+     *
+     * @returns A dense grid that covers all valid lightness values and
+     * the relevant range of a and b (also out-of-gamut values),
+     * followed by random values within the same range. */
+    [[nodiscard]] static std::vector<cmsCIELab> sampleCielabD50()
+    {
+        std::vector<cmsCIELab> result;
+        for (int l = 0; l <= 100; l += 2) {
+            for (int a = -130; a <= 130; a += 4) {
+                for (int b = -130; b <= 130; b += 4) {
+                    result.push_back(cmsCIELab{static_cast<double>(l), //
+                                               static_cast<double>(a),
+                                               static_cast<double>(b)});
+                }
+            }
+        }
+        QRandomGenerator generator(randomSeed);
+        for (int i = 0; i < randomSampleCount; ++i) {
+            result.push_back(cmsCIELab{generator.bounded(100.), //
+                                       generator.bounded(260.) - 130,
+                                       generator.bounded(260.) - 130});
+        }
+        return result;
+    }
+
+    /** @brief Samples in CIELCh-D50.
+     *
+     * @returns A dense grid that covers all valid lightness values, the
+     * relevant range of chroma (also out-of-gamut values) and all hues,
+     * followed by random values within the same range. */
+    [[nodiscard]] static std::vector<cmsCIELCh> sampleCielchD50()
+    {
+        std::vector<cmsCIELCh> result;
+        for (int l = 0; l <= 100; l += 5) {
+            for (int c = 0; c <= 150; c += 5) {
+                for (int h = 0; h < 360; h += 2) {
+                    result.push_back(cmsCIELCh{static_cast<double>(l), //
+                                               static_cast<double>(c),
+                                               static_cast<double>(h)});
+                }
+            }
+        }
+        QRandomGenerator generator(randomSeed);
+        for (int i = 0; i < randomSampleCount; ++i) {
+            result.push_back(cmsCIELCh{generator.bounded(100.), //
+                                       generator.bounded(150.),
+                                       generator.bounded(360.)});
+        }
+        return result;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+        const QString fileName = //
+            qEnvironmentVariable("PERCEPTUALCOLOR_ACCURACY_PROFILE");
+        if (!fileName.isEmpty()) {
+            m_colorSpace = RgbColorSpaceFactory::createFromFile(fileName);
+            QVERIFY2(!m_colorSpace.isNull(), "Could not load the profile.");
+        } else {
+            m_colorSpace = RgbColorSpaceFactory::createSrgb();
+        }
+        qInfo().noquote() << "Color space:" << m_colorSpace->profileName();
+        qInfo().noquote() << "Instruction set:" << instructionSetName(activeInstructionSet());
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testFromLchToLab()
+    {
+        const auto samples = sampleCielchD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> l(samples.size());
+        std::vector<double> c(samples.size());
+        std::vector<double> h(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            l[i] = samples[i].L;
+            c[i] = samples[i].C;
+            h[i] = samples[i].h;
+        }
+
+        std::vector<cmsCIELab> reference(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                cmsLCh2Lab(&reference[i], &samples[i]);
+            }
+        });
+        std::vector<double> labL(samples.size());
+        std::vector<double> labA(samples.size());
+        std::vector<double> labB(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            fromLchToLab(l.data(), c.data(), h.data(), labL.data(), labA.data(), labB.data(), count);
+        });
+
+        std::vector<double> errors(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            errors[i] = std::hypot(labL[i] - reference[i].L, //
+                                   labA[i] - reference[i].a,
+                                   labB[i] - reference[i].b);
+        }
+        const auto result = statistics(errors);
+        reportErrors("fromLchToLab() versus cmsLCh2Lab()", result, "ΔE76");
+        reportTime("fromLchToLab() versus cmsLCh2Lab()", referenceTime, fastTime, count);
+        // Many orders of magnitude below the gamut precision
+        QVERIFY(result.maximum < gamutPrecisionCielab / 1000000);
+    }
+
+    void testFromLabToLch()
+    {
+        const auto samples = sampleCielabD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> l(samples.size());
+        std::vector<double> a(samples.size());
+        std::vector<double> b(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            l[i] = samples[i].L;
+            a[i] = samples[i].a;
+            b[i] = samples[i].b;
+        }
+
+        std::vector<cmsCIELCh> reference(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                cmsLab2LCh(&reference[i], &samples[i]);
+            }
+        });
+        std::vector<double> lchL(samples.size());
+        std::vector<double> lchC(samples.size());
+        std::vector<double> lchH(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            fromLabToLch(l.data(), a.data(), b.data(), lchL.data(), lchC.data(), lchH.data(), count);
+        });
+
+        std::vector<double> errors(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            double hueDifference = std::abs(lchH[i] - reference[i].h);
+            // 359.99999° and 0° are nearly the same hue.
+            hueDifference = qMin(hueDifference, 360 - hueDifference);
+            // Express the hue error as distance in the Lab space.
+            const double hueError = //
+                qDegreesToRadians(hueDifference) * reference[i].C;
+            errors[i] = std::hypot(lchL[i] - reference[i].L, //
+                                   lchC[i] - reference[i].C,
+                                   hueError);
+        }
+        const auto result = statistics(errors);
+        reportErrors("fromLabToLch() versus cmsLab2LCh()", result, "ΔE76");
+        reportTime("fromLabToLch() versus cmsLab2LCh()", referenceTime, fastTime, count);
+        // Many orders of magnitude below the gamut precision
+        QVERIFY(result.maximum < gamutPrecisionCielab / 1000000);
+    }
+
+    void testFromXyzd65ToOklabFast()
+    {
+        // XYZ values of the CIELab samples
+        const auto cielab = sampleCielabD50();
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        for (const cmsCIELab &value : cielab) {
+            cmsCIEXYZ xyzD50;
+            cmsLab2XYZ(cmsD50_XYZ(), &xyzD50, &value);
+            const auto xyzD65 = multiplyMatrix3(xyzD50ToXyzD65, //
+                                                 Vector3{xyzD50.X, xyzD50.Y, xyzD50.Z});
+            x.push_back(xyzD65[0]);
+            y.push_back(xyzD65[1]);
+            z.push_back(xyzD65[2]);
+        }
+        const auto count = static_cast<qsizetype>(x.size());
+
+        std::vector<Vector3> reference(x.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                reference[i] = fromXyzd65ToOklab(Vector3{x[i], y[i], z[i]});
+            }
+        });
+        std::vector<double> oklabL(x.size());
+        std::vector<double> oklabA(x.size());
+        std::vector<double> oklabB(x.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            fromXyzd65ToOklab(x.data(), //
+                              y.data(),
+                              z.data(),
+                              oklabL.data(),
+                              oklabA.data(),
+                              oklabB.data(),
+                              count,
+                              ConversionPrecision::Fast);
+        });
+
+        std::vector<double> errors(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            errors[i] = qMax(std::abs(oklabL[i] - reference[i][0]), //
+                             qMax(std::abs(oklabA[i] - reference[i][1]), //
+                                  std::abs(oklabB[i] - reference[i][2])));
+        }
+        const auto result = statistics(errors);
+        reportErrors("fromXyzd65ToOklab() batch fast versus precise", result, "Oklab per channel");
+        reportTime("fromXyzd65ToOklab() batch fast versus precise", referenceTime, fastTime, count);
+        // Documented bound of the fast cube root for the Oklab conversion
+        QVERIFY(result.maximum < 2e-5);
+        QVERIFY(result.maximum < gamutPrecisionOklab);
+    }
+
+    void testPolarToCartesian()
+    {
+        const auto samples = sampleCielchD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> radius(samples.size());
+        std::vector<double> angleDegree(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            radius[i] = samples[i].C;
+            angleDegree[i] = samples[i].h;
+        }
+        std::vector<double> referenceX(samples.size());
+        std::vector<double> referenceY(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            colorKernels(InstructionSet::Scalar)
+                .polarToCartesian(radius.data(), angleDegree.data(), referenceX.data(), referenceY.data(), count);
+        });
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            colorKernels().polarToCartesian(radius.data(), angleDegree.data(), x.data(), y.data(), count);
+        });
+
+        std::vector<double> errors(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            errors[i] = std::hypot(x[i] - referenceX[i], y[i] - referenceY[i]);
+        }
+        const auto result = statistics(errors);
+        reportErrors("polarToCartesian versus std::sin()/std::cos()", result, "distance");
+        reportTime("polarToCartesian versus std::sin()/std::cos()", referenceTime, fastTime, count);
+        QVERIFY(result.maximum <= 2 * fastSinCosMaximumError * 150);
+    }
+
+    void testCartesianToPolar()
+    {
+        const auto samples = sampleCielabD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            x[i] = samples[i].a;
+            y[i] = samples[i].b;
+        }
+        std::vector<double> referenceRadius(samples.size());
+        std::vector<double> referenceAngle(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            colorKernels(InstructionSet::Scalar)
+                .cartesianToPolar(x.data(), y.data(), referenceRadius.data(), referenceAngle.data(), count);
+        });
+        std::vector<double> radius(samples.size());
+        std::vector<double> angle(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            colorKernels().cartesianToPolar(x.data(), y.data(), radius.data(), angle.data(), count);
+        });
+
+        std::vector<double> errors(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            double angleDifference = std::abs(angle[i] - referenceAngle[i]);
+            // 359.99999° and 0° are nearly the same angle.
+            angleDifference = qMin(angleDifference, 360 - angleDifference);
+            errors[i] = angleDifference;
+            QVERIFY(std::abs(radius[i] - referenceRadius[i]) < 1e-12);
+        }
+        const auto result = statistics(errors);
+        reportErrors("cartesianToPolar versus std::atan2()", result, "degree");
+        reportTime("cartesianToPolar versus std::atan2()", referenceTime, fastTime, count);
+        QVERIFY(result.maximum <= fastAtan2MaximumErrorDegree);
+    }
+
+    void testCiede2000()
+    {
+        // Pairs of random colors, and pairs of neighbors (small differences
+        // are the most relevant case in practice).
+        const auto samples = sampleCielabD50();
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        QRandomGenerator generator(randomSeed);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            first.push_back(samples[i]);
+            second.push_back(samples[(i * 7919) % samples.size()]);
+            first.push_back(samples[i]);
+            second.push_back(cmsCIELab{samples[i].L + generator.bounded(2.) - 1, //
+                                       samples[i].a + generator.bounded(2.) - 1,
+                                       samples[i].b + generator.bounded(2.) - 1});
+        }
+        const auto count = static_cast<qsizetype>(first.size());
+
+        // Contract: The single-value version is the reference.
+        std::vector<double> reference(first.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < first.size(); ++i) {
+                reference[i] = deltaE2000(first[i], second[i]);
+            }
+        });
+        std::vector<double> fast(first.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            deltaE2000(first.data(), second.data(), fast.data(), count);
+        });
+
+        std::vector<double> errors;
+        qsizetype discontinuityCount = 0;
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            if (isAtCiede2000Discontinuity(first[i], second[i])) {
+                // Documented exception of the contract
+                ++discontinuityCount;
+                continue;
+            }
+            errors.push_back(std::abs(fast[i] - reference[i]));
+        }
+        const auto result = statistics(errors);
+        reportErrors("deltaE2000() batch versus single value", result, "ΔE2000");
+        reportTime("deltaE2000() batch versus single value", referenceTime, fastTime, count);
+        qInfo().noquote().nospace() //
+            << "deltaE2000() batch versus single value: " //
+            << discontinuityCount << " pairs at the discontinuity excluded";
+        QVERIFY(result.maximum < deltaE2000BatchMaximumError);
+
+        // For information: LittleCMS implements the same formula, but
+        // not in the same way. Near the discontinuity, both
+        // implementations might choose different branches.
+        std::vector<double> littleCmsErrors(first.size());
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            littleCmsErrors[i] = std::abs( //
+                reference[i] - cmsCIE2000DeltaE(&first[i], &second[i], 1, 1, 1));
+        }
+        reportErrors("deltaE2000() single value versus cmsCIE2000DeltaE()", statistics(littleCmsErrors), "ΔE2000");
+    }
+
+    void testIsCielabD50InGamut()
+    {
+        const auto samples = sampleCielabD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+
+        const auto reference = std::make_unique<bool[]>(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                reference[i] = isCielabD50InGamutReference(samples[i]);
+            }
+        });
+        const auto fast = std::make_unique<bool[]>(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            m_colorSpace->isCielabD50InGamut(samples.data(), fast.get(), count);
+        });
+
+        qsizetype disagreements = 0;
+        qsizetype singleValueDisagreements = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            if (fast[i] != reference[i]) {
+                ++disagreements;
+            }
+            if (m_colorSpace->isCielabD50InGamut(samples[i]) != reference[i]) {
+                ++singleValueDisagreements;
+            }
+        }
+        reportTime("isCielabD50InGamut() batch versus LittleCMS", referenceTime, fastTime, count);
+        reportDisagreement("isCielabD50InGamut() batch versus LittleCMS", disagreements, count);
+        reportDisagreement("isCielabD50InGamut() single value versus LittleCMS", singleValueDisagreements, count);
+        // Contract: Both are exact and give the same results.
+        QCOMPARE(disagreements, static_cast<qsizetype>(0));
+        QCOMPARE(singleValueDisagreements, static_cast<qsizetype>(0));
+    }
+
+    void testIsCielabD50InGamutApproximate()
+    {
+        const auto samples = sampleCielabD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+
+        // Start the build of the gamut occupancy grid, and wait until
+        // it is available.
+        const auto fast = std::make_unique<bool[]>(samples.size());
+        m_colorSpace->isCielabD50InGamutApproximate(samples.data(), fast.get(), 1);
+        QTRY_VERIFY_WITH_TIMEOUT( //
+            m_colorSpace->d_pointer->gamutOccupancyGrid() != nullptr,
+            60000);
+
+        const auto reference = std::make_unique<bool[]>(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            m_colorSpace->isCielabD50InGamut(samples.data(), reference.get(), count);
+        });
+        const qint64 fastTime = nanoseconds([&]() {
+            m_colorSpace->isCielabD50InGamutApproximate(samples.data(), fast.get(), count);
+        });
+
+        qsizetype disagreements = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            if (fast[i] != reference[i]) {
+                ++disagreements;
+            }
+        }
+        reportTime("isCielabD50InGamutApproximate() versus exact batch", referenceTime, fastTime, count);
+        reportDisagreement("isCielabD50InGamutApproximate() versus exact batch", disagreements, count);
+        // The grid is a heuristic without accuracy contract, so this
+        // is only reported.
+    }
+
+    void testFromCielabD50ToQRgbOrTransparent()
+    {
+        const auto samples = sampleCielabD50();
+        const auto count = static_cast<qsizetype>(samples.size());
+
+        // Reference: The gamut decision of LittleCMS and the
+        // quantization by QColor
+        std::vector<QRgb> reference(samples.size());
+        const qint64 referenceTime = nanoseconds([&]() {
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                if (isCielabD50InGamutReference(samples[i])) {
+                    const RgbDouble rgb = m_colorSpace->fromCielchD50ToRgbDoubleUnbound( //
+                        toLchDouble(samples[i]));
+                    reference[i] = qColorFromRgbDouble(rgb.red, rgb.green, rgb.blue).rgb();
+                } else {
+                    reference[i] = 0;
+                }
+            }
+        });
+        std::vector<QRgb> fast(samples.size());
+        const qint64 fastTime = nanoseconds([&]() {
+            m_colorSpace->fromCielabD50ToQRgbOrTransparent(samples.data(), fast.data(), count);
+        });
+
+        std::vector<double> errors;
+        qsizetype disagreements = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const bool fastIsOpaque = qAlpha(fast[i]) != 0;
+            const bool referenceIsOpaque = qAlpha(reference[i]) != 0;
+            if (fastIsOpaque != referenceIsOpaque) {
+                ++disagreements;
+                continue;
+            }
+            if (fastIsOpaque) {
+                errors.push_back(qMax(qAbs(qRed(fast[i]) - qRed(reference[i])), //
+                                      qMax(qAbs(qGreen(fast[i]) - qGreen(reference[i])), //
+                                           qAbs(qBlue(fast[i]) - qBlue(reference[i])))));
+            }
+        }
+        const auto result = statistics(errors);
+        reportErrors("fromCielabD50ToQRgbOrTransparent() batch versus QColor", result, "8-bit steps");
+        reportTime("fromCielabD50ToQRgbOrTransparent() batch versus QColor", referenceTime, fastTime, count);
+        reportDisagreement("fromCielabD50ToQRgbOrTransparent() batch versus QColor", disagreements, count);
+        // The conversions to LCH and back in the reference path introduce
+        // tiny differences, and QColor might use float internally. This
+        // allows a difference of one 8-bit step. The gamut decision is
+        // exact.
+        QVERIFY(result.maximum <= 1);
+        QCOMPARE(disagreements, static_cast<qsizetype>(0));
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestColorKernelAccuracy)
+// The following “include” is necessary because we do not use a header file:
+#include "testcolorkernelaccuracy.moc"
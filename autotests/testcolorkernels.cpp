@@ -0,0 +1,528 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "colorkernels.h"
+
+#include "colordifference.h"
+#include "helpermath.h"
+#include "instructionset.h"
+#include "rgbdouble.h"
+#include <cmath>
+#include <lcms2.h>
+#include <memory>
+#include <qglobal.h>
+#include <qobject.h>
+#include <qrgb.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qtestdata.h>
+#include <vector>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qstring.h>
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+Q_DECLARE_METATYPE(PerceptualColor::InstructionSet)
+
+namespace PerceptualColor
+{
+class TestColorKernels : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestColorKernels(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    // Test data: Values in structure-of-arrays layout, covering the
+    // typical range and going a little bit beyond.
+    struct Channels {
+        std::vector<double> first;
+        std::vector<double> second;
+        std::vector<double> third;
+    };
+
+    static Channels sampleXyzValues()
+    {
+        Channels result;
+        for (int x = -2; x <= 12; ++x) {
+            for (int y = -2; y <= 12; ++y) {
+                for (int z = -2; z <= 12; ++z) {
+                    result.first.push_back(x / 10.0);
+                    result.second.push_back(y / 10.0);
+                    result.third.push_back(z / 10.0);
+                }
+            }
+        }
+        return result;
+    }
+
+    static Channels sampleOklabValues()
+    {
+        Channels result;
+        for (int l = 0; l <= 10; ++l) {
+            for (int a = -5; a <= 5; ++a) {
+                for (int b = -5; b <= 5; ++b) {
+                    result.first.push_back(l / 10.0);
+                    result.second.push_back(a / 10.0);
+                    result.third.push_back(b / 10.0);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Polar coordinates: radius (first) and angle in degree (second)
+    static Channels samplePolarValues()
+    {
+        Channels result;
+        for (int radius = 0; radius <= 200; radius += 5) {
+            for (int angle = -3600; angle <= 7200; angle += 7) {
+                result.first.push_back(radius);
+                result.second.push_back(angle / 10.0);
+            }
+        }
+        return result;
+    }
+
+    // Cartesian coordinates: x (first) and y (second)
+    static Channels sampleCartesianValues()
+    {
+        Channels result;
+        for (int x = -200; x <= 200; x += 3) {
+            for (int y = -200; y <= 200; y += 3) {
+                result.first.push_back(x / 1.5);
+                result.second.push_back(y / 1.5);
+            }
+        }
+        return result;
+    }
+
+    // Pairs of CIELab values
+    static void sampleCielabPairs(std::vector<cmsCIELab> &first, std::vector<cmsCIELab> &second)
+    {
+        for (int l = 0; l <= 100; l += 20) {
+            for (int a = -120; a <= 120; a += 15) {
+                for (int b = -120; b <= 120; b += 15) {
+                    first.push_back(cmsCIELab{static_cast<double>(l), //
+                                              static_cast<double>(a),
+                                              static_cast<double>(b)});
+                    second.push_back(cmsCIELab{(l + 37) % 100 + 0.5, //
+                                               b * 0.9,
+                                               a / 2.});
+                }
+            }
+        }
+    }
+
+    static void addInstructionSetColumn()
+    {
+        QTest::addColumn<InstructionSet>("instructionSet");
+        const auto list = availableInstructionSets();
+        for (const auto instructionSet : list) {
+            QTest::newRow(qPrintable(instructionSetName(instructionSet))) //
+                << instructionSet;
+        }
+    }
+
+    // Compares the results of a kernel with the results of the scalar
+    // reference implementation. The results might not be bit-identical,
+    // because some instruction sets use fused multiply-add.
+    static bool isNearlyEqualVector(const std::vector<double> &first, const std::vector<double> &second)
+    {
+        if (first.size() != second.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            if (!isNearlyEqual(first.at(i), second.at(i), 1e-12)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testActiveKernels()
+    {
+        QCOMPARE(&colorKernels(), &colorKernels(activeInstructionSet()));
+    }
+
+    void testXyzd65ToOklab_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testXyzd65ToOklab()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleXyzValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels expected = input;
+        colorKernels(InstructionSet::Scalar)
+            .xyzd65ToOklab(input.first.data(), input.second.data(), input.third.data(), expected.first.data(), expected.second.data(), expected.third.data(), count);
+        Channels actual = input;
+        colorKernels(instructionSet)
+            .xyzd65ToOklab(input.first.data(), input.second.data(), input.third.data(), actual.first.data(), actual.second.data(), actual.third.data(), count);
+        QVERIFY(isNearlyEqualVector(actual.first, expected.first));
+        QVERIFY(isNearlyEqualVector(actual.second, expected.second));
+        QVERIFY(isNearlyEqualVector(actual.third, expected.third));
+    }
+
+    void testXyzd65ToOklabFast_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testXyzd65ToOklabFast()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleXyzValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels expected = input;
+        colorKernels(InstructionSet::Scalar)
+            .xyzd65ToOklabFast(input.first.data(), input.second.data(), input.third.data(), expected.first.data(), expected.second.data(), expected.third.data(), count);
+        // In-place
+        Channels actual = input;
+        colorKernels(instructionSet)
+            .xyzd65ToOklabFast(actual.first.data(), actual.second.data(), actual.third.data(), actual.first.data(), actual.second.data(), actual.third.data(), count);
+        QVERIFY(isNearlyEqualVector(actual.first, expected.first));
+        QVERIFY(isNearlyEqualVector(actual.second, expected.second));
+        QVERIFY(isNearlyEqualVector(actual.third, expected.third));
+    }
+
+    void testOklabToXyzd65_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testOklabToXyzd65()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleOklabValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels expected = input;
+        colorKernels(InstructionSet::Scalar)
+            .oklabToXyzd65(input.first.data(), input.second.data(), input.third.data(), expected.first.data(), expected.second.data(), expected.third.data(), count);
+        Channels actual = input;
+        colorKernels(instructionSet)
+            .oklabToXyzd65(input.first.data(), input.second.data(), input.third.data(), actual.first.data(), actual.second.data(), actual.third.data(), count);
+        QVERIFY(isNearlyEqualVector(actual.first, expected.first));
+        QVERIFY(isNearlyEqualVector(actual.second, expected.second));
+        QVERIFY(isNearlyEqualVector(actual.third, expected.third));
+    }
+
+    void testPolarToCartesian_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testPolarToCartesian()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = samplePolarValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels expected = input;
+        colorKernels(InstructionSet::Scalar)
+            .polarToCartesian(input.first.data(), input.second.data(), expected.first.data(), expected.second.data(), count);
+        // In-place
+        Channels actual = input;
+        colorKernels(instructionSet)
+            .polarToCartesian(actual.first.data(), actual.second.data(), actual.first.data(), actual.second.data(), count);
+        // The scalar reference uses the standard library, the other
+        // instruction sets use an approximation.
+        for (std::size_t i = 0; i < input.first.size(); ++i) {
+            const double tolerance = //
+                fastSinCosMaximumError * qMax(1., input.first.at(i));
+            QVERIFY(std::abs(actual.first.at(i) - expected.first.at(i)) <= tolerance);
+            QVERIFY(std::abs(actual.second.at(i) - expected.second.at(i)) <= tolerance);
+        }
+    }
+
+    void testCartesianToPolar_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testCartesianToPolar()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleCartesianValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels expected = input;
+        colorKernels(InstructionSet::Scalar)
+            .cartesianToPolar(input.first.data(), input.second.data(), expected.first.data(), expected.second.data(), count);
+        Channels actual = input;
+        colorKernels(instructionSet)
+            .cartesianToPolar(input.first.data(), input.second.data(), actual.first.data(), actual.second.data(), count);
+        QVERIFY(isNearlyEqualVector(actual.first, expected.first));
+        for (std::size_t i = 0; i < input.first.size(); ++i) {
+            QVERIFY(isInRange(0., actual.second.at(i), 360.));
+            double error = std::abs(actual.second.at(i) - expected.second.at(i));
+            // 0° and 360° are the same angle.
+            error = qMin(error, std::abs(error - 360));
+            QVERIFY(error <= fastAtan2MaximumErrorDegree);
+        }
+    }
+
+    void testEuclideanDistance_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testEuclideanDistance()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> expected(first.size());
+        colorKernels(InstructionSet::Scalar)
+            .euclideanDistance(first.data(), second.data(), expected.data(), count);
+        std::vector<double> actual(first.size());
+        colorKernels(instructionSet)
+            .euclideanDistance(first.data(), second.data(), actual.data(), count);
+        QVERIFY(isNearlyEqualVector(actual, expected));
+    }
+
+    void testCiede2000_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testCiede2000()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> expected(first.size());
+        colorKernels(InstructionSet::Scalar)
+            .ciede2000(first.data(), second.data(), expected.data(), count);
+        std::vector<double> actual(first.size());
+        colorKernels(instructionSet)
+            .ciede2000(first.data(), second.data(), actual.data(), count);
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            QVERIFY(std::abs(actual.at(i) - expected.at(i)) <= deltaE2000BatchMaximumError);
+        }
+    }
+
+    void testCielabD50InGamut_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testCielabD50InGamut()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        // Construct data that covers all conditions of the test.
+        std::vector<cmsCIELab> original;
+        std::vector<RgbDouble> rgb;
+        std::vector<cmsCIELab> roundtrip;
+        const double lightnessValues[] = {-1, 0, 50, 100, 101};
+        const double chromaValues[] = {0, 30, 60};
+        const double rgbValues[] = {-0.1, 0, 0.5, 1, 1.1};
+        const double deviationValues[] = {0, 0.4, 0.6};
+        for (const double lightness : lightnessValues) {
+            for (const double chroma : chromaValues) {
+                for (const double rgbValue : rgbValues) {
+                    for (const double deviation : deviationValues) {
+                        original.push_back(cmsCIELab{lightness, chroma, 0});
+                        rgb.push_back(RgbDouble{0.5, rgbValue, 0.5});
+                        roundtrip.push_back(cmsCIELab{lightness, chroma, deviation});
+                    }
+                }
+            }
+        }
+        const auto count = static_cast<qsizetype>(original.size());
+        const auto expected = std::make_unique<bool[]>(original.size());
+        const auto actual = std::make_unique<bool[]>(original.size());
+        constexpr double maximumChromaSquare = 50 * 50;
+        constexpr double deviationLimitSquare = 0.5 * 0.5;
+        colorKernels(InstructionSet::Scalar)
+            .cielabD50InGamut(original.data(), rgb.data(), roundtrip.data(), expected.get(), count, maximumChromaSquare, deviationLimitSquare);
+        colorKernels(instructionSet)
+            .cielabD50InGamut(original.data(), rgb.data(), roundtrip.data(), actual.get(), count, maximumChromaSquare, deviationLimitSquare);
+        int inGamutCount = 0;
+        for (std::size_t i = 0; i < original.size(); ++i) {
+            QCOMPARE(actual[i], expected[i]);
+            if (expected[i]) {
+                ++inGamutCount;
+            }
+        }
+        // Lightness: 3 valid values. Chroma: 2 valid values.
+        // RGB: 3 valid values. Deviation: 2 valid values.
+        QCOMPARE(inGamutCount, 3 * 2 * 3 * 2);
+    }
+
+    void testCielabD50ToQRgbOrTransparent_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void testCielabD50ToQRgbOrTransparent()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        // Same data as in testCielabD50InGamut(), so that all conditions
+        // of the gamut test are covered.
+        std::vector<cmsCIELab> original;
+        std::vector<RgbDouble> rgb;
+        std::vector<cmsCIELab> roundtrip;
+        const double lightnessValues[] = {-1, 0, 50, 100, 101};
+        const double chromaValues[] = {0, 30, 60};
+        const double rgbValues[] = {-0.1, 0, 0.5, 1, 1.1};
+        const double deviationValues[] = {0, 0.4, 0.6};
+        for (const double lightness : lightnessValues) {
+            for (const double chroma : chromaValues) {
+                for (const double rgbValue : rgbValues) {
+                    for (const double deviation : deviationValues) {
+                        original.push_back(cmsCIELab{lightness, chroma, 0});
+                        rgb.push_back(RgbDouble{0.25, rgbValue, 0.75});
+                        roundtrip.push_back(cmsCIELab{lightness, chroma, deviation});
+                    }
+                }
+            }
+        }
+        const auto count = static_cast<qsizetype>(original.size());
+        std::vector<QRgb> expected(original.size());
+        std::vector<QRgb> actual(original.size());
+        constexpr double maximumChromaSquare = 50 * 50;
+        constexpr double deviationLimitSquare = 0.5 * 0.5;
+        colorKernels(InstructionSet::Scalar)
+            .cielabD50ToQRgbOrTransparent(original.data(), rgb.data(), roundtrip.data(), expected.data(), count, maximumChromaSquare, deviationLimitSquare);
+        colorKernels(instructionSet)
+            .cielabD50ToQRgbOrTransparent(original.data(), rgb.data(), roundtrip.data(), actual.data(), count, maximumChromaSquare, deviationLimitSquare);
+        int opaqueCount = 0;
+        for (std::size_t i = 0; i < original.size(); ++i) {
+            QCOMPARE(actual[i], expected[i]);
+            if (qAlpha(expected[i]) == 255) {
+                ++opaqueCount;
+            } else {
+                // Fully transparent, not only the alpha channel
+                QCOMPARE(expected[i], QRgb(0));
+            }
+        }
+        QCOMPARE(opaqueCount, 3 * 2 * 3 * 2);
+    }
+
+    void benchmarkXyzd65ToOklabFast_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void benchmarkXyzd65ToOklabFast()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleXyzValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels output = input;
+        const auto &kernels = colorKernels(instructionSet);
+        QBENCHMARK {
+            kernels.xyzd65ToOklabFast(input.first.data(), input.second.data(), input.third.data(), output.first.data(), output.second.data(), output.third.data(), count);
+        }
+    }
+
+    void benchmarkOklabToXyzd65_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void benchmarkOklabToXyzd65()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleOklabValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels output = input;
+        const auto &kernels = colorKernels(instructionSet);
+        QBENCHMARK {
+            kernels.oklabToXyzd65(input.first.data(), input.second.data(), input.third.data(), output.first.data(), output.second.data(), output.third.data(), count);
+        }
+    }
+
+    void benchmarkPolarToCartesian_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void benchmarkPolarToCartesian()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = samplePolarValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels output = input;
+        const auto &kernels = colorKernels(instructionSet);
+        QBENCHMARK {
+            kernels.polarToCartesian(input.first.data(), input.second.data(), output.first.data(), output.second.data(), count);
+        }
+    }
+
+    void benchmarkCartesianToPolar_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void benchmarkCartesianToPolar()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        const auto input = sampleCartesianValues();
+        const auto count = static_cast<qsizetype>(input.first.size());
+        Channels output = input;
+        const auto &kernels = colorKernels(instructionSet);
+        QBENCHMARK {
+            kernels.cartesianToPolar(input.first.data(), input.second.data(), output.first.data(), output.second.data(), count);
+        }
+    }
+
+    void benchmarkCiede2000_data()
+    {
+        addInstructionSetColumn();
+    }
+
+    void benchmarkCiede2000()
+    {
+        QFETCH(InstructionSet, instructionSet);
+        std::vector<cmsCIELab> first;
+        std::vector<cmsCIELab> second;
+        sampleCielabPairs(first, second);
+        const auto count = static_cast<qsizetype>(first.size());
+        std::vector<double> result(first.size());
+        const auto &kernels = colorKernels(instructionSet);
+        QBENCHMARK {
+            kernels.ciede2000(first.data(), second.data(), result.data(), count);
+        }
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestColorKernels)
+// The following “include” is necessary because we do not use a header file:
+#include "testcolorkernels.moc"
@@ -166,6 +166,32 @@ private Q_SLOTS:
         QVERIFY2(myColorWheel.d_pointer->innerDiameter() < myColorWheel.size().height(), "innerDiameter() is smaller than the widget’s height.");
     }
 
+    void testResize()
+    {
+        // A child widget gets its resize events immediately.
+        QWidget parent;
+        ColorWheel myColorWheel(m_rgbColorSpace, &parent);
+        myColorWheel.setResizeRenderDelay(50);
+        myColorWheel.resize(200, 200);
+        parent.show();
+        const auto &image = myColorWheel.d_pointer->m_wheelImage;
+        QTRY_VERIFY(!image.getCache().isNull());
+        QTRY_VERIFY(!myColorWheel.isResizing());
+        const int oldSize = image.imageParameters().imageSizePhysical;
+
+        // An interactive resize keeps the image size.
+        myColorWheel.resize(250, 250);
+        myColorWheel.repaint();
+        QVERIFY(myColorWheel.isResizing());
+        QCOMPARE(image.imageParameters().imageSizePhysical, oldSize);
+
+        // Once the size is stable, the image gets the new size.
+        QTRY_COMPARE(image.imageParameters().imageSizePhysical, //
+                     myColorWheel.maximumPhysicalSquareSize());
+        QTRY_COMPARE(image.getCache().width(), //
+                     myColorWheel.maximumPhysicalSquareSize());
+    }
+
     void testVerySmallWidgetSizes()
     {
         // Also very small widget sizes should not crash the widget.
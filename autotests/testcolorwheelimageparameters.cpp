@@ -0,0 +1,460 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "colorwheelimageparameters.h"
+
+#include "asyncimageprovider.h"
+#include "asyncimagerendercallback.h"
+#include "cielchd50values.h"
+#include "lchdouble.h"
+#include "rgbcolorspace.h"
+#include "rgbcolorspacefactory.h"
+#include <qbenchmark.h>
+#include <qcolor.h>
+#include <qglobal.h>
+#include <qimage.h>
+#include <qlist.h>
+#include <qmath.h>
+#include <qobject.h>
+#include <qsharedpointer.h>
+#include <qsize.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qvariant.h>
+#include <qwidget.h>
+#include <utility>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+class TestColorWheelSnippetClass : public QWidget
+{
+    Q_OBJECT
+public:
+    // A constructor that is clazy-conform
+    explicit TestColorWheelSnippetClass(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+    }
+    void testSnippet01()
+    {
+        //! [ColorWheelImageParameters HiDPI usage]
+        PerceptualColor::ColorWheelImageParameters myParameters;
+        myParameters.rgbColorSpace = //
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+        // The member imageSizePhysical expects an int
+        // value. static_cast<int> will round down, which
+        // is the desired behaviour here. (Rounding up
+        // would mean one more pixel, and on some Qt
+        // styles this would fail.)
+        myParameters.imageSizePhysical = //
+            static_cast<int>(100 * devicePixelRatioF());
+        myParameters.borderPhysical = 5 * devicePixelRatioF();
+        myParameters.wheelThicknessPhysical = 10 * devicePixelRatioF();
+        myParameters.devicePixelRatioF = devicePixelRatioF();
+        PerceptualColor::AsyncImageProvider< //
+            PerceptualColor::ColorWheelImageParameters>
+            myImageProvider;
+        myImageProvider.setImageParameters(myParameters);
+        myImageProvider.refreshSync();
+        QImage myImage = myImageProvider.getCache();
+        //! [ColorWheelImageParameters HiDPI usage]
+        Q_UNUSED(myImage)
+    }
+};
+
+namespace PerceptualColor
+{
+class Mockup : public AsyncImageRenderCallback
+{
+public:
+    virtual bool shouldAbort() const override;
+    virtual void deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state) override;
+    bool abort = false;
+    QList<QImage> deliveredImages;
+    QList<InterlacingState> deliveredStates;
+};
+
+bool Mockup::shouldAbort() const
+{
+    return abort;
+}
+
+void Mockup::deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state)
+{
+    Q_UNUSED(parameters)
+    deliveredImages.append(image);
+    deliveredStates.append(state);
+}
+
+class TestColorWheelImageParameters : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestColorWheelImageParameters(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    QSharedPointer<RgbColorSpace> colorSpace = RgbColorSpaceFactory::createSrgb();
+
+    // Renders synchronously and returns the final image.
+    [[nodiscard]] static QImage renderImage(const ColorWheelImageParameters &parameters)
+    {
+        Mockup myMockup;
+        ColorWheelImageParameters::render(QVariant::fromValue(parameters), myMockup);
+        if (myMockup.deliveredImages.isEmpty()) {
+            return QImage();
+        }
+        return myMockup.deliveredImages.last();
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testConstructorDestructor()
+    {
+        ColorWheelImageParameters test;
+    }
+
+    void testCopyConstructor()
+    {
+        ColorWheelImageParameters test;
+        test.borderPhysical = 5;
+        test.rgbColorSpace = colorSpace;
+        ColorWheelImageParameters copy(test);
+        QCOMPARE(copy.borderPhysical, 5.);
+        QCOMPARE(copy.rgbColorSpace, colorSpace);
+    }
+
+    void testEqualOperator()
+    {
+        ColorWheelImageParameters test;
+        test.imageSizePhysical = 50;
+        test.rgbColorSpace = colorSpace;
+        ColorWheelImageParameters other = test;
+        QVERIFY(test == other);
+        QVERIFY(!(test != other));
+        other.wheelThicknessPhysical = 5;
+        QVERIFY(!(test == other));
+        QVERIFY(test != other);
+    }
+
+    void testImageSize()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        QCOMPARE(renderImage(test).size(), QSize(0, 0));
+        test.imageSizePhysical = 5;
+        QCOMPARE(renderImage(test).size(), QSize(5, 5));
+        test.imageSizePhysical = 500;
+        QCOMPARE(renderImage(test).size(), QSize(500, 500));
+        test.imageSizePhysical = -5;
+        QCOMPARE(renderImage(test).size(), QSize(0, 0));
+    }
+
+    void testDevicePixelRatioF()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 100;
+        // Image size is as described.
+        QCOMPARE(renderImage(test).size(), QSize(100, 100));
+        // Default devicePixelRatioF is 1
+        QCOMPARE(renderImage(test).devicePixelRatio(), 1);
+        // Testing with a (non-integer) scale factor
+        test.devicePixelRatioF = 1.5;
+        // Image size remains unchanged.
+        QCOMPARE(renderImage(test).size(), QSize(100, 100));
+        // Default devicePixelRatioF is 1.5
+        QCOMPARE(renderImage(test).devicePixelRatio(), 1.5);
+    }
+
+    void testBorderOdd()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 99;
+        // Default border is zero: no transparent border.
+        QImage image = renderImage(test);
+        QVERIFY2(image.pixelColor(49, 0).alpha() > 0, "Verify that pixel top center is not transparent.");
+        QVERIFY2(image.pixelColor(49, 98).alpha() > 0, "Verify that pixel bottom center is not transparent.");
+        QVERIFY2(image.pixelColor(0, 49).alpha() > 0, "Verify that pixel left is not transparent.");
+        QVERIFY2(image.pixelColor(98, 49).alpha() > 0, "Verify that pixel right is not transparent.");
+        test.borderPhysical = 1;
+        // Now, the pixels should become transparent.
+        image = renderImage(test);
+        QCOMPARE(image.pixelColor(49, 0).alpha(), 0);
+        QCOMPARE(image.pixelColor(49, 98).alpha(), 0);
+        QCOMPARE(image.pixelColor(0, 49).alpha(), 0);
+        QCOMPARE(image.pixelColor(98, 49).alpha(), 0);
+    }
+
+    void testBorderEven()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 100;
+        // Default border is zero: no transparent border.
+        QImage image = renderImage(test);
+        QVERIFY2(image.pixelColor(49, 0).alpha() > 0, "Verify that pixel top center is not transparent.");
+        QVERIFY2(image.pixelColor(50, 0).alpha() > 0, "Verify that pixel top center is not transparent.");
+        QVERIFY2(image.pixelColor(49, 99).alpha() > 0, "Verify that pixel bottom center is not transparent.");
+        QVERIFY2(image.pixelColor(50, 99).alpha() > 0, "Verify that pixel bottom center is not transparent.");
+        QVERIFY2(image.pixelColor(0, 49).alpha() > 0, "Verify that pixel left is not transparent.");
+        QVERIFY2(image.pixelColor(0, 50).alpha() > 0, "Verify that pixel left is not transparent.");
+        QVERIFY2(image.pixelColor(99, 49).alpha() > 0, "Verify that pixel right is not transparent.");
+        QVERIFY2(image.pixelColor(99, 50).alpha() > 0, "Verify that pixel right is not transparent.");
+        test.borderPhysical = 1;
+        // Now, the pixels should become transparent.
+        image = renderImage(test);
+        QCOMPARE(image.pixelColor(49, 0).alpha(), 0);
+        QCOMPARE(image.pixelColor(50, 0).alpha(), 0);
+        QCOMPARE(image.pixelColor(49, 99).alpha(), 0);
+        QCOMPARE(image.pixelColor(50, 99).alpha(), 0);
+        QCOMPARE(image.pixelColor(0, 49).alpha(), 0);
+        QCOMPARE(image.pixelColor(0, 50).alpha(), 0);
+        QCOMPARE(image.pixelColor(99, 49).alpha(), 0);
+        QCOMPARE(image.pixelColor(99, 50).alpha(), 0);
+    }
+
+    void testInterlacing()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 100;
+        test.wheelThicknessPhysical = 10;
+        Mockup myMockup;
+        ColorWheelImageParameters::render(QVariant::fromValue(test), myMockup);
+        // There are intermediate results before the final result.
+        QVERIFY(myMockup.deliveredImages.count() > 1);
+        QCOMPARE(myMockup.deliveredStates.last(), //
+                 AsyncImageRenderCallback::InterlacingState::Final);
+        for (int i = 0; i < myMockup.deliveredStates.count() - 1; ++i) {
+            QCOMPARE(myMockup.deliveredStates.at(i), //
+                     AsyncImageRenderCallback::InterlacingState::Intermediate);
+        }
+        // Also intermediate results are cut off to the wheel.
+        for (const QImage &image : std::as_const(myMockup.deliveredImages)) {
+            QCOMPARE(image.size(), QSize(100, 100));
+            QCOMPARE(image.pixelColor(0, 0).alpha(), 0);
+            QCOMPARE(image.pixelColor(50, 50).alpha(), 0);
+        }
+    }
+
+    void testAbort()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 100;
+        test.wheelThicknessPhysical = 10;
+        Mockup myMockup;
+        myMockup.abort = true;
+        ColorWheelImageParameters::render(QVariant::fromValue(test), myMockup);
+        QCOMPARE(myMockup.deliveredImages.count(), 0);
+    }
+
+    void testSharedCache()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 80;
+        test.wheelThicknessPhysical = 10;
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 0);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheSizeInBytes(), static_cast<qsizetype>(0));
+        QImage firstImage = renderImage(test);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 1);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheSizeInBytes(), //
+                 static_cast<qsizetype>(firstImage.sizeInBytes()));
+        // Identical parameters deliver the shared image immediately.
+        Mockup myMockup;
+        ColorWheelImageParameters::render(QVariant::fromValue(test), myMockup);
+        QCOMPARE(myMockup.deliveredImages.count(), 1);
+        QCOMPARE(myMockup.deliveredStates.at(0), //
+                 AsyncImageRenderCallback::InterlacingState::Final);
+        QCOMPARE(myMockup.deliveredImages.at(0).cacheKey(), firstImage.cacheKey());
+        QCOMPARE(myMockup.deliveredImages.at(0), firstImage);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 1);
+        // Different parameters
+        test.borderPhysical = 2;
+        QImage secondImage = renderImage(test);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 2);
+        // Images that are not used anymore are removed from the cache.
+        firstImage = QImage();
+        myMockup.deliveredImages.clear();
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 1);
+        secondImage = QImage();
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 0);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheSizeInBytes(), static_cast<qsizetype>(0));
+    }
+
+    void testSharedCacheDoesNotKeepColorSpace()
+    {
+        QSharedPointer<RgbColorSpace> myColorSpace = RgbColorSpaceFactory::createSrgb();
+        const QWeakPointer<RgbColorSpace> weakColorSpace = myColorSpace.toWeakRef();
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = myColorSpace;
+        test.imageSizePhysical = 80;
+        test.wheelThicknessPhysical = 10;
+        // The image is still used, but its color space is destroyed.
+        QImage image = renderImage(test);
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 1);
+        test.rgbColorSpace.reset();
+        myColorSpace.reset();
+        QVERIFY(weakColorSpace.isNull());
+        QCOMPARE(ColorWheelImageParameters::sharedCacheCount(), 0);
+        image = QImage();
+    }
+
+    void testInvalidVariant()
+    {
+        Mockup myMockup;
+        ColorWheelImageParameters::render(QVariant(), myMockup);
+        QCOMPARE(myMockup.deliveredImages.count(), 0);
+    }
+
+    void testCornerCases()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 50; // Set a non-zero image size
+        QVERIFY2(!renderImage(test).isNull(),
+                 "Verify that there is no crash and the returned image is not "
+                 "null.");
+        const QList<qreal> values{10, 25, 100, 5, -5};
+        for (const qreal border : values) {
+            test.borderPhysical = border;
+            QVERIFY2(!renderImage(test).isNull(),
+                     "Verify that there is no crash and the returned image is "
+                     "not null.");
+        }
+        for (const qreal thickness : values) {
+            test.wheelThicknessPhysical = thickness;
+            QVERIFY2(!renderImage(test).isNull(),
+                     "Verify that there is no crash and the returned image is "
+                     "not null.");
+        }
+    }
+
+    void testVeryThickWheel()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 51; // Set a non-zero image size
+        test.wheelThicknessPhysical = 100;
+        // The wheel is so thick that even in the middle, there should be
+        // a fully opaque pixel.
+        QCOMPARE(renderImage(test).pixelColor(25, 25).alpha(), 255);
+    }
+
+    void testVeryBigBorder()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        const int myImageSize = 51;
+        test.imageSizePhysical = myImageSize; // Set a non-zero image size
+        test.wheelThicknessPhysical = 5;
+        // Set a border that is bigger than half of the image size
+        test.borderPhysical = myImageSize / 2 + 1;
+        // The border is so big that the hole image should be transparent.
+        const QImage image = renderImage(test);
+        for (int x = 0; x < myImageSize; ++x) {
+            for (int y = 0; y < myImageSize; ++y) {
+                QCOMPARE(image.pixelColor(x, y).alpha(), 0);
+            }
+        }
+    }
+
+    void testDevicePixelRatioFForExtremeCases()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        // Testing with a (non-integer) scale factor
+        test.devicePixelRatioF = 1.5;
+        // Test with fully transparent image (here, the border is too big
+        // for the given image size)
+        test.imageSizePhysical = 20;
+        test.borderPhysical = 30;
+        QCOMPARE(renderImage(test).devicePixelRatio(), 1.5);
+    }
+
+    void testColors()
+    {
+        // Pixels in the middle of the wheel have the color of their hue.
+        // The hue table might shift the hue by less than a pixel, which
+        // changes the color only a little.
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        constexpr int imageSize = 201;
+        constexpr int wheelThickness = 20;
+        test.imageSizePhysical = imageSize;
+        test.wheelThicknessPhysical = wheelThickness;
+        const QImage image = renderImage(test);
+        const qreal center = (imageSize - 1) / 2.;
+        const qreal radius = center - wheelThickness / 2.;
+        for (int hue = 0; hue < 360; hue += 15) {
+            const int x = qRound(center + radius * qCos(qDegreesToRadians(static_cast<qreal>(hue))));
+            const int y = qRound(center - radius * qSin(qDegreesToRadians(static_cast<qreal>(hue))));
+            const QColor actual = image.pixelColor(x, y);
+            const qreal pixelHue = qRadiansToDegrees(qAtan2(center - y, x - center));
+            const LchDouble lch{CielchD50Values::neutralLightness, //
+                                CielchD50Values::srgbVersatileChroma,
+                                pixelHue < 0 ? pixelHue + 360 : pixelHue};
+            const QColor expected = colorSpace->fromCielchD50ToQRgbBound(lch);
+            QCOMPARE(actual.alpha(), 255);
+            QVERIFY(qAbs(actual.red() - expected.red()) <= 3);
+            QVERIFY(qAbs(actual.green() - expected.green()) <= 3);
+            QVERIFY(qAbs(actual.blue() - expected.blue()) <= 3);
+        }
+    }
+
+    void benchmarkRender()
+    {
+        ColorWheelImageParameters test;
+        test.rgbColorSpace = colorSpace;
+        test.imageSizePhysical = 1000;
+        test.wheelThicknessPhysical = 50;
+        QBENCHMARK {
+            Q_UNUSED(renderImage(test))
+        }
+    }
+
+    void testSnippet01()
+    {
+        TestColorWheelSnippetClass mySnippets;
+        mySnippets.testSnippet01();
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestColorWheelImageParameters)
+
+// The following “include” is necessary because we do not use a header file:
+#include "testcolorwheelimageparameters.moc"
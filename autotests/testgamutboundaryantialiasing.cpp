@@ -0,0 +1,287 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "gamutboundaryantialiasing.h"
+
+#include "asyncimagerendercallback.h"
+#include "rgbcolorspace.h"
+#include "rgbcolorspacefactory.h"
+#include <lcms2.h>
+#include <qbitarray.h>
+#include <qglobal.h>
+#include <qimage.h>
+#include <qobject.h>
+#include <qrgb.h>
+#include <qsharedpointer.h>
+#include <qtest.h>
+#include <qtestcase.h>
+#include <qvariant.h>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+namespace
+{
+
+/** @brief Size of the test image. */
+constexpr int imageSize = 60;
+
+/** @brief A chroma-hue plane at lightness 50 with a chroma of 150 at
+ * the border of the image, so that the gamut boundary is within the
+ * image. */
+cmsCIELab testCielabD50(const double x, const double y)
+{
+    constexpr double chromaPerPixel = 2 * 150.0 / imageSize;
+    return cmsCIELab{50, //
+                     (x - imageSize / 2.0) * chromaPerPixel,
+                     (imageSize / 2.0 - y) * chromaPerPixel};
+}
+
+} // namespace
+
+namespace PerceptualColor
+{
+
+class Mockup : public AsyncImageRenderCallback
+{
+public:
+    virtual bool shouldAbort() const override;
+    virtual void deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state) override;
+    bool abort = false;
+};
+
+bool Mockup::shouldAbort() const
+{
+    return abort;
+}
+
+void Mockup::deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state)
+{
+    Q_UNUSED(image)
+    Q_UNUSED(parameters)
+    Q_UNUSED(state)
+}
+
+class TestGamutBoundaryAntialiasing : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestGamutBoundaryAntialiasing(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private:
+    QSharedPointer<PerceptualColor::RgbColorSpace> m_rgbColorSpace = RgbColorSpaceFactory::createSrgb();
+
+    /** @brief Renders the test image with one sample per pixel.
+     *
+     * @param mask Receives the gamut membership of each pixel.
+     *
+     * @returns The image, with transparent out-of-gamut pixels. */
+    QImage renderAliased(QBitArray &mask) const
+    {
+        QImage image(imageSize, imageSize, QImage::Format_ARGB32_Premultiplied);
+        mask = QBitArray(imageSize * imageSize, false);
+        for (int y = 0; y < imageSize; ++y) {
+            for (int x = 0; x < imageSize; ++x) {
+                const QRgb color = m_rgbColorSpace->fromCielabD50ToQRgbOrTransparent( //
+                    testCielabD50(x + 0.5, y + 0.5));
+                image.setPixel(x, y, color);
+                mask.setBit(x + y * imageSize, qAlpha(color) != 0);
+            }
+        }
+        return image;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testOnlyEdgePixelsChange()
+    {
+        QBitArray mask;
+        const QImage aliasedImage = renderAliased(mask);
+        QImage image = aliasedImage;
+        Mockup myMockup;
+        GamutBoundaryAntialiasing::Statistics statistics;
+        const bool completed = GamutBoundaryAntialiasing::apply( //
+            image,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            qRgba(0, 0, 0, 0),
+            GamutBoundaryAntialiasing::Pixels::All,
+            1,
+            myMockup,
+            &statistics);
+        QVERIFY(completed);
+
+        // Neighbors outside the image never differ.
+        const auto differs = [&](const int x, const int y, const bool center) {
+            const bool isWithinImage = //
+                (x >= 0) && (y >= 0) && (x < imageSize) && (y < imageSize);
+            return isWithinImage && (mask.testBit(x + y * imageSize) != center);
+        };
+        qint64 edgePixels = 0;
+        for (int y = 0; y < imageSize; ++y) {
+            for (int x = 0; x < imageSize; ++x) {
+                const bool center = mask.testBit(x + y * imageSize);
+                const bool isEdge = differs(x - 1, y, center) //
+                    || differs(x + 1, y, center) //
+                    || differs(x, y - 1, center) //
+                    || differs(x, y + 1, center);
+                if (isEdge) {
+                    ++edgePixels;
+                } else {
+                    QCOMPARE(image.pixel(x, y), aliasedImage.pixel(x, y));
+                }
+            }
+        }
+        QVERIFY(edgePixels > 0);
+        QVERIFY(edgePixels < imageSize * imageSize / 4);
+        QCOMPARE(statistics.edgePixels, edgePixels);
+        QCOMPARE(statistics.subsamples,
+                 edgePixels //
+                     * GamutBoundaryAntialiasing::subsamplesPerAxis //
+                     * GamutBoundaryAntialiasing::subsamplesPerAxis);
+        QVERIFY(image != aliasedImage);
+    }
+
+    void testInGamutOnly()
+    {
+        QBitArray mask;
+        const QImage aliasedImage = renderAliased(mask);
+        QImage image = aliasedImage;
+        Mockup myMockup;
+        const bool completed = GamutBoundaryAntialiasing::apply( //
+            image,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            qRgba(0, 0, 0, 0),
+            GamutBoundaryAntialiasing::Pixels::InGamutOnly,
+            1,
+            myMockup,
+            nullptr);
+        QVERIFY(completed);
+        // The alpha channel still tells the gamut membership.
+        for (int y = 0; y < imageSize; ++y) {
+            for (int x = 0; x < imageSize; ++x) {
+                QCOMPARE(qAlpha(image.pixel(x, y)) != 0, //
+                         mask.testBit(x + y * imageSize));
+            }
+        }
+        QVERIFY(image != aliasedImage);
+    }
+
+    void testOpaqueBackground()
+    {
+        QBitArray mask;
+        QImage image = renderAliased(mask);
+        const QRgb background = qRgb(128, 128, 128);
+        for (int y = 0; y < imageSize; ++y) {
+            for (int x = 0; x < imageSize; ++x) {
+                if (!mask.testBit(x + y * imageSize)) {
+                    image.setPixel(x, y, background);
+                }
+            }
+        }
+        Mockup myMockup;
+        const bool completed = GamutBoundaryAntialiasing::apply( //
+            image,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            background,
+            GamutBoundaryAntialiasing::Pixels::All,
+            1,
+            myMockup,
+            nullptr);
+        QVERIFY(completed);
+        for (int y = 0; y < imageSize; ++y) {
+            for (int x = 0; x < imageSize; ++x) {
+                QCOMPARE(qAlpha(image.pixel(x, y)), 255);
+            }
+        }
+    }
+
+    void testThreadCountDoesNotChangeImage()
+    {
+        QBitArray mask;
+        const QImage aliasedImage = renderAliased(mask);
+        Mockup myMockup;
+        QImage singleThreadImage = aliasedImage;
+        QVERIFY(GamutBoundaryAntialiasing::apply( //
+            singleThreadImage,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            qRgba(0, 0, 0, 0),
+            GamutBoundaryAntialiasing::Pixels::All,
+            1,
+            myMockup,
+            nullptr));
+        QImage multiThreadImage = aliasedImage;
+        QVERIFY(GamutBoundaryAntialiasing::apply( //
+            multiThreadImage,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            qRgba(0, 0, 0, 0),
+            GamutBoundaryAntialiasing::Pixels::All,
+            8,
+            myMockup,
+            nullptr));
+        QCOMPARE(multiThreadImage, singleThreadImage);
+    }
+
+    void testAbort()
+    {
+        QBitArray mask;
+        QImage image = renderAliased(mask);
+        Mockup myMockup;
+        myMockup.abort = true;
+        GamutBoundaryAntialiasing::Statistics statistics;
+        const bool completed = GamutBoundaryAntialiasing::apply( //
+            image,
+            mask,
+            *m_rgbColorSpace,
+            &testCielabD50,
+            qRgba(0, 0, 0, 0),
+            GamutBoundaryAntialiasing::Pixels::All,
+            1,
+            myMockup,
+            &statistics);
+        QVERIFY(!completed);
+        QCOMPARE(statistics.edgePixels, static_cast<qint64>(0));
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestGamutBoundaryAntialiasing)
+// The following “include” is necessary because we do not use a header file:
+#include "testgamutboundaryantialiasing.moc"
@@ -0,0 +1,150 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "gamutoccupancygrid.h"
+
+#include <atomic>
+#include <lcms2.h>
+#include <qglobal.h>
+#include <qnumeric.h>
+#include <qobject.h>
+#include <qtest.h>
+#include <qtestcase.h>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+namespace
+{
+
+/** @brief A test gamut: A sphere with radius 30 around Lab(50, 0, 0). */
+void sphereTest(const cmsCIELab *lab, bool *result, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double l = lab[i].L - 50;
+        result[i] = (l * l + lab[i].a * lab[i].a + lab[i].b * lab[i].b) <= 30 * 30;
+    }
+}
+
+/** @brief The result of @ref sphereTest for a single color. */
+bool isInSphere(const cmsCIELab &lab)
+{
+    bool result = false;
+    sphereTest(&lab, &result, 1);
+    return result;
+}
+
+} // namespace
+
+namespace PerceptualColor
+{
+class TestGamutOccupancyGrid : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestGamutOccupancyGrid(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testOccupancy()
+    {
+        const GamutOccupancyGrid grid(&sphereTest, 40, 2);
+        QVERIFY(grid.isValid());
+        QCOMPARE(grid.cellSize(), 2.);
+        QVERIFY(grid.occupancy(cmsCIELab{50, 0, 0}) == GamutOccupancyGrid::Occupancy::Inside);
+        QVERIFY(grid.occupancy(cmsCIELab{95, 35, 35}) == GamutOccupancyGrid::Occupancy::Outside);
+        QVERIFY(grid.occupancy(cmsCIELab{50, 30, 0}) == GamutOccupancyGrid::Occupancy::Boundary);
+        // Outside of the area covered by the grid
+        QVERIFY(grid.occupancy(cmsCIELab{-1, 0, 0}) == GamutOccupancyGrid::Occupancy::Boundary);
+        QVERIFY(grid.occupancy(cmsCIELab{50, 100, 0}) == GamutOccupancyGrid::Occupancy::Boundary);
+        QVERIFY(grid.occupancy(cmsCIELab{qQNaN(), 0, 0}) == GamutOccupancyGrid::Occupancy::Boundary);
+    }
+
+    void testConsistency()
+    {
+        const GamutOccupancyGrid grid(&sphereTest, 40, 2);
+        for (double l = 0; l <= 100; l += 0.7) {
+            for (double a = -40; a <= 40; a += 0.7) {
+                for (double b = -40; b <= 40; b += 3.1) {
+                    const cmsCIELab color{l, a, b};
+                    const auto occupancy = grid.occupancy(color);
+                    if (occupancy == GamutOccupancyGrid::Occupancy::Inside) {
+                        QVERIFY(isInSphere(color));
+                    }
+                    if (occupancy == GamutOccupancyGrid::Occupancy::Outside) {
+                        QVERIFY(!isInSphere(color));
+                    }
+                }
+            }
+        }
+    }
+
+    void testSizeInBytes()
+    {
+        const GamutOccupancyGrid grid(&sphereTest, 40, 2);
+        // 51 × 41 × 41 samples, with one bit for the sample
+        // and one bit for the cell.
+        const qsizetype words = (51 * 41 * 41 + 63) / 64;
+        QCOMPARE(grid.sizeInBytes(), static_cast<qsizetype>(2 * words * 8));
+    }
+
+    void testAbort()
+    {
+        const std::atomic<bool> abortFlag{true};
+        const GamutOccupancyGrid grid(&sphereTest, 40, 2, &abortFlag);
+        QVERIFY(!grid.isValid());
+        QVERIFY(grid.occupancy(cmsCIELab{50, 0, 0}) == GamutOccupancyGrid::Occupancy::Boundary);
+    }
+
+    void testAbortDuringBuild()
+    {
+        // The abort request is checked before each row of samples.
+        std::atomic<bool> abortFlag{false};
+        int calls = 0;
+        qsizetype maximumCount = 0;
+        const auto test = [&](const cmsCIELab *lab, bool *result, const qsizetype count) {
+            ++calls;
+            maximumCount = qMax(maximumCount, count);
+            sphereTest(lab, result, count);
+            abortFlag.store(true);
+        };
+        const GamutOccupancyGrid grid(test, 40, 2, &abortFlag);
+        QVERIFY(!grid.isValid());
+        QCOMPARE(calls, 1);
+        // 41 samples on the b axis
+        QCOMPARE(maximumCount, static_cast<qsizetype>(41));
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestGamutOccupancyGrid)
+// The following “include” is necessary because we do not use a header file:
+#include "testgamutoccupancygrid.moc"
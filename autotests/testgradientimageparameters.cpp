@@ -5,17 +5,28 @@
 // this forces the header to be self-contained.
 #include "gradientimageparameters.h"
 
+#include "asyncimagerendercallback.h"
 #include "asyncimagerenderthread.h"
 #include "lchadouble.h"
+#include "lchdouble.h"
+#include "rgbcolorspace.h"
 #include "rgbcolorspacefactory.h"
+#include <cstddef>
+#include <qbenchmark.h>
+#include <qcolor.h>
 #include <qglobal.h>
+#include <qimage.h>
 #include <qobject.h>
+#include <qrgb.h>
 #include <qscopedpointer.h>
 #include <qsharedpointer.h>
+#include <qsize.h>
 #include <qtest.h>
 #include <qtestcase.h>
+#include <qtestdata.h>
 #include <qvariant.h>
 #include <qwidget.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -72,6 +83,26 @@ namespace PerceptualColor
 {
 class RgbColorSpace;
 
+class Mockup : public AsyncImageRenderCallback
+{
+public:
+    virtual bool shouldAbort() const override;
+    virtual void deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state) override;
+    QImage lastDeliveredImage;
+};
+
+bool Mockup::shouldAbort() const
+{
+    return false;
+}
+
+void Mockup::deliverInterlacingPass(const QImage &image, const QVariant &parameters, const InterlacingState state)
+{
+    Q_UNUSED(parameters)
+    Q_UNUSED(state)
+    lastDeliveredImage = image;
+}
+
 class TestGradientImageParameters : public QObject
 {
     Q_OBJECT
@@ -238,6 +269,191 @@ private Q_SLOTS:
         myGradient.setGradientThickness(10);
     }
 
+    void testKernel()
+    {
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(LchaDouble{50, 20, 30, 0});
+        myGradient.setSecondColor(LchaDouble{50, 20, 30, 1});
+        QVERIFY(myGradient.kernel() == GradientImageParameters::Kernel::Constant);
+        myGradient.setSecondColor(LchaDouble{80, 20, 30, 1});
+        QVERIFY(myGradient.kernel() == GradientImageParameters::Kernel::SingleChannel);
+        myGradient.setSecondColor(LchaDouble{50, 20, 90, 1});
+        QVERIFY(myGradient.kernel() == GradientImageParameters::Kernel::SingleChannel);
+        myGradient.setSecondColor(LchaDouble{80, 20, 90, 1});
+        QVERIFY(myGradient.kernel() == GradientImageParameters::Kernel::General);
+    }
+
+    void testColorLine_data()
+    {
+        QTest::addColumn<LchaDouble>("firstColor");
+        QTest::addColumn<LchaDouble>("secondColor");
+        QTest::addColumn<int>("length");
+        QTest::newRow("alpha") << LchaDouble{50, 30, 120, 0} << LchaDouble{50, 30, 120, 1} << 500;
+        QTest::newRow("lightness") << LchaDouble{0, 30, 120, 1} << LchaDouble{100, 30, 120, 1} << 500;
+        QTest::newRow("lightness short") << LchaDouble{0, 30, 120, 1} << LchaDouble{100, 30, 120, 1} << 50;
+        QTest::newRow("chroma out-of-gamut") << LchaDouble{50, 0, 250, 1} << LchaDouble{50, 150, 250, 1} << 1000;
+        QTest::newRow("hue") << LchaDouble{50, 30, 0, 1} << LchaDouble{50, 30, 180, 1} << 1000;
+        QTest::newRow("hue out-of-gamut") << LchaDouble{70, 90, 0, 1} << LchaDouble{70, 90, 180, 1} << 2000;
+        QTest::newRow("general") << LchaDouble{10, 0, 0, 1} << LchaDouble{90, 60, 150, 1} << 500;
+    }
+
+    void testColorLine()
+    {
+        // All kernels give (nearly) the same result as the general kernel.
+        QFETCH(LchaDouble, firstColor);
+        QFETCH(LchaDouble, secondColor);
+        QFETCH(int, length);
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(firstColor);
+        myGradient.setSecondColor(secondColor);
+        myGradient.setGradientLength(length);
+        const std::vector<QRgb> actual = //
+            myGradient.colorLine(myGradient.kernel());
+        const std::vector<QRgb> expected = //
+            myGradient.colorLine(GradientImageParameters::Kernel::General);
+        QCOMPARE(actual.size(), static_cast<std::size_t>(length));
+        QCOMPARE(expected.size(), static_cast<std::size_t>(length));
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            QVERIFY(qAbs(qRed(actual.at(i)) - qRed(expected.at(i))) <= 3);
+            QVERIFY(qAbs(qGreen(actual.at(i)) - qGreen(expected.at(i))) <= 3);
+            QVERIFY(qAbs(qBlue(actual.at(i)) - qBlue(expected.at(i))) <= 3);
+            QCOMPARE(qAlpha(actual.at(i)), 255);
+        }
+        // Both ends are converted exactly.
+        QCOMPARE(actual.front(), expected.front());
+        QCOMPARE(actual.back(), expected.back());
+    }
+
+    void testRenderAlpha()
+    {
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(LchaDouble{50, 30, 120, 0});
+        myGradient.setSecondColor(LchaDouble{50, 30, 120, 1});
+        myGradient.setGradientLength(100);
+        myGradient.setGradientThickness(1);
+        Mockup myMockup;
+        GradientImageParameters::render(QVariant::fromValue(myGradient), myMockup);
+        const QImage image = myMockup.lastDeliveredImage;
+        QCOMPARE(image.size(), QSize(100, 1));
+        // The last pixel is nearly opaque and has the color itself.
+        const QRgb expected = m_rgbColorSpace->fromCielchD50ToQRgbBound( //
+            LchDouble{50, 30, 120});
+        const QColor last = image.pixelColor(99, 0);
+        QVERIFY(last.alpha() >= 250);
+        QVERIFY(qAbs(last.red() - qRed(expected)) <= 1);
+        QVERIFY(qAbs(last.green() - qGreen(expected)) <= 1);
+        QVERIFY(qAbs(last.blue() - qBlue(expected)) <= 1);
+    }
+
+    void testColorLineImageCache()
+    {
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(LchaDouble{20, 30, 40, 0.5});
+        myGradient.setSecondColor(LchaDouble{80, 30, 40, 1});
+        myGradient.setGradientLength(300);
+        myGradient.setGradientThickness(10);
+        const QImage firstLine = GradientImageParameters::colorLineImage(myGradient);
+        QCOMPARE(firstLine.size(), QSize(300, 1));
+        // Thickness and device pixel ratio do not change the line, so the
+        // cached line is reused.
+        myGradient.setGradientThickness(25);
+        myGradient.setDevicePixelRatioF(1.5);
+        QCOMPARE(GradientImageParameters::colorLineImage(myGradient).cacheKey(), //
+                 firstLine.cacheKey());
+        // Other colors need a new line.
+        myGradient.setSecondColor(LchaDouble{90, 30, 40, 1});
+        QVERIFY(GradientImageParameters::colorLineImage(myGradient).cacheKey() //
+                != firstLine.cacheKey());
+    }
+
+    void testColorLineImageCacheDoesNotKeepColorSpace()
+    {
+        QSharedPointer<RgbColorSpace> colorSpace = RgbColorSpaceFactory::createSrgb();
+        const QWeakPointer<RgbColorSpace> weakColorSpace = colorSpace.toWeakRef();
+        {
+            GradientImageParameters myGradient;
+            myGradient.rgbColorSpace = colorSpace;
+            myGradient.setFirstColor(LchaDouble{20, 30, 40, 1});
+            myGradient.setSecondColor(LchaDouble{80, 30, 40, 1});
+            myGradient.setGradientLength(100);
+            Q_UNUSED(GradientImageParameters::colorLineImage(myGradient))
+        }
+        colorSpace.reset();
+        QVERIFY(weakColorSpace.isNull());
+    }
+
+    void testRenderBody()
+    {
+        // All rows of the body are identical.
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(LchaDouble{20, 30, 40, 1});
+        myGradient.setSecondColor(LchaDouble{80, 30, 40, 1});
+        myGradient.setGradientLength(50);
+        myGradient.setGradientThickness(7);
+        Mockup myMockup;
+        GradientImageParameters::render(QVariant::fromValue(myGradient), myMockup);
+        const QImage image = myMockup.lastDeliveredImage;
+        QCOMPARE(image.size(), QSize(50, 7));
+        const QImage line = GradientImageParameters::colorLineImage(myGradient);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                QCOMPARE(image.pixel(x, y), line.pixel(x, 0));
+            }
+        }
+    }
+
+    void benchmarkRender_data()
+    {
+        QTest::addColumn<LchaDouble>("firstColor");
+        QTest::addColumn<LchaDouble>("secondColor");
+        QTest::newRow("alpha") << LchaDouble{50, 30, 120, 0} << LchaDouble{50, 30, 120, 1};
+        QTest::newRow("lightness") << LchaDouble{0, 30, 120, 1} << LchaDouble{100, 30, 120, 1};
+        QTest::newRow("hue") << LchaDouble{50, 30, 0, 1} << LchaDouble{50, 30, 180, 1};
+        QTest::newRow("general") << LchaDouble{10, 0, 0, 1} << LchaDouble{90, 60, 150, 1};
+    }
+
+    void benchmarkRender()
+    {
+        QFETCH(LchaDouble, firstColor);
+        QFETCH(LchaDouble, secondColor);
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(firstColor);
+        myGradient.setSecondColor(secondColor);
+        // A long gradient, like on a HiDPI screen
+        myGradient.setGradientLength(2000);
+        myGradient.setGradientThickness(40);
+        Mockup myMockup;
+        QBENCHMARK {
+            GradientImageParameters::render(QVariant::fromValue(myGradient), myMockup);
+        }
+    }
+
+    void benchmarkColorLine_data()
+    {
+        benchmarkRender_data();
+    }
+
+    void benchmarkColorLine()
+    {
+        // Calculation of the colors without the line cache
+        QFETCH(LchaDouble, firstColor);
+        QFETCH(LchaDouble, secondColor);
+        GradientImageParameters myGradient;
+        myGradient.rgbColorSpace = m_rgbColorSpace;
+        myGradient.setFirstColor(firstColor);
+        myGradient.setSecondColor(secondColor);
+        myGradient.setGradientLength(2000);
+        QBENCHMARK {
+            Q_UNUSED(myGradient.colorLine(myGradient.kernel()))
+        }
+    }
+
     void testSnippet01()
     {
         TestGradientSnippetClass mySnippets;
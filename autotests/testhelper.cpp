@@ -5,6 +5,8 @@
 // this forces the header to be self-contained.
 #include "helper.h"
 
+#include <atomic>
+#include <cstddef>
 #include <qevent.h>
 #include <qglobal.h>
 #include <qimage.h>
@@ -19,6 +21,8 @@
 #include <qstringliteral.h>
 #include <qtest.h>
 #include <qtestcase.h>
+#include <qtestdata.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -135,6 +139,35 @@ private Q_SLOTS:
         QVERIFY2(temp.allGray(), "Image is neutral gray.");
     }
 
+    void testRunInParallel_data()
+    {
+        QTest::addColumn<int>("taskCount");
+        QTest::addColumn<int>("threadCount");
+        QTest::newRow("no tasks") << 0 << 4;
+        QTest::newRow("single thread") << 100 << 1;
+        QTest::newRow("ideal thread count") << 100 << 0;
+        QTest::newRow("more threads than tasks") << 3 << 8;
+        QTest::newRow("many tasks") << 10000 << 4;
+    }
+
+    void testRunInParallel()
+    {
+        QFETCH(int, taskCount);
+        QFETCH(int, threadCount);
+        std::vector<std::atomic<int>> calls(static_cast<std::size_t>(taskCount));
+        for (auto &call : calls) {
+            call = 0;
+        }
+        runInParallel(taskCount, threadCount, [&calls](const int index) {
+            ++calls.at(static_cast<std::size_t>(index));
+        });
+        // Each task has been executed exactly once, and all tasks are
+        // done when the function returns.
+        for (const auto &call : calls) {
+            QCOMPARE(call.load(), 1);
+        }
+    }
+
     void testStandardWheelSteps()
     {
         QWheelEvent temp( //
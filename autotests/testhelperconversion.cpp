@@ -5,18 +5,26 @@
 // this forces the header to be self-contained.
 #include "helperconversion.h"
 
+#include "colorbuffer.h"
+#include "helperconstants.h"
 #include "helpermath.h"
 #include "lchdouble.h"
+#include "rgbdouble.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <lcms2.h>
+#include <qcolor.h>
 #include <qgenericmatrix.h>
 #include <qglobal.h>
+#include <qmath.h>
 #include <qmetatype.h>
 #include <qobject.h>
+#include <qrgb.h>
 #include <qtest.h>
 #include <qtestcase.h>
 #include <qtestdata.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -41,6 +49,44 @@ public:
     }
 
 private:
+    // Reference implementation of the XYZ-D65 to Oklab conversion, based on
+    // QGenericMatrix. This is how the library did the conversion before the
+    // constexpr kernels were introduced. It is used to make sure that the
+    // new kernels give the same results, and as baseline for the benchmarks.
+    static Trio legacyFromXyzd65ToOklab(const Trio &value)
+    {
+        // clang-format off
+        const SquareMatrix3 m1 = createSquareMatrix3(
+            +0.8189330101, +0.3618667424, -0.1288597137,
+            +0.0329845436, +0.9293118715, +0.0361456387,
+            +0.0482003018, +0.2643662691, +0.6338517070);
+        const SquareMatrix3 m2 = createSquareMatrix3(
+            +0.2104542553, +0.7936177850, -0.0040720468,
+            +1.9779984951, -2.4285922050, +0.4505937099,
+            +0.0259040371, +0.7827717662, -0.8086757660);
+        // clang-format on
+        auto lms = m1 * value;
+        for (int i = 0; i < 3; ++i) {
+            lms(i, 0) = std::cbrt(lms(i, 0));
+        }
+        return m2 * lms;
+    }
+
+    // Some XYZ-D65 values that cover the typical value range (and go a
+    // little bit beyond it, including negative values).
+    static std::vector<Vector3> sampleXyzd65Values()
+    {
+        std::vector<Vector3> result;
+        for (int x = -2; x <= 12; ++x) {
+            for (int y = -2; y <= 12; ++y) {
+                for (int z = -2; z <= 12; ++z) {
+                    result.push_back(Vector3{x / 10.0, y / 10.0, z / 10.0});
+                }
+            }
+        }
+        return result;
+    }
+
     void generateDataXyzd65Oklab()
     {
         qRegisterMetaType<Trio>();
@@ -334,6 +380,378 @@ private Q_SLOTS:
         QVERIFY(isNearlyEqual(actualCmscielabd50.a, cmscielab.a, epsilon));
         QVERIFY(isNearlyEqual(actualCmscielabd50.b, cmscielab.b, epsilon));
     }
+    void testConstexprMatrixInverse()
+    {
+        // The inverse matrices are calculated at compile time. Check that
+        // they are actually the inverse of the original matrices.
+        const std::array<Matrix3, 3> identities{
+            multiplyMatrix3(oklabM1, oklabM1Inverse),
+            multiplyMatrix3(oklabM2, oklabM2Inverse),
+            multiplyMatrix3(xyzD65ToXyzD50, xyzD50ToXyzD65)};
+        for (const Matrix3 &identity : identities) {
+            for (std::size_t row = 0; row < 3; ++row) {
+                for (std::size_t column = 0; column < 3; ++column) {
+                    const double expected = (row == column) ? 1 : 0;
+                    QVERIFY(isNearlyEqual(identity[row][column], expected, 1e-12));
+                }
+            }
+        }
+    }
+
+    void testFromXyzd65ToOklabMatchesLegacy()
+    {
+        const auto samples = sampleXyzd65Values();
+        for (const Vector3 &sample : samples) {
+            const auto legacy = legacyFromXyzd65ToOklab(Trio(sample.data()));
+            const auto actual = fromXyzd65ToOklab(sample);
+            QVERIFY(isNearlyEqual(actual[0], legacy(0, 0), 1e-12));
+            QVERIFY(isNearlyEqual(actual[1], legacy(1, 0), 1e-12));
+            QVERIFY(isNearlyEqual(actual[2], legacy(2, 0), 1e-12));
+        }
+    }
+
+    void testBatchConversionMatchesScalar()
+    {
+        // The batch conversion uses the instruction set specific code
+        // paths of colorKernels(), which might use fused multiply-add.
+        // Therefore, the results are not necessarily bit-identical.
+        const auto samples = sampleXyzd65Values();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        std::vector<double> z(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            x[i] = samples[i][0];
+            y[i] = samples[i][1];
+            z[i] = samples[i][2];
+        }
+        std::vector<double> l(samples.size());
+        std::vector<double> a(samples.size());
+        std::vector<double> b(samples.size());
+        fromXyzd65ToOklab(x.data(), y.data(), z.data(), l.data(), a.data(), b.data(), count);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const auto expected = fromXyzd65ToOklab(samples[i]);
+            QVERIFY(isNearlyEqual(l[i], expected[0], 1e-12));
+            QVERIFY(isNearlyEqual(a[i], expected[1], 1e-12));
+            QVERIFY(isNearlyEqual(b[i], expected[2], 1e-12));
+        }
+        // In-place back-conversion
+        fromOklabToXyzd65(l.data(), a.data(), b.data(), l.data(), a.data(), b.data(), count);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const auto expected = fromOklabToXyzd65(fromXyzd65ToOklab(samples[i]));
+            QVERIFY(isNearlyEqual(l[i], expected[0], 1e-12));
+            QVERIFY(isNearlyEqual(a[i], expected[1], 1e-12));
+            QVERIFY(isNearlyEqual(b[i], expected[2], 1e-12));
+            // Round-trip
+            QVERIFY(isNearlyEqual(l[i], samples[i][0], 1e-9));
+            QVERIFY(isNearlyEqual(a[i], samples[i][1], 1e-9));
+            QVERIFY(isNearlyEqual(b[i], samples[i][2], 1e-9));
+        }
+    }
+
+    void benchmarkFromXyzd65ToOklabLegacy()
+    {
+        const auto samples = sampleXyzd65Values();
+        std::vector<Trio> trios;
+        for (const Vector3 &sample : samples) {
+            trios.push_back(Trio(sample.data()));
+        }
+        double sum = 0;
+        QBENCHMARK {
+            for (const Trio &trio : trios) {
+                sum += legacyFromXyzd65ToOklab(trio)(0, 0);
+            }
+        }
+        Q_UNUSED(sum)
+    }
+
+    void benchmarkFromXyzd65ToOklabScalar()
+    {
+        const auto samples = sampleXyzd65Values();
+        double sum = 0;
+        QBENCHMARK {
+            for (const Vector3 &sample : samples) {
+                sum += fromXyzd65ToOklab(sample)[0];
+            }
+        }
+        Q_UNUSED(sum)
+    }
+
+    void benchmarkFromXyzd65ToOklabBatch()
+    {
+        const auto samples = sampleXyzd65Values();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        std::vector<double> z(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            x[i] = samples[i][0];
+            y[i] = samples[i][1];
+            z[i] = samples[i][2];
+        }
+        std::vector<double> l(samples.size());
+        std::vector<double> a(samples.size());
+        std::vector<double> b(samples.size());
+        QBENCHMARK {
+            fromXyzd65ToOklab(x.data(), y.data(), z.data(), l.data(), a.data(), b.data(), count);
+        }
+    }
+
+    void testFastPrecisionBelowDeviationLimit()
+    {
+        // The Oklab deviation limit of the gamut detection
+        constexpr double oklabDeviationLimit = 0.001;
+        const auto samples = sampleXyzd65Values();
+        double maximumDeviation = 0;
+        for (const Vector3 &sample : samples) {
+            const auto precise = fromXyzd65ToOklab(sample);
+            const auto fast = fromXyzd65ToOklab(sample, ConversionPrecision::Fast);
+            for (std::size_t i = 0; i < 3; ++i) {
+                maximumDeviation = qMax(maximumDeviation, std::abs(fast[i] - precise[i]));
+            }
+        }
+        // Documented bound: 2 × 10⁻⁵
+        QVERIFY(maximumDeviation < 2e-5);
+        QVERIFY(maximumDeviation < oklabDeviationLimit);
+
+        // Also the batch version
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        std::vector<double> z(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            x[i] = samples[i][0];
+            y[i] = samples[i][1];
+            z[i] = samples[i][2];
+        }
+        fromXyzd65ToOklab(x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), count, ConversionPrecision::Fast);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const auto expected = fromXyzd65ToOklab(samples[i], ConversionPrecision::Fast);
+            QVERIFY(isNearlyEqual(x[i], expected[0], 1e-12));
+            QVERIFY(isNearlyEqual(y[i], expected[1], 1e-12));
+            QVERIFY(isNearlyEqual(z[i], expected[2], 1e-12));
+        }
+    }
+
+    void benchmarkFromXyzd65ToOklabBatchFast()
+    {
+        const auto samples = sampleXyzd65Values();
+        const auto count = static_cast<qsizetype>(samples.size());
+        std::vector<double> x(samples.size());
+        std::vector<double> y(samples.size());
+        std::vector<double> z(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            x[i] = samples[i][0];
+            y[i] = samples[i][1];
+            z[i] = samples[i][2];
+        }
+        std::vector<double> l(samples.size());
+        std::vector<double> a(samples.size());
+        std::vector<double> b(samples.size());
+        QBENCHMARK {
+            fromXyzd65ToOklab(x.data(), y.data(), z.data(), l.data(), a.data(), b.data(), count, ConversionPrecision::Fast);
+        }
+    }
+
+    void testFromLchToLabBatch()
+    {
+        std::vector<double> l;
+        std::vector<double> c;
+        std::vector<double> h;
+        for (int chroma = 0; chroma <= 250; chroma += 10) {
+            for (int hue = -3600; hue <= 7200; hue += 13) {
+                l.push_back(chroma / 2.5);
+                c.push_back(chroma);
+                h.push_back(hue / 10.);
+            }
+        }
+        const auto count = static_cast<qsizetype>(l.size());
+        std::vector<double> labL(l.size());
+        std::vector<double> labA(l.size());
+        std::vector<double> labB(l.size());
+        fromLchToLab(l.data(), c.data(), h.data(), labL.data(), labA.data(), labB.data(), count);
+        double maximumDeviation = 0;
+        for (std::size_t i = 0; i < l.size(); ++i) {
+            const cmsCIELab expected = toCmsLab(cmsCIELCh{l[i], c[i], h[i]});
+            QCOMPARE(labL[i], expected.L);
+            maximumDeviation = qMax(maximumDeviation, std::abs(labA[i] - expected.a));
+            maximumDeviation = qMax(maximumDeviation, std::abs(labB[i] - expected.b));
+        }
+        // The error must be far below the precision that is used for
+        // gamut detection.
+        QVERIFY(maximumDeviation < gamutPrecisionCielab / 1000000);
+
+        // In-place
+        fromLchToLab(l.data(), c.data(), h.data(), l.data(), c.data(), h.data(), count);
+        QVERIFY(l == labL);
+        QVERIFY(c == labA);
+        QVERIFY(h == labB);
+    }
+
+    void testFromLabToLchBatch()
+    {
+        std::vector<double> l;
+        std::vector<double> a;
+        std::vector<double> b;
+        for (int aValue = -150; aValue <= 150; aValue += 3) {
+            for (int bValue = -150; bValue <= 150; bValue += 3) {
+                l.push_back(50);
+                a.push_back(aValue / 1.1);
+                b.push_back(bValue / 1.1);
+            }
+        }
+        const auto count = static_cast<qsizetype>(l.size());
+        std::vector<double> lchL(l.size());
+        std::vector<double> lchC(l.size());
+        std::vector<double> lchH(l.size());
+        fromLabToLch(l.data(), a.data(), b.data(), lchL.data(), lchC.data(), lchH.data(), count);
+        for (std::size_t i = 0; i < l.size(); ++i) {
+            const cmsCIELab lab{l[i], a[i], b[i]};
+            cmsCIELCh expected;
+            cmsLab2LCh(&expected, &lab);
+            QCOMPARE(lchL[i], expected.L);
+            QVERIFY(isNearlyEqual(lchC[i], expected.C, 1e-12));
+            double hueDeviation = std::abs(lchH[i] - expected.h);
+            // 0° and 360° are the same hue.
+            hueDeviation = qMin(hueDeviation, std::abs(hueDeviation - 360));
+            QVERIFY(hueDeviation <= fastAtan2MaximumErrorDegree);
+            // The resulting position in the Lab plane is far below the
+            // precision that is used for gamut detection.
+            QVERIFY(qDegreesToRadians(hueDeviation) * expected.C < gamutPrecisionCielab / 1000000);
+        }
+    }
+
+    void testFromLchToLabBuffer()
+    {
+        LchBuffer lch(1000);
+        for (qsizetype i = 0; i < lch.size(); ++i) {
+            lch.l()[i] = 50;
+            lch.c()[i] = static_cast<double>(i) / 10.;
+            lch.h()[i] = static_cast<double>(i) * 0.36;
+        }
+        LabBuffer lab;
+        fromLchToLab(lch, lab);
+        QCOMPARE(lab.size(), lch.size());
+        for (qsizetype i = 0; i < lch.size(); ++i) {
+            const auto expected = toCmsLab(cmsCIELCh{lch.l()[i], lch.c()[i], lch.h()[i]});
+            QCOMPARE(lab.l()[i], expected.L);
+            QVERIFY(std::abs(lab.a()[i] - expected.a) < gamutPrecisionCielab / 1000000);
+            QVERIFY(std::abs(lab.b()[i] - expected.b) < gamutPrecisionCielab / 1000000);
+        }
+
+        // And back
+        LchBuffer roundtrip;
+        fromLabToLch(lab, roundtrip);
+        QCOMPARE(roundtrip.size(), lch.size());
+        // Skip the first value: Its chroma is 0, so its hue is meaningless.
+        for (qsizetype i = 1; i < lch.size(); ++i) {
+            QCOMPARE(roundtrip.l()[i], lch.l()[i]);
+            QVERIFY(std::abs(roundtrip.c()[i] - lch.c()[i]) < gamutPrecisionCielab / 1000000);
+            QVERIFY(std::abs(roundtrip.h()[i] - lch.h()[i]) < gamutPrecisionCielab / 1000000);
+        }
+    }
+
+    void benchmarkFromLchToLabScalar()
+    {
+        std::vector<cmsCIELCh> input;
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(cmsCIELCh{50, i / 100., i * 0.036});
+        }
+        std::vector<cmsCIELab> output(input.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                output[i] = toCmsLab(input[i]);
+            }
+        }
+    }
+
+    void benchmarkFromLchToLabBatch()
+    {
+        std::vector<double> l(10000, 50);
+        std::vector<double> c;
+        std::vector<double> h;
+        for (int i = 0; i < 10000; ++i) {
+            c.push_back(i / 100.);
+            h.push_back(i * 0.036);
+        }
+        const auto count = static_cast<qsizetype>(l.size());
+        std::vector<double> labL(l.size());
+        std::vector<double> labA(l.size());
+        std::vector<double> labB(l.size());
+        QBENCHMARK {
+            fromLchToLab(l.data(), c.data(), h.data(), labL.data(), labA.data(), labB.data(), count);
+        }
+    }
+
+    void testFromDoubleToEightBitFixedPoint()
+    {
+        // Values that correspond exactly to an 8-bit value
+        for (quint32 i = 0; i <= 255; ++i) {
+            QCOMPARE(fromDoubleToEightBitFixedPoint(i / 255.), i);
+        }
+        // Out-of-range values are bound to the valid range.
+        QCOMPARE(fromDoubleToEightBitFixedPoint(-0.5), 0U);
+        QCOMPARE(fromDoubleToEightBitFixedPoint(1.5), 255U);
+        QCOMPARE(fromDoubleToEightBitFixedPoint(std::nan("")), 0U);
+        static_assert(fromDoubleToEightBitFixedPoint(1) == 255);
+    }
+
+    void testFromRgbDoubleToQRgb()
+    {
+        // Values that correspond exactly to an 8-bit value must give
+        // exactly the same result as QColor.
+        for (int i = 0; i <= 255; ++i) {
+            const double value = i / 255.;
+            const double otherValue = (255 - i) / 255.;
+            QCOMPARE(fromRgbDoubleToQRgb(value, otherValue, value), //
+                     qColorFromRgbDouble(value, otherValue, value).rgb());
+        }
+        // For arbitrary values, QColor might use float internally (depending
+        // on the Qt version), which can make a difference of 1 in rare cases.
+        for (int i = 0; i <= 10000; ++i) {
+            const double value = i / 10000.;
+            const QRgb actual = fromRgbDoubleToQRgb(value, value, value);
+            const QRgb expected = qColorFromRgbDouble(value, value, value).rgb();
+            QCOMPARE(qAlpha(actual), 255);
+            QVERIFY(qAbs(qRed(actual) - qRed(expected)) <= 1);
+            QVERIFY(qAbs(qGreen(actual) - qGreen(expected)) <= 1);
+            QVERIFY(qAbs(qBlue(actual) - qBlue(expected)) <= 1);
+        }
+    }
+
+    void benchmarkFromRgbDoubleToQRgbQColor()
+    {
+        // For comparison: The conversion by means of QColor
+        std::vector<RgbDouble> input;
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(RgbDouble{i / 10000., 0.5, 1 - i / 10000.});
+        }
+        std::vector<QRgb> output(input.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                output[i] = qColorFromRgbDouble(input[i].red, //
+                                                input[i].green,
+                                                input[i].blue)
+                                .rgb();
+            }
+        }
+    }
+
+    void benchmarkFromRgbDoubleToQRgb()
+    {
+        std::vector<RgbDouble> input;
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(RgbDouble{i / 10000., 0.5, 1 - i / 10000.});
+        }
+        std::vector<QRgb> output(input.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                output[i] = fromRgbDoubleToQRgb(input[i].red, //
+                                                input[i].green,
+                                                input[i].blue);
+            }
+        }
+    }
 };
 
 } // namespace PerceptualColor
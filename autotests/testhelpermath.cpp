@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <optional>
 #include <qgenericmatrix.h>
@@ -14,6 +16,7 @@
 #include <qobject.h>
 #include <qtest.h>
 #include <qtestcase.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qtmetamacros.h>
@@ -549,6 +552,238 @@ private Q_SLOTS:
         QCOMPARE(temp(1, 0), 5);
         QCOMPARE(temp(1, 1), 4);
     }
+    void testFastCubeRootExhaustive()
+    {
+        // The initial guess of fastCubeRoot() depends on the exponent,
+        // which is divided by 3. Therefore, the relative error is periodic
+        // with a period of a factor of 8 (2³). Testing all values of
+        // type float within [1, 8) is therefore an exhaustive test of the
+        // error behaviour. (Values of type double would be too many.)
+        float floatValue = 1;
+        std::uint32_t bits;
+        std::memcpy(&bits, &floatValue, sizeof(bits));
+        double maximumRelativeError = 0;
+        while (floatValue < 8) {
+            const double value = floatValue;
+            const double expected = std::cbrt(value);
+            const double relativeError = //
+                std::abs(fastCubeRoot(value) - expected) / expected;
+            maximumRelativeError = qMax(maximumRelativeError, relativeError);
+            ++bits;
+            std::memcpy(&floatValue, &bits, sizeof(floatValue));
+        }
+        QVERIFY(maximumRelativeError <= fastCubeRootMaximumRelativeError);
+    }
+
+    void testFastCubeRootPeriodicity()
+    {
+        // Check the assumption of testFastCubeRootExhaustive() that the
+        // relative error is periodic with a factor of 8.
+        const double samples[] = {1., 1.1, 2.345, 3.999, 7.5};
+        for (const double sample : samples) {
+            const double relativeError = //
+                std::abs(fastCubeRoot(sample) - std::cbrt(sample)) / std::cbrt(sample);
+            for (int exponent = -300; exponent <= 300; exponent += 3) {
+                const double scaled = std::ldexp(sample, exponent);
+                const double scaledExpected = std::cbrt(scaled);
+                const double scaledError = //
+                    std::abs(fastCubeRoot(scaled) - scaledExpected) / scaledExpected;
+                // Allow 1 % difference for rounding errors.
+                QVERIFY(std::abs(scaledError - relativeError) <= 0.01 * relativeError + 1e-15);
+            }
+        }
+    }
+
+    void testFastCubeRootSpecialValues()
+    {
+        QCOMPARE(fastCubeRoot(0.), 0.);
+        QVERIFY(std::signbit(fastCubeRoot(-0.)));
+        QVERIFY(isNearlyEqual(fastCubeRoot(27.), 3., 1e-5));
+        // Negative values
+        QVERIFY(isNearlyEqual(fastCubeRoot(-27.), -3., 1e-5));
+        QVERIFY(isNearlyEqual(fastCubeRoot(-0.125), -0.5, 1e-5));
+        // Other floating point types
+        QVERIFY(isNearlyEqual(fastCubeRoot(8.f), 2.f, 1e-5f));
+        // Infinity and NaN
+        const auto infinity = std::numeric_limits<double>::infinity();
+        QCOMPARE(fastCubeRoot(infinity), infinity);
+        QCOMPARE(fastCubeRoot(-infinity), -infinity);
+        QVERIFY(std::isnan(fastCubeRoot(std::numeric_limits<double>::quiet_NaN())));
+        // Subnormal values are flushed to zero.
+        const auto subnormal = std::numeric_limits<double>::denorm_min();
+        QCOMPARE(fastCubeRoot(subnormal), 0.);
+        // The smallest normal value is still supported.
+        const auto smallest = std::numeric_limits<double>::min();
+        QVERIFY(isNearlyEqual(fastCubeRoot(smallest), std::cbrt(smallest), 1e-5));
+    }
+
+    void testFastCubeRootBatch()
+    {
+        std::vector<double> input;
+        for (int i = -1000; i <= 1000; ++i) {
+            input.push_back(i / 37.);
+        }
+        std::vector<double> output(input.size());
+        fastCubeRoot(input.data(), output.data(), static_cast<qsizetype>(input.size()));
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            QCOMPARE(output[i], fastCubeRoot(input[i]));
+        }
+        // In-place
+        fastCubeRoot(input.data(), input.data(), static_cast<qsizetype>(input.size()));
+        QVERIFY(input == output);
+    }
+
+    void testFastExpAccuracy()
+    {
+        double maximumRelativeError = 0;
+        for (double value = -700; value <= 700; value += 0.00731) {
+            const long double expected = std::exp(static_cast<long double>(value));
+            const long double relativeError = //
+                std::abs((fastExp(value) - expected) / expected);
+            maximumRelativeError = qMax<double>(maximumRelativeError, relativeError);
+        }
+        QVERIFY(maximumRelativeError <= fastExpMaximumRelativeError);
+    }
+
+    void testFastExpSpecialValues()
+    {
+        QCOMPARE(fastExp(0.), 1.);
+        QVERIFY(isNearlyEqual(fastExp(1.), 2.718281828459045, 1e-14));
+        // Values outside of [−700, 700] are bound to this range.
+        QCOMPARE(fastExp(-1000.), fastExp(-700.));
+        QVERIFY(fastExp(-1000.) > 0);
+        QCOMPARE(fastExp(1000.), fastExp(700.));
+        QVERIFY(std::isfinite(fastExp(1000.)));
+        // Other floating point types
+        QVERIFY(isNearlyEqual(fastExp(1.f), 2.7182817f, 1e-6f));
+    }
+
+    void testFastSinCosDegreeAccuracy()
+    {
+        // Reference values are calculated with long double where available.
+        double maximumError = 0;
+        for (double angle = -720; angle <= 720; angle += 0.0917) {
+            double sine;
+            double cosine;
+            fastSinCosDegree(angle, sine, cosine);
+            const long double radian = //
+                static_cast<long double>(angle) * 3.14159265358979323846264338L / 180;
+            maximumError = qMax<double>( //
+                maximumError,
+                std::abs(static_cast<long double>(sine) - std::sin(radian)));
+            maximumError = qMax<double>( //
+                maximumError,
+                std::abs(static_cast<long double>(cosine) - std::cos(radian)));
+        }
+        // Large angles at the limit of the valid range
+        for (double angle = 359000; angle <= 360000; angle += 0.917) {
+            double sine;
+            double cosine;
+            fastSinCosDegree(angle, sine, cosine);
+            const long double radian = //
+                static_cast<long double>(angle) * 3.14159265358979323846264338L / 180;
+            maximumError = qMax<double>( //
+                maximumError,
+                std::abs(static_cast<long double>(sine) - std::sin(radian)));
+            maximumError = qMax<double>( //
+                maximumError,
+                std::abs(static_cast<long double>(cosine) - std::cos(radian)));
+        }
+        QVERIFY(maximumError <= fastSinCosMaximumError);
+    }
+
+    void testFastSinCosDegreeSpecialValues()
+    {
+        // Quadrant boundaries give exact results.
+        const double angles[] = {-360, -270, -180, -90, 0, 90, 180, 270, 360, 450};
+        const double expectedSine[] = {0, 1, 0, -1, 0, 1, 0, -1, 0, 1};
+        const double expectedCosine[] = {1, 0, -1, 0, 1, 0, -1, 0, 1, 0};
+        for (int i = 0; i < 10; ++i) {
+            double sine;
+            double cosine;
+            fastSinCosDegree(angles[i], sine, cosine);
+            QCOMPARE(std::abs(sine), std::abs(expectedSine[i]));
+            QCOMPARE(std::abs(cosine), std::abs(expectedCosine[i]));
+            QCOMPARE(sine >= 0, expectedSine[i] >= 0);
+            QCOMPARE(cosine >= 0, expectedCosine[i] >= 0);
+        }
+        // Other floating point types
+        float sine;
+        float cosine;
+        fastSinCosDegree(30.f, sine, cosine);
+        QVERIFY(isNearlyEqual(sine, 0.5f, 1e-6f));
+        QVERIFY(isNearlyEqual(cosine, std::sqrt(3.f) / 2, 1e-6f));
+    }
+
+    void testFastAtan2DegreeAccuracy()
+    {
+        double maximumError = 0;
+        // Points on circles of various radii, covering all octants
+        const double radii[] = {1e-5, 0.3, 1, 150, 1000};
+        for (const double radius : radii) {
+            for (double angle = 0; angle < 360; angle += 0.0917) {
+                const long double radian = //
+                    static_cast<long double>(angle) * 3.14159265358979323846264338L / 180;
+                const double x = static_cast<double>(radius * std::cos(radian));
+                const double y = static_cast<double>(radius * std::sin(radian));
+                long double expected = std::atan2(static_cast<long double>(y), //
+                                                  static_cast<long double>(x))
+                    * 180 / 3.14159265358979323846264338L;
+                if (expected < 0) {
+                    expected += 360;
+                }
+                long double error = std::abs(fastAtan2Degree(y, x) - expected);
+                // 0° and 360° are the same angle.
+                error = qMin(error, std::abs(error - 360));
+                maximumError = qMax<double>(maximumError, error);
+            }
+        }
+        QVERIFY(maximumError <= fastAtan2MaximumErrorDegree);
+    }
+
+    void testFastAtan2DegreeSpecialValues()
+    {
+        QCOMPARE(fastAtan2Degree(0., 0.), 0.);
+        QCOMPARE(fastAtan2Degree(0., 1.), 0.);
+        QCOMPARE(fastAtan2Degree(1., 0.), 90.);
+        QCOMPARE(fastAtan2Degree(0., -1.), 180.);
+        QCOMPARE(fastAtan2Degree(-1., 0.), 270.);
+        QVERIFY(isNearlyEqual(fastAtan2Degree(1., 1.), 45., 1e-12));
+        QVERIFY(isNearlyEqual(fastAtan2Degree(-1., 1.), 315., 1e-12));
+        // Result range is [0°, 360°].
+        for (int i = -100; i <= 100; ++i) {
+            const double result = fastAtan2Degree(i / 10., -3.);
+            QVERIFY(isInRange(0., result, 360.));
+        }
+        // Other floating point types
+        QVERIFY(isNearlyEqual(fastAtan2Degree(1.f, 1.f), 45.f, 1e-5f));
+    }
+
+    void benchmarkCubeRootStandard()
+    {
+        std::vector<double> input;
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(i / 5000. - 0.5);
+        }
+        std::vector<double> output(input.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                output[i] = std::cbrt(input[i]);
+            }
+        }
+    }
+
+    void benchmarkCubeRootFast()
+    {
+        std::vector<double> input;
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(i / 5000. - 0.5);
+        }
+        std::vector<double> output(input.size());
+        QBENCHMARK {
+            fastCubeRoot(input.data(), output.data(), static_cast<qsizetype>(input.size()));
+        }
+    }
 };
 
 } // namespace PerceptualColor
@@ -0,0 +1,104 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "instructionset.h"
+
+#include <qglobal.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qtest.h>
+#include <qtestcase.h>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qstring.h>
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+namespace PerceptualColor
+{
+class TestInstructionSet : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestInstructionSet(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testDetectInstructionSet()
+    {
+        // Baseline is always available.
+        QVERIFY(static_cast<int>(detectInstructionSet()) //
+                >= static_cast<int>(InstructionSet::Baseline));
+#ifndef PERCEPTUALCOLOR_X86_DISPATCH
+        QCOMPARE(detectInstructionSet(), InstructionSet::Baseline);
+#endif
+    }
+
+    void testAvailableInstructionSets()
+    {
+        const auto list = availableInstructionSets();
+        QVERIFY(list.contains(InstructionSet::Scalar));
+        QVERIFY(list.contains(InstructionSet::Baseline));
+        QVERIFY(list.contains(detectInstructionSet()));
+        QCOMPARE(list.last(), detectInstructionSet());
+    }
+
+    void testActiveInstructionSet()
+    {
+        const auto list = availableInstructionSets();
+        QVERIFY(list.contains(activeInstructionSet()));
+        // The value must be stable.
+        QCOMPARE(activeInstructionSet(), activeInstructionSet());
+    }
+
+    void testNames()
+    {
+        const QList<InstructionSet> all{InstructionSet::Scalar, //
+                                        InstructionSet::Baseline,
+                                        InstructionSet::Avx2,
+                                        InstructionSet::Avx512};
+        for (const auto instructionSet : all) {
+            const auto name = instructionSetName(instructionSet);
+            QVERIFY(!name.isEmpty());
+            QCOMPARE(instructionSetFromName(name).value(), instructionSet);
+        }
+        QCOMPARE(instructionSetFromName(QStringLiteral(" AVX2 ")).value(), //
+                 InstructionSet::Avx2);
+        QCOMPARE(instructionSetFromName(QStringLiteral("sse2")).value(), //
+                 InstructionSet::Baseline);
+        QVERIFY(!instructionSetFromName(QStringLiteral("xyz")).has_value());
+        QVERIFY(!instructionSetFromName(QString()).has_value());
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestInstructionSet)
+// The following “include” is necessary because we do not use a header file:
+#include "testinstructionset.moc"
@@ -0,0 +1,201 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// First included header is the public header of the class we are testing;
+// this forces the header to be self-contained.
+#include "polarcoordinatetable.h"
+
+#include "polarpointf.h"
+#include <cmath>
+#include <qglobal.h>
+#include <qobject.h>
+#include <qpoint.h>
+#include <qsharedpointer.h>
+#include <qtest.h>
+#include <qtestcase.h>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <qtmetamacros.h>
+#else
+#include <qobjectdefs.h>
+#include <qstring.h>
+#endif
+
+namespace PerceptualColor
+{
+class TestPolarCoordinateTable : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestPolarCoordinateTable(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Called before the first test function is executed
+    }
+    void cleanupTestCase()
+    {
+        // Called after the last test function was executed
+    }
+
+    void init()
+    {
+        // Called before each test function is executed
+    }
+    void cleanup()
+    {
+        // Called after every test function
+    }
+
+    void testAgainstPolarPointF_data()
+    {
+        QTest::addColumn<int>("imageSize");
+        QTest::newRow("1") << 1;
+        QTest::newRow("2") << 2;
+        QTest::newRow("3") << 3;
+        QTest::newRow("10") << 10;
+        QTest::newRow("11") << 11;
+        QTest::newRow("256") << 256;
+        QTest::newRow("257") << 257;
+    }
+
+    void testAgainstPolarPointF()
+    {
+        QFETCH(int, imageSize);
+        const PolarCoordinateTable table(imageSize);
+        QCOMPARE(table.imageSize(), imageSize);
+        const qreal center = (imageSize - 1) / static_cast<qreal>(2);
+        // The table stores float values.
+        constexpr qreal tolerance = 0.0001;
+        for (int x = 0; x < imageSize; ++x) {
+            for (int y = 0; y < imageSize; ++y) {
+                const PolarPointF reference(QPointF(x - center, center - y));
+                QVERIFY(std::abs(table.radius(x, y) - reference.radius()) //
+                        < tolerance);
+                if (reference.radius() == 0) {
+                    QCOMPARE(table.angleDegree(x, y), 0.0f);
+                    continue;
+                }
+                QVERIFY(table.angleDegree(x, y) >= 0);
+                QVERIFY(table.angleDegree(x, y) < 360);
+                qreal difference = //
+                    std::abs(table.angleDegree(x, y) - reference.angleDegree());
+                // 359.99999° and 0° are nearly the same angle.
+                if (difference > 180) {
+                    difference = 360 - difference;
+                }
+                QVERIFY(difference < tolerance);
+            }
+        }
+    }
+
+    void testOrientation()
+    {
+        // The y axis points upwards, so the angle is counterclockwise.
+        const auto table = PolarCoordinateTable::forImageSize(5);
+        QCOMPARE(table->angleDegree(4, 2), 0.0f);
+        QCOMPARE(table->angleDegree(2, 0), 90.0f);
+        QCOMPARE(table->angleDegree(0, 2), 180.0f);
+        QCOMPARE(table->angleDegree(2, 4), 270.0f);
+        QCOMPARE(table->radius(2, 2), 0.0f);
+        QCOMPARE(table->radius(4, 2), 2.0f);
+    }
+
+    void testZeroSize()
+    {
+        const auto table = PolarCoordinateTable::forImageSize(0);
+        QVERIFY(!table.isNull());
+        QCOMPARE(table->imageSize(), 0);
+        const auto negativeTable = PolarCoordinateTable::forImageSize(-5);
+        QVERIFY(!negativeTable.isNull());
+        QCOMPARE(negativeTable->imageSize(), 0);
+    }
+
+    void testCacheHit()
+    {
+        const auto first = PolarCoordinateTable::forImageSize(123);
+        const auto second = PolarCoordinateTable::forImageSize(123);
+        QCOMPARE(first.data(), second.data());
+    }
+
+    void testCacheEviction()
+    {
+        const auto first = PolarCoordinateTable::forImageSize(200);
+        const PolarCoordinateTable *firstAddress = first.data();
+        // Use more other sizes than the cache can hold.
+        for (int i = 1; i <= PolarCoordinateTable::cacheCapacity; ++i) {
+            const auto temp = PolarCoordinateTable::forImageSize(200 + i);
+            QCOMPARE(temp->imageSize(), 200 + i);
+        }
+        // The old table is still valid for those who hold a reference…
+        QCOMPARE(first->imageSize(), 200);
+        // …but it is not in the cache anymore.
+        const auto again = PolarCoordinateTable::forImageSize(200);
+        QVERIFY(again.data() != firstAddress);
+        QCOMPARE(again->imageSize(), 200);
+    }
+
+    void testCacheKeepsRecentlyUsed()
+    {
+        const auto first = PolarCoordinateTable::forImageSize(300);
+        for (int i = 1; i < PolarCoordinateTable::cacheCapacity; ++i) {
+            Q_UNUSED(PolarCoordinateTable::forImageSize(300 + i));
+        }
+        // Using the table again makes it the most recently used one…
+        Q_UNUSED(PolarCoordinateTable::forImageSize(300));
+        Q_UNUSED(PolarCoordinateTable::forImageSize(400));
+        // …so it survives when a new size is added.
+        QCOMPARE(PolarCoordinateTable::forImageSize(300).data(), first.data());
+    }
+
+    void benchmarkConstructor()
+    {
+        QBENCHMARK {
+            const PolarCoordinateTable table(1000);
+            Q_UNUSED(table);
+        }
+    }
+
+    void benchmarkPolarPointF()
+    {
+        // For comparison: What the table replaces
+        constexpr int imageSize = 1000;
+        constexpr qreal center = (imageSize - 1) / static_cast<qreal>(2);
+        QBENCHMARK {
+            qreal sum = 0;
+            for (int x = 0; x < imageSize; ++x) {
+                for (int y = 0; y < imageSize; ++y) {
+                    const PolarPointF temp(QPointF(x - center, center - y));
+                    sum += temp.radius() + temp.angleDegree();
+                }
+            }
+            QVERIFY(sum > 0);
+        }
+    }
+
+    void benchmarkLookup()
+    {
+        constexpr int imageSize = 1000;
+        const auto table = PolarCoordinateTable::forImageSize(imageSize);
+        QBENCHMARK {
+            qreal sum = 0;
+            for (int x = 0; x < imageSize; ++x) {
+                for (int y = 0; y < imageSize; ++y) {
+                    sum += table->radius(x, y) + table->angleDegree(x, y);
+                }
+            }
+            QVERIFY(sum > 0);
+        }
+    }
+};
+
+} // namespace PerceptualColor
+
+QTEST_MAIN(PerceptualColor::TestPolarCoordinateTable)
+// The following “include” is necessary because we do not use a header file:
+#include "testpolarcoordinatetable.moc"
@@ -8,12 +8,16 @@
 #include "rgbcolorspace_p.h" // IWYU pragma: keep
 
 #include "cielchd50values.h"
+#include "colorbuffer.h"
 #include "constpropagatinguniquepointer.h"
+#include "gamutoccupancygrid.h"
 #include "helpermath.h"
 #include "helperposixmath.h"
 #include "lchdouble.h"
 #include "rgbcolorspacefactory.h"
+#include <cmath>
 #include <lcms2.h>
+#include <memory>
 #include <qcolor.h>
 #include <qdatetime.h>
 #include <qdir.h>
@@ -33,6 +37,7 @@
 #include <qtest.h>
 #include <qtestcase.h>
 #include <qversionnumber.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qstring.h>
@@ -629,6 +634,99 @@ private Q_SLOTS:
         QCOMPARE(myColorSpace->isCielabD50InGamut(color), false);
     }
 
+    void testIsCielabD50InGamutBatch()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            // Create sRGB which is pretty much standard.
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+
+        // More values than the internal chunk size, and also some values
+        // out of the valid range.
+        std::vector<cmsCIELab> colors;
+        for (int l = -10; l <= 110; l += 10) {
+            for (int a = -150; a <= 150; a += 10) {
+                for (int b = -150; b <= 150; b += 10) {
+                    colors.push_back(cmsCIELab{static_cast<double>(l), //
+                                               static_cast<double>(a),
+                                               static_cast<double>(b)});
+                }
+            }
+        }
+        const auto result = std::make_unique<bool[]>(colors.size());
+        bool *resultPointer = result.get();
+        myColorSpace->isCielabD50InGamut(colors.data(), //
+                                         resultPointer,
+                                         static_cast<qsizetype>(colors.size()));
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            QCOMPARE(resultPointer[i], myColorSpace->isCielabD50InGamut(colors.at(i)));
+        }
+
+        // Zero elements must not crash.
+        myColorSpace->isCielabD50InGamut(colors.data(), resultPointer, 0);
+    }
+
+    void testGamutOccupancyGrid()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            // Create sRGB which is pretty much standard.
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+        // The step is chosen so that the values are not aligned with
+        // the samples of the grid.
+        std::vector<cmsCIELab> colors;
+        for (double l = 0; l <= 100; l += 3.7) {
+            for (double a = -150; a <= 150; a += 3.7) {
+                for (double b = -150; b <= 150; b += 3.7) {
+                    colors.push_back(cmsCIELab{l, a, b});
+                }
+            }
+        }
+        const auto count = static_cast<qsizetype>(colors.size());
+        const auto result = std::make_unique<bool[]>(colors.size());
+        const auto expected = std::make_unique<bool[]>(colors.size());
+        myColorSpace->d_pointer->isCielabD50InGamutExact(colors.data(), //
+                                                         expected.get(),
+                                                         count);
+
+        // The exact test does not build the grid.
+        myColorSpace->isCielabD50InGamut(colors.data(), result.get(), count);
+        QVERIFY(!myColorSpace->d_pointer->m_gamutOccupancyGridBuildStarted.load());
+        QVERIFY(myColorSpace->d_pointer->gamutOccupancyGrid() == nullptr);
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            QCOMPARE(result[i], expected[i]);
+        }
+
+        // The first use of the approximate test starts the build
+        // in the background.
+        myColorSpace->isCielabD50InGamutApproximate(colors.data(), result.get(), 1);
+        QVERIFY(myColorSpace->d_pointer->m_gamutOccupancyGridBuildStarted.load());
+        QTRY_VERIFY_WITH_TIMEOUT( //
+            myColorSpace->d_pointer->gamutOccupancyGrid() != nullptr,
+            30000);
+
+        // For sRGB, the grid has no false answers at these values.
+        myColorSpace->isCielabD50InGamutApproximate(colors.data(), result.get(), count);
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            QCOMPARE(result[i], expected[i]);
+        }
+
+        // The exact test stays exact once the grid is available.
+        myColorSpace->isCielabD50InGamut(colors.data(), result.get(), count);
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            QCOMPARE(result[i], expected[i]);
+        }
+
+        // Most colors are answered from the grid.
+        const GamutOccupancyGrid *grid = //
+            myColorSpace->d_pointer->gamutOccupancyGrid();
+        qsizetype boundaryCount = 0;
+        for (const cmsCIELab &color : colors) {
+            if (grid->occupancy(color) == GamutOccupancyGrid::Occupancy::Boundary) {
+                ++boundaryCount;
+            }
+        }
+        QVERIFY(boundaryCount < count / 4);
+    }
+
     void testToQRgbOrTransparent()
     {
         QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
@@ -657,6 +755,157 @@ private Q_SLOTS:
         QVERIFY(qAlpha(myColorSpace->fromCielabD50ToQRgbOrTransparent(color)) == 0);
     }
 
+    void testToQRgbOrTransparentBatch()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            // Create sRGB which is pretty much standard.
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+
+        // More values than the internal chunk size, and also some values
+        // out of the valid range.
+        std::vector<cmsCIELab> colors;
+        for (int l = -10; l <= 110; l += 10) {
+            for (int a = -150; a <= 150; a += 10) {
+                for (int b = -150; b <= 150; b += 10) {
+                    colors.push_back(cmsCIELab{static_cast<double>(l), //
+                                               static_cast<double>(a),
+                                               static_cast<double>(b)});
+                }
+            }
+        }
+        std::vector<QRgb> result(colors.size());
+        myColorSpace->fromCielabD50ToQRgbOrTransparent(colors.data(), //
+                                                       result.data(),
+                                                       static_cast<qsizetype>(colors.size()));
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            // The single-value version has preconditions for lightness
+            // and chroma, the batch version has not.
+            const QRgb expected = myColorSpace->isCielabD50InGamut(colors.at(i)) //
+                ? myColorSpace->fromCielabD50ToQRgbOrTransparent(colors.at(i))
+                : 0;
+            QCOMPARE(result.at(i), expected);
+        }
+
+        // Zero elements must not crash.
+        myColorSpace->fromCielabD50ToQRgbOrTransparent(colors.data(), result.data(), 0);
+    }
+
+    void testToQRgbBoundBatch()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            // Create sRGB which is pretty much standard.
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+
+        // More values than the internal chunk size, and also some values
+        // out of gamut.
+        std::vector<LchDouble> colors;
+        for (int l = 0; l <= 100; l += 10) {
+            for (int c = 0; c <= 150; c += 10) {
+                for (int h = 0; h < 360; h += 10) {
+                    colors.push_back(LchDouble{static_cast<double>(l), //
+                                               static_cast<double>(c),
+                                               static_cast<double>(h)});
+                }
+            }
+        }
+        std::vector<QRgb> result(colors.size());
+        myColorSpace->fromCielchD50ToQRgbBound(colors.data(), //
+                                               result.data(),
+                                               static_cast<qsizetype>(colors.size()));
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            QCOMPARE(result.at(i), myColorSpace->fromCielchD50ToQRgbBound(colors.at(i)));
+        }
+
+        // Zero elements must not crash.
+        myColorSpace->fromCielchD50ToQRgbBound(colors.data(), result.data(), 0);
+    }
+
+    void testBufferConversions()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            // Create sRGB which is pretty much standard.
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+
+        // More values than the internal chunk size
+        LabBuffer lab(3000);
+        for (qsizetype i = 0; i < lab.size(); ++i) {
+            lab.l()[i] = static_cast<double>(i % 101);
+            lab.a()[i] = static_cast<double>(i % 61) - 30;
+            lab.b()[i] = static_cast<double>(i % 83) - 40;
+        }
+        const auto count = static_cast<std::size_t>(lab.size());
+
+        const auto inGamut = std::make_unique<bool[]>(count);
+        myColorSpace->isCielabD50InGamut(lab, inGamut.get());
+        std::vector<QRgb> qrgb(count);
+        myColorSpace->fromCielabD50ToQRgbOrTransparent(lab, qrgb.data());
+        RgbBuffer rgb;
+        myColorSpace->fromCielabD50ToRgbDoubleUnbound(lab, rgb);
+        QCOMPARE(rgb.size(), lab.size());
+        LabBuffer roundtrip;
+        myColorSpace->toCielabD50(rgb, roundtrip);
+        QCOMPARE(roundtrip.size(), lab.size());
+
+        for (qsizetype i = 0; i < lab.size(); ++i) {
+            const auto index = static_cast<std::size_t>(i);
+            const cmsCIELab color{lab.l()[i], lab.a()[i], lab.b()[i]};
+            QCOMPARE(inGamut[index], myColorSpace->isCielabD50InGamut(color));
+            const QRgb expectedQRgb = inGamut[index] //
+                ? myColorSpace->fromCielabD50ToQRgbOrTransparent(color)
+                : 0;
+            QCOMPARE(qrgb.at(index), expectedQRgb);
+            if (inGamut[index]) {
+                // For in-gamut colors, the round-trip must be precise.
+                QVERIFY(std::abs(roundtrip.l()[i] - lab.l()[i]) < 0.5);
+                QVERIFY(std::abs(roundtrip.a()[i] - lab.a()[i]) < 0.5);
+                QVERIFY(std::abs(roundtrip.b()[i] - lab.b()[i]) < 0.5);
+            }
+        }
+
+        // Empty buffers must not crash.
+        const LabBuffer empty;
+        myColorSpace->isCielabD50InGamut(empty, inGamut.get());
+        myColorSpace->fromCielabD50ToQRgbOrTransparent(empty, qrgb.data());
+        myColorSpace->fromCielabD50ToRgbDoubleUnbound(empty, rgb);
+        QCOMPARE(rgb.size(), 0);
+    }
+
+    void benchmarkToQRgbOrTransparent()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+        std::vector<cmsCIELab> colors;
+        for (int a = -100; a < 100; ++a) {
+            for (int b = -50; b < 50; ++b) {
+                colors.push_back(cmsCIELab{50, static_cast<double>(a), static_cast<double>(b)});
+            }
+        }
+        std::vector<QRgb> result(colors.size());
+        QBENCHMARK {
+            for (std::size_t i = 0; i < colors.size(); ++i) {
+                result[i] = myColorSpace->fromCielabD50ToQRgbOrTransparent(colors[i]);
+            }
+        }
+    }
+
+    void benchmarkToQRgbOrTransparentBatch()
+    {
+        QSharedPointer<PerceptualColor::RgbColorSpace> myColorSpace =
+            PerceptualColor::RgbColorSpaceFactory::createSrgb();
+        std::vector<cmsCIELab> colors;
+        for (int a = -100; a < 100; ++a) {
+            for (int b = -50; b < 50; ++b) {
+                colors.push_back(cmsCIELab{50, static_cast<double>(a), static_cast<double>(b)});
+            }
+        }
+        std::vector<QRgb> result(colors.size());
+        QBENCHMARK {
+            myColorSpace->fromCielabD50ToQRgbOrTransparent(colors.data(), //
+                                                           result.data(),
+                                                           static_cast<qsizetype>(colors.size()));
+        }
+    }
+
     // The following unit tests are a little bit special. They do not
     // actually test the functionality of getInformationFromProfile()
     // but rather if its character encoding converting approach works
@@ -8,6 +8,7 @@
 #include "abstractdiagram_p.h" // IWYU pragma: associated
 
 #include "helper.h"
+#include "helperconstants.h"
 #include <qcolor.h>
 #include <qglobal.h>
 #include <qimage.h>
@@ -16,8 +17,10 @@
 #include <qsize.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
+#include <qtimer.h>
 #include <qwidget.h>
 class QHideEvent;
+class QResizeEvent;
 class QShowEvent;
 
 namespace PerceptualColor
@@ -29,6 +32,25 @@ AbstractDiagram::AbstractDiagram(QWidget *parent)
     : QWidget(parent)
     , d_pointer(new AbstractDiagramPrivate())
 {
+    d_pointer->m_resizeTimer.setSingleShot(true);
+    d_pointer->m_resizeTimer.setInterval(diagramResizeRenderDelay);
+    // Once the size is stable, render the images for the new size.
+    connect(&d_pointer->m_resizeTimer, //
+            &QTimer::timeout, //
+            this, //
+            &AbstractDiagram::callUpdate);
+
+    d_pointer->m_interactionTimer.setSingleShot(true);
+    d_pointer->m_interactionTimer.setInterval(diagramInteractionIdleDelay);
+    // Once the interaction has ended, render the images
+    // at full resolution.
+    connect(&d_pointer->m_interactionTimer, // sender
+            &QTimer::timeout, // signal
+            this, // receiver
+            [this]() { // lambda
+                d_pointer->m_isInteracting = false;
+                update();
+            });
 }
 
 /** @brief Destructor */
@@ -312,6 +334,117 @@ void AbstractDiagram::hideEvent(QHideEvent *event)
     }
 }
 
+/** @brief React on a resize event.
+ *
+ * Reimplemented from base class.
+ *
+ * @param event The resize event.
+ *
+ * Child classes that reimplement this function must call
+ * the base class implementation.
+ *
+ * @internal
+ *
+ * @sa @ref AbstractDiagram::isResizing */
+void AbstractDiagram::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    d_pointer->m_resizeTimer.start();
+}
+
+/** @brief If this widget is currently resized.
+ *
+ * During an interactive resize (for example, when the user drags the
+ * border of the window), the widget receives many resize events in quick
+ * succession. Rendering the images for each intermediate size would waste
+ * CPU time, and the images would flash or restart all the time. Therefore,
+ * child classes should, while this function returns <tt>true</tt>, keep
+ * the images they have yet and paint them scaled to the new size.
+ * The actual rendering for the new size should start only when this
+ * function returns <tt>false</tt> again.
+ *
+ * When the size has been stable for @ref resizeRenderDelay(), a
+ * paint event is scheduled.
+ *
+ * @returns <tt>true</tt> if the widget has been resized within the
+ * last @ref resizeRenderDelay(). <tt>false</tt> otherwise. */
+bool AbstractDiagram::isResizing() const
+{
+    return d_pointer->m_resizeTimer.isActive();
+}
+
+/** @brief Registers a change that is part of a user interaction.
+ *
+ * Child classes call this function whenever a property changes that
+ * requires a new rendering of their images, for example the hue of a
+ * diagram that is controlled by a slider.
+ *
+ * A single change is not yet considered an interaction, so that
+ * programmatic changes are rendered at full resolution immediately.
+ * But as soon as a further change follows within a short time (like when
+ * the user drags a handle or moves a slider), @ref isInteracting()
+ * becomes <tt>true</tt> until no further change occurs for a short
+ * time. Then, a paint event is scheduled.
+ *
+ * @sa @ref renderScale() */
+void AbstractDiagram::registerInteraction()
+{
+    if (d_pointer->m_interactionTimer.isActive()) {
+        d_pointer->m_isInteracting = true;
+    }
+    d_pointer->m_interactionTimer.start();
+}
+
+/** @brief If the user is currently interacting with the widget.
+ *
+ * @returns <tt>true</tt> if the widget is currently in the middle of
+ * an interaction. <tt>false</tt> otherwise.
+ *
+ * @sa @ref registerInteraction() */
+bool AbstractDiagram::isInteracting() const
+{
+    return d_pointer->m_isInteracting;
+}
+
+/** @brief The scale factor for the resolution of rendered images.
+ *
+ * Full-resolution renderings cannot keep up with interactions on
+ * high-DPI screens. Therefore, images are rendered at reduced resolution
+ * while @ref isInteracting(), and at full resolution once the
+ * interaction has ended.
+ *
+ * Child classes multiply the physical image size and the device pixel
+ * ratio of the images they render by this factor, and paint the images
+ * scaled to the widget size.
+ *
+ * @returns The scale factor. <tt>1</tt> for full resolution.
+ * Less while @ref isInteracting(). Range: <tt>]0, 1]</tt> */
+qreal AbstractDiagram::renderScale() const
+{
+    return isInteracting() ? diagramInteractionRenderScale : 1;
+}
+
+/** @brief The time the size has to be stable before rendering.
+ *
+ * @returns The time, measured in milliseconds.
+ *
+ * @sa @ref isResizing()
+ * @sa @ref setResizeRenderDelay() */
+int AbstractDiagram::resizeRenderDelay() const
+{
+    return d_pointer->m_resizeTimer.interval();
+}
+
+/** @brief Setter for @ref resizeRenderDelay().
+ *
+ * @param milliseconds The new delay, measured in milliseconds. 0 means
+ *        that the rendering starts as soon as the event loop has processed
+ *        all pending events. */
+void AbstractDiagram::setResizeRenderDelay(const int milliseconds)
+{
+    d_pointer->m_resizeTimer.setInterval(qMax(milliseconds, 0));
+}
+
 /** @brief An alternative to QWidget::update(). It’s a workaround
  * that avoids trouble with overload resolution.
  *
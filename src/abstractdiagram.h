@@ -12,6 +12,7 @@
 #include <qsize.h>
 #include <qwidget.h>
 class QHideEvent;
+class QResizeEvent;
 class QShowEvent;
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -72,12 +73,19 @@ protected:
     [[nodiscard]] int gradientThickness() const;
     virtual void hideEvent(QHideEvent *event) override;
     [[nodiscard]] bool isActuallyVisible() const;
+    [[nodiscard]] bool isInteracting() const;
+    [[nodiscard]] bool isResizing() const;
     [[nodiscard]] int maximumPhysicalSquareSize() const;
     [[nodiscard]] qreal maximumWidgetSquareSize() const;
     [[nodiscard]] QSize physicalPixelSize() const;
     [[nodiscard]] QColor handleColorFromBackgroundLightness(qreal lightness) const;
     [[nodiscard]] int handleOutlineThickness() const;
     [[nodiscard]] qreal handleRadius() const;
+    void registerInteraction();
+    [[nodiscard]] qreal renderScale() const;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    [[nodiscard]] int resizeRenderDelay() const;
+    void setResizeRenderDelay(const int milliseconds);
     virtual void showEvent(QShowEvent *event) override;
     [[nodiscard]] int spaceForFocusIndicator() const;
     [[nodiscard]] QImage transparencyBackground() const;
@@ -8,6 +8,7 @@
 // #include "abstractdiagram.h"
 
 #include <qglobal.h>
+#include <qtimer.h>
 
 namespace PerceptualColor
 {
@@ -28,6 +29,21 @@ public:
 
     /** @brief Internal storage for @ref AbstractDiagram::isActuallyVisible. */
     bool m_isActuallyVisible = false;
+    /** @brief Internal storage for @ref AbstractDiagram::isInteracting. */
+    bool m_isInteracting = false;
+    /** @brief Runs after each interaction.
+     *
+     * Single-shot timer that is restarted by each interaction.
+     *
+     * @sa @ref AbstractDiagram::registerInteraction() */
+    QTimer m_interactionTimer;
+    /** @brief Runs while the widget is resized.
+     *
+     * Single-shot timer that is restarted by each resize event.
+     *
+     * @sa @ref AbstractDiagram::isResizing()
+     * @sa @ref AbstractDiagram::resizeRenderDelay() */
+    QTimer m_resizeTimer;
 
 private:
     Q_DISABLE_COPY(AbstractDiagramPrivate)
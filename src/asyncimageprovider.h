@@ -5,10 +5,13 @@
 #define ASYNCIMAGEPROVIDER_H
 
 #include "asyncimageproviderbase.h"
+#include "asyncimagerendercallback.h"
 #include "asyncimagerenderthread.h"
 #include "rgbcolorspacefactory.h"
 #include <optional>
+#include <qglobal.h>
 #include <qimage.h>
+#include <qlist.h>
 #include <qobject.h>
 #include <qvariant.h>
 
@@ -41,6 +44,14 @@ namespace PerceptualColor
  *   helper class makes it easy to implement  Adam7-like interlacing.
  * - Cache: As the image calculation might be expensive, resulting image is
  *   cached for further usage.
+ * - Optional history cache: Final images of previous image parameters
+ *   can be kept in a bounded cache with least-recently-used eviction.
+ *   When the user comes back to previous image parameters (for example
+ *   by moving a slider back and forth), the image is available
+ *   immediately. See @ref setHistoryCacheLimitInBytes().
+ * - Optional prefetching: Images for image parameters that will
+ *   probably be requested soon can be rendered ahead of time into the
+ *   history cache. See @ref prefetchAsync().
  *
  * @section asyncimagecreate How to create an object
  *
@@ -51,7 +62,11 @@ namespace PerceptualColor
  * The cache can be accessed with @ref getCache(). Note that the
  * cache is <em>not</em> refreshed implicitly after changing the
  * @ref imageParameters(); therefore the cache can be out-of-date.
- * Use @ref refreshAsync() to request explicitly a refresh.
+ * Use @ref refreshAsync() to request explicitly a refresh. If the
+ * requested image parameters are found in the history cache, the
+ * refresh is done synchronously within @ref refreshAsync(): The
+ * image is available immediately at @ref getCache(), and no
+ * rendering is started.
  *
  * @section asyncimagefurther Further reading
  *
@@ -82,10 +97,10 @@ namespace PerceptualColor
  * @todo Possible (or even necessary?) improvement: If a requested image
  * is yet either available or in computation at another object of the same
  * template class, that this object should not trigger a new computation,
- * but use the yet available/running one of the other object. In practice,
- * this might be interesting for the @ref ColorWheelImage, which is likely to
- * be used twice within the same @ref ColorDialog at exactly the same size.
- * This requires probably a thread-safe management of instances through
+ * but use the yet available/running one of the other object.
+ * @ref ColorWheelImageParameters yet shares <em>finished</em> images
+ * between all objects, but not computations that are still running.
+ * A generic solution requires probably a thread-safe management of instances through
  * static class members, to make sure that the resulting objects are
  * (while still not thread-safe themselves) at least reentrant.
  *
@@ -96,7 +111,7 @@ namespace PerceptualColor
  * @todo Possible (or even necessary?) improvement: For @ref ChromaHueDiagram
  * and @ref ChromaLightnessDiagram, the image cache is quite big, because
  * we cache both, the center of the diagram and also the surrounding
- * @ref ColorWheelImage. Could we combine both into one single cache? But
+ * @ref ColorWheelImageParameters. Could we combine both into one single cache? But
  * if so, wouldn’t this make problems with anti-aliasing if in future versions
  * we do not want to preserve a distance between the color wheel and the
  * inner content anymore? And: Would this be compatible with sharing
@@ -156,9 +171,16 @@ public:
     virtual ~AsyncImageProvider() noexcept override;
 
     [[nodiscard]] QImage getCache() const;
+    [[nodiscard]] qint64 historyCacheHitCount() const;
+    [[nodiscard]] qsizetype historyCacheLimitInBytes() const;
+    [[nodiscard]] qint64 historyCacheMissCount() const;
+    [[nodiscard]] qsizetype historyCacheSizeInBytes() const;
     [[nodiscard]] T imageParameters() const;
+    void prefetchAsync(const QList<T> &parametersList);
     void refreshAsync();
     void refreshSync();
+    [[nodiscard]] qint64 renderCount() const;
+    void setHistoryCacheLimitInBytes(const qsizetype newLimit);
     void setImageParameters(const T &newImageParameters);
 
 private:
@@ -167,10 +189,45 @@ private:
     /** @internal @brief Only for unit tests. */
     friend class TestAsyncImageProvider;
 
-    void processInterlacingPassResult(const QImage &deliveredImage);
+    void addToHistoryCache(const T &parameters, const QImage &image);
+    void cancelPrefetch();
+    void processInterlacingPassResult(const QImage &deliveredImage, const QVariant &parameters, const AsyncImageRenderCallback::InterlacingState state);
+    void processPrefetchResult(const QImage &deliveredImage, const QVariant &parameters, const AsyncImageRenderCallback::InterlacingState state);
+    void shrinkHistoryCache(const qsizetype limit);
+    void startNextPrefetch();
+
+    /** @brief Maximum number of image parameters that are accepted
+     * by @ref prefetchAsync(). */
+    static constexpr int prefetchLimit = 4;
 
     /** @brief The image cache. */
     QImage m_cache;
+    /** @brief Images of the history cache, most recently used first.
+     *
+     * The corresponding image parameters are stored at the same index
+     * in @ref m_historyCacheParameters.
+     *
+     * @sa @ref setHistoryCacheLimitInBytes() */
+    QList<QImage> m_historyCacheImages;
+    /** @brief Image parameters of @ref m_historyCacheImages. */
+    QList<T> m_historyCacheParameters;
+    /** @brief Number of requests that were served by the history cache.
+     *
+     * @sa @ref historyCacheHitCount() */
+    qint64 m_historyCacheHitCount = 0;
+    /** @brief Internal storage for the history cache limit.
+     *
+     * @sa @ref historyCacheLimitInBytes()
+     * @sa @ref setHistoryCacheLimitInBytes() */
+    qsizetype m_historyCacheLimitInBytes = 0;
+    /** @brief Number of requests that were not served by the history
+     * cache.
+     *
+     * @sa @ref historyCacheMissCount() */
+    qint64 m_historyCacheMissCount = 0;
+    /** @brief Memory used by @ref m_historyCacheImages, measured
+     * in bytes. */
+    qsizetype m_historyCacheSizeInBytes = 0;
     /** @brief Internal storage for the image parameters.
      *
      * @sa @ref imageParameters()
@@ -184,9 +241,33 @@ private:
      * @ref AsyncImageRenderCallback::InterlacingState of the
      * delivered image. Is <tt>false</tt> otherwise. */
     bool m_lastRenderingRequestHasYetDeliveredAnImage = false;
+    /** @brief If the last request was served by the history cache.
+     *
+     * If so, images that are still delivered by the render thread for
+     * older image parameters must not replace @ref m_cache. */
+    bool m_lastRequestWasServedByHistoryCache = false;
     /** @brief The parameters of the last rendering that has been started
      * (if any). */
     std::optional<T> m_lastRenderingRequestImageParameters;
+    /** @brief If the rendering for the last request has not yet delivered
+     * its final image.
+     *
+     * As long as this is <tt>true</tt>, no prefetching is started, so
+     * that it does not take CPU time away from the real request. */
+    bool m_lastRenderingRequestIsPending = false;
+    /** @brief Image parameters that are waiting to be prefetched.
+     *
+     * @sa @ref prefetchAsync() */
+    QList<T> m_prefetchQueue;
+    /** @brief Internal storage for @ref renderCount(). */
+    qint64 m_renderCount = 0;
+    /** @brief The image parameters that are currently prefetched (if
+     * any). */
+    std::optional<T> m_prefetchRenderingParameters;
+    /** @brief Provides a render thread for prefetching.
+     *
+     * It runs with <tt>QThread::IdlePriority</tt>. */
+    AsyncImageRenderThread m_prefetchThread;
     /** @brief Provides a render thread. */
     AsyncImageRenderThread m_renderThread;
 };
@@ -197,6 +278,7 @@ private:
 template<typename T>
 AsyncImageProvider<T>::AsyncImageProvider(QObject *parent)
     : AsyncImageProviderBase(parent)
+    , m_prefetchThread(&T::render)
     , m_renderThread(&T::render)
 {
     // Calling qRegisterMetaType is safe even if a given type has yet
@@ -207,6 +289,12 @@ AsyncImageProvider<T>::AsyncImageProvider(QObject *parent)
         &AsyncImageRenderThread::interlacingPassCompleted, //
         this, //
         &AsyncImageProvider<T>::processInterlacingPassResult);
+    m_prefetchThread.setRenderPriority(QThread::IdlePriority);
+    connect( //
+        &m_prefetchThread, //
+        &AsyncImageRenderThread::interlacingPassCompleted, //
+        this, //
+        &AsyncImageProvider<T>::processPrefetchResult);
 }
 
 /** @brief Destructor */
@@ -286,22 +374,287 @@ T AsyncImageProvider<T>::imageParameters() const
  * the functor-based <tt>Qt::connect()</tt> syntax to connect to this function
  * as long as the connection type is not direct, but queued. */
 template<typename T>
-void AsyncImageProvider<T>::processInterlacingPassResult(const QImage &deliveredImage)
+void AsyncImageProvider<T>::processInterlacingPassResult(const QImage &deliveredImage, const QVariant &parameters, const AsyncImageRenderCallback::InterlacingState state)
 {
+    const bool hasParameters = parameters.canConvert<T>();
+    if (hasParameters && (state == AsyncImageRenderCallback::InterlacingState::Final)) {
+        const T deliveredParameters = parameters.value<T>();
+        addToHistoryCache(deliveredParameters, deliveredImage);
+        if (m_lastRenderingRequestIsPending //
+            && (deliveredParameters == m_lastRenderingRequestImageParameters)) {
+            // The real request is done: Prefetching can start now.
+            m_lastRenderingRequestIsPending = false;
+            startNextPrefetch();
+        }
+    }
+    if (m_lastRequestWasServedByHistoryCache) {
+        // An older rendering that is still running must not replace
+        // the image that has been taken from the history cache.
+        return;
+    }
     m_cache = deliveredImage;
     Q_EMIT interlacingPassCompleted();
 }
 
 /** @brief Asynchronously triggers a refresh of the image cache (if
- * necessary). */
+ * necessary).
+ *
+ * If the image parameters are found in the history cache, the
+ * refresh is done synchronously: The image is available at
+ * @ref getCache() immediately after this call. The signal
+ * @ref interlacingPassCompleted() is not emitted in this case. */
 template<typename T>
 void AsyncImageProvider<T>::refreshAsync()
 {
     if (imageParameters() == m_lastRenderingRequestImageParameters) {
         return;
     }
-    m_renderThread.startRenderingAsync(QVariant::fromValue(imageParameters()));
     m_lastRenderingRequestImageParameters = imageParameters();
+    if (m_historyCacheLimitInBytes > 0) {
+        const auto index = m_historyCacheParameters.indexOf(imageParameters());
+        if (index >= 0) {
+            ++m_historyCacheHitCount;
+            m_historyCacheParameters.move(index, 0);
+            m_historyCacheImages.move(index, 0);
+            m_cache = m_historyCacheImages.at(0);
+            m_lastRequestWasServedByHistoryCache = true;
+            m_lastRenderingRequestIsPending = false;
+            startNextPrefetch();
+            return;
+        }
+        ++m_historyCacheMissCount;
+    }
+    m_lastRequestWasServedByHistoryCache = false;
+    // The real request has priority: Prefetching stops, so that it does
+    // not take CPU time away from the real request.
+    cancelPrefetch();
+    m_lastRenderingRequestIsPending = true;
+    ++m_renderCount;
+    m_renderThread.startRenderingAsync(QVariant::fromValue(imageParameters()));
+}
+
+/** @brief Speculatively renders images into the history cache.
+ *
+ * Use this for image parameters that will probably be requested soon,
+ * for example the next values of a slider that is currently moving.
+ * If they are later requested by @ref refreshAsync(), they are available
+ * immediately.
+ *
+ * @param parametersList The image parameters to prefetch, the most
+ *        probable first. Only the first @ref prefetchLimit entries are
+ *        taken into account. Image parameters that are yet in the history
+ *        cache are skipped.
+ *
+ * The rendering is done one image after the other within a thread of
+ * idle priority, so it uses only CPU time that is not needed otherwise.
+ * The images go to the history cache, so the memory is limited by
+ * @ref historyCacheLimitInBytes(). If the history cache is disabled,
+ * this function does nothing.
+ *
+ * A new call replaces the prefetch requests of previous calls. Also, when
+ * @ref refreshAsync() has to start a new rendering, all prefetching
+ * stops. Prefetching starts only when the rendering of the real request
+ * has delivered its final image; until then, the requests are queued. */
+template<typename T>
+void AsyncImageProvider<T>::prefetchAsync(const QList<T> &parametersList)
+{
+    if (m_historyCacheLimitInBytes <= 0) {
+        return;
+    }
+    m_prefetchQueue = parametersList.mid(0, prefetchLimit);
+    if (m_prefetchRenderingParameters.has_value()) {
+        const auto index = m_prefetchQueue.indexOf(m_prefetchRenderingParameters.value());
+        if (index >= 0) {
+            // The current prefetch is still wanted: Let it continue.
+            m_prefetchQueue.removeAt(index);
+            return;
+        }
+    }
+    startNextPrefetch();
+}
+
+/** @brief Starts prefetching the next entry of @ref m_prefetchQueue.
+ *
+ * Entries that are not necessary anymore are skipped. If there is no
+ * entry left, a possibly running prefetch is stopped. While the rendering
+ * of the real request is pending, nothing happens. */
+template<typename T>
+void AsyncImageProvider<T>::startNextPrefetch()
+{
+    if (m_lastRenderingRequestIsPending) {
+        return;
+    }
+    while (!m_prefetchQueue.isEmpty()) {
+        const T parameters = m_prefetchQueue.takeFirst();
+        const bool isNecessary = //
+            (!m_historyCacheParameters.contains(parameters)) //
+            && !(parameters == m_lastRenderingRequestImageParameters);
+        if (isNecessary) {
+            m_prefetchRenderingParameters = parameters;
+            m_prefetchThread.startRenderingAsync(QVariant::fromValue(parameters));
+            return;
+        }
+    }
+    cancelPrefetch();
+}
+
+/** @brief Stops prefetching.
+ *
+ * @post @ref m_prefetchQueue is empty and a possibly running prefetch
+ * is requested to stop as soon as possible. */
+template<typename T>
+void AsyncImageProvider<T>::cancelPrefetch()
+{
+    m_prefetchQueue.clear();
+    if (m_prefetchRenderingParameters.has_value()) {
+        m_prefetchRenderingParameters.reset();
+        // An invalid QVariant makes the render function return
+        // immediately.
+        m_prefetchThread.startRenderingAsync(QVariant());
+    }
+}
+
+/** @brief Receives and processes newly prefetched images.
+ *
+ * @param deliveredImage The image (either interlaced or full-quality)
+ * @param parameters The image parameters of the image
+ * @param state The interlacing state of the image
+ *
+ * Final images are added to the history cache, and the next prefetch
+ * is started. Intermediate images are ignored. */
+template<typename T>
+void AsyncImageProvider<T>::processPrefetchResult(const QImage &deliveredImage, const QVariant &parameters, const AsyncImageRenderCallback::InterlacingState state)
+{
+    if ((state != AsyncImageRenderCallback::InterlacingState::Final) //
+        || !parameters.canConvert<T>()) {
+        return;
+    }
+    const T prefetchedParameters = parameters.value<T>();
+    addToHistoryCache(prefetchedParameters, deliveredImage);
+    if (prefetchedParameters == m_prefetchRenderingParameters) {
+        m_prefetchRenderingParameters.reset();
+        startNextPrefetch();
+    }
+}
+
+/** @brief Adds an image to the history cache.
+ *
+ * @param parameters The image parameters of the image
+ * @param image The final image
+ *
+ * The image is added as most recently used entry. The least recently used
+ * entries are removed as long as the @ref historyCacheLimitInBytes() is
+ * exceeded. Images that are bigger than @ref historyCacheLimitInBytes()
+ * are not added. */
+template<typename T>
+void AsyncImageProvider<T>::addToHistoryCache(const T &parameters, const QImage &image)
+{
+    const auto imageSize = static_cast<qsizetype>(image.sizeInBytes());
+    if (image.isNull() || (imageSize > m_historyCacheLimitInBytes)) {
+        return;
+    }
+    const auto index = m_historyCacheParameters.indexOf(parameters);
+    if (index >= 0) {
+        m_historyCacheSizeInBytes -= //
+            static_cast<qsizetype>(m_historyCacheImages.at(index).sizeInBytes());
+        m_historyCacheParameters.removeAt(index);
+        m_historyCacheImages.removeAt(index);
+    }
+    shrinkHistoryCache(m_historyCacheLimitInBytes - imageSize);
+    m_historyCacheParameters.prepend(parameters);
+    m_historyCacheImages.prepend(image);
+    m_historyCacheSizeInBytes += imageSize;
+}
+
+/** @brief Removes the least recently used entries from the history cache.
+ *
+ * @param limit The maximum memory that the history cache may use after
+ *        this call, measured in bytes. */
+template<typename T>
+void AsyncImageProvider<T>::shrinkHistoryCache(const qsizetype limit)
+{
+    while (!m_historyCacheImages.isEmpty() && (m_historyCacheSizeInBytes > limit)) {
+        m_historyCacheSizeInBytes -= //
+            static_cast<qsizetype>(m_historyCacheImages.last().sizeInBytes());
+        m_historyCacheParameters.removeLast();
+        m_historyCacheImages.removeLast();
+    }
+}
+
+/** @brief Setter for the history cache limit.
+ *
+ * The history cache keeps the final images of previous image parameters.
+ * When @ref refreshAsync() is called for image parameters that are found
+ * in the history cache, the image is available immediately.
+ *
+ * @param newLimit The maximum memory that the history cache may use,
+ *        measured in bytes. <tt>0</tt> disables the history cache. This
+ *        is the default value. Negative values are treated
+ *        as <tt>0</tt>.
+ *
+ * @sa @ref historyCacheLimitInBytes() */
+template<typename T>
+void AsyncImageProvider<T>::setHistoryCacheLimitInBytes(const qsizetype newLimit)
+{
+    m_historyCacheLimitInBytes = qMax<qsizetype>(newLimit, 0);
+    shrinkHistoryCache(m_historyCacheLimitInBytes);
+}
+
+/** @brief Getter for the history cache limit.
+ *
+ * @returns The maximum memory that the history cache may use, measured
+ * in bytes.
+ *
+ * @sa @ref setHistoryCacheLimitInBytes() */
+template<typename T>
+qsizetype AsyncImageProvider<T>::historyCacheLimitInBytes() const
+{
+    return m_historyCacheLimitInBytes;
+}
+
+/** @brief Memory used by the history cache.
+ *
+ * @returns The memory that the images within the history cache are
+ * using, measured in bytes. */
+template<typename T>
+qsizetype AsyncImageProvider<T>::historyCacheSizeInBytes() const
+{
+    return m_historyCacheSizeInBytes;
+}
+
+/** @brief Number of history cache hits.
+ *
+ * @returns The number of calls of @ref refreshAsync() that were served
+ * by the history cache.
+ *
+ * @sa @ref historyCacheMissCount() */
+template<typename T>
+qint64 AsyncImageProvider<T>::historyCacheHitCount() const
+{
+    return m_historyCacheHitCount;
+}
+
+/** @brief Number of history cache misses.
+ *
+ * @returns The number of calls of @ref refreshAsync() that started
+ * a new rendering while the history cache was enabled.
+ *
+ * @sa @ref historyCacheHitCount() */
+template<typename T>
+qint64 AsyncImageProvider<T>::historyCacheMissCount() const
+{
+    return m_historyCacheMissCount;
+}
+
+/** @brief Number of renderings.
+ *
+ * @returns The number of renderings that have been started by
+ * @ref refreshAsync() (or @ref refreshSync()). Requests that were
+ * served by the history cache and prefetching are not counted. */
+template<typename T>
+qint64 AsyncImageProvider<T>::renderCount() const
+{
+    return m_renderCount;
 }
 
 /** @brief Synchronously refreshes the image cache (if necessary). */
@@ -46,6 +46,23 @@ AsyncImageRenderThread::~AsyncImageRenderThread()
     m_syncCondition.wakeAll();
 }
 
+/** @brief Setter for the priority of the rendering thread.
+ *
+ * @param newPriority The new priority. The default value is
+ *        <tt>QThread::LowPriority</tt>, which is one priority level lower
+ *        than normal priority. For speculative work, like prefetching,
+ *        <tt>QThread::IdlePriority</tt> might be more appropriate.
+ *
+ * If the thread is currently running, the new priority is applied
+ * immediately. */
+void AsyncImageRenderThread::setRenderPriority(const QThread::Priority newPriority)
+{
+    m_renderPriority = newPriority;
+    if (isRunning()) {
+        setPriority(newPriority);
+    }
+}
+
 /** @brief Asynchronously start rendering.
  *
  * As this function is asynchronous, it will return very fast.
@@ -83,7 +100,7 @@ void AsyncImageRenderThread::startRenderingAsync(const QVariant &parameters)
         m_syncIsIdle = false;
     }
     if (!isRunning()) {
-        start(LowPriority); // One priority level lower than normal priority.
+        start(m_renderPriority);
     } else {
         m_loopRestart = true;
         m_loopCondition.wakeOne();
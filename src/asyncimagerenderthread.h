@@ -70,6 +70,7 @@ public:
     virtual ~AsyncImageRenderThread() override;
 
     virtual void deliverInterlacingPass(const QImage &image, const QVariant &parameters, const AsyncImageRenderCallback::InterlacingState state) override;
+    void setRenderPriority(const QThread::Priority newPriority);
     void startRenderingAsync(const QVariant &parameters);
     [[nodiscard]] virtual bool shouldAbort() const override;
     void waitForIdle();
@@ -165,6 +166,10 @@ private:
     /** @brief Function pointer to the function that does the
      * actual rendering. */
     const pointerToRenderFunction m_renderFunction;
+    /** @brief The priority of the thread.
+     *
+     * @sa @ref setRenderPriority() */
+    QThread::Priority m_renderPriority = LowPriority;
     /** @brief Wait condition to wait until this thread goes to sleep. */
     QWaitCondition m_syncCondition;
     /** @brief Is <tt>true</tt> if the render thread is either sleeping
@@ -11,7 +11,7 @@
 #include "asyncimageprovider.h"
 #include "chromahueimageparameters.h"
 #include "cielchd50values.h"
-#include "colorwheelimage.h"
+#include "colorwheelimageparameters.h"
 #include "constpropagatingrawpointer.h"
 #include "constpropagatinguniquepointer.h"
 #include "helper.h"
@@ -25,10 +25,12 @@
 #include <qcolor.h>
 #include <qevent.h>
 #include <qimage.h>
+#include <qlist.h>
 #include <qnamespace.h>
 #include <qpainter.h>
 #include <qpen.h>
 #include <qpoint.h>
+#include <qrect.h>
 #include <qsharedpointer.h>
 #include <qwidget.h>
 
@@ -62,11 +64,20 @@ ChromaHueDiagram::ChromaHueDiagram(const QSharedPointer<PerceptualColor::RgbColo
     // Qt::FocusPolicy::TabFocus for QWidget::focusPolicy().
     setFocusPolicy(Qt::FocusPolicy::TabFocus);
 
+    // Keep the images of previous lightness values, which are shown
+    // again when the user moves the lightness slider back and forth.
+    d_pointer->m_chromaHueImage.setHistoryCacheLimitInBytes( //
+        diagramHistoryCacheLimitInBytes);
+
     // Connections
     connect(&d_pointer->m_chromaHueImage, //
             &AsyncImageProvider<ChromaHueImageParameters>::interlacingPassCompleted, //
             this,
             &ChromaHueDiagram::callUpdate);
+    connect(&d_pointer->m_wheelImage, //
+            &AsyncImageProvider<ColorWheelImageParameters>::interlacingPassCompleted, //
+            this,
+            &ChromaHueDiagram::callUpdate);
 
     // Initialize the color
     setCurrentColor(CielchD50Values::srgbVersatileInitialColor);
@@ -85,9 +96,91 @@ ChromaHueDiagram::~ChromaHueDiagram() noexcept
  *                   should operate. */
 ChromaHueDiagramPrivate::ChromaHueDiagramPrivate(ChromaHueDiagram *backLink, const QSharedPointer<PerceptualColor::RgbColorSpace> &colorSpace)
     : m_currentColor{0, 0, 0} // dummy value
-    , m_wheelImage(colorSpace)
     , q_pointer(backLink)
 {
+    m_wheelImageParameters.rgbColorSpace = colorSpace;
+}
+
+/** @brief Whether the lightness is currently dragged.
+ *
+ * @returns <tt>true</tt> if the lightness has changed recently in quick
+ * succession (typically because the user moves a lightness slider),
+ * <tt>false</tt> otherwise. This is the interaction state of the
+ * widget, so that the end of a drag is detected only once.
+ *
+ * @sa @ref AbstractDiagram::isInteracting() */
+bool ChromaHueDiagramPrivate::isLightnessDragging() const
+{
+    return q_pointer->isInteracting();
+}
+
+/** @brief Updates @ref m_lightnessVelocity after a lightness change.
+ *
+ * @pre The lightness change has been registered
+ * with @ref AbstractDiagram::registerInteraction().
+ *
+ * @param oldLightness The previous lightness
+ * @param newLightness The new lightness */
+void ChromaHueDiagramPrivate::updateLightnessVelocity(const qreal oldLightness, const qreal newLightness)
+{
+    const bool isContinuation = //
+        m_lightnessChangeTimer.isValid() && isLightnessDragging();
+    // Avoid division by zero for changes within the same millisecond.
+    const auto elapsed = qMax<qint64>(1, m_lightnessChangeTimer.restart());
+    m_lightnessVelocity = isContinuation //
+        ? (newLightness - oldLightness) / static_cast<qreal>(elapsed) //
+        : 0;
+}
+
+/** @brief The lightness that is used to render the diagram.
+ *
+ * @returns The lightness of @ref m_currentColor, bound to the valid
+ * range. While the lightness is dragged, it is rounded to an integer:
+ * That is precise enough during the fast movement, but makes the
+ * predictions of @ref prefetchLightnessSlices() reusable. Once the drag
+ * has ended, the exact value is used again. */
+qreal ChromaHueDiagramPrivate::renderedLightness() const
+{
+    const qreal lightness = qBound(static_cast<qreal>(0), //
+                                   m_currentColor.l, //
+                                   static_cast<qreal>(100));
+    if (isLightnessDragging()) {
+        return qRound(lightness);
+    }
+    return lightness;
+}
+
+/** @brief Prefetches the diagram images for the lightness values
+ * that will probably be needed next.
+ *
+ * While the lightness is dragged, the next lightness values are predicted
+ * from the drag velocity. Their images are rendered in the background
+ * with idle priority into the history cache of @ref m_chromaHueImage.
+ * CPU usage is limited by using only a single thread and by the
+ * idle priority; memory usage is limited by the history cache limit.
+ * As soon as a real rendering request arrives that is not yet available,
+ * the prefetching stops. It starts again only once the real request has
+ * delivered its final image.
+ *
+ * @pre @ref m_chromaHueImageParameters is up-to-date. */
+void ChromaHueDiagramPrivate::prefetchLightnessSlices()
+{
+    if (!isLightnessDragging()) {
+        return;
+    }
+    QList<ChromaHueImageParameters> predictions;
+    ChromaHueImageParameters parameters = m_chromaHueImageParameters;
+    parameters.threadCount = 1;
+    for (int i = 1; i <= lightnessPredictionCount; ++i) {
+        const qreal predictedLightness = m_chromaHueImageParameters.lightness //
+            + m_lightnessVelocity * lightnessPredictionStep * i;
+        parameters.lightness = qBound(0, qRound(predictedLightness), 100);
+        if ((parameters != m_chromaHueImageParameters) //
+            && !predictions.contains(parameters)) {
+            predictions.append(parameters);
+        }
+    }
+    m_chromaHueImage.prefetchAsync(predictions);
 }
 
 /** @brief React on a mouse press event.
@@ -410,10 +503,11 @@ void ChromaHueDiagram::setCurrentColor(const LchDouble &newCurrentColor)
 
     // Update, if necessary, the diagram.
     if (d_pointer->m_currentColor.l != oldColor.l) {
-        const qreal temp = qBound(static_cast<qreal>(0), //
-                                  d_pointer->m_currentColor.l, //
-                                  static_cast<qreal>(100));
-        d_pointer->m_chromaHueImageParameters.lightness = temp;
+        registerInteraction();
+        d_pointer->updateLightnessVelocity(oldColor.l, //
+                                           d_pointer->m_currentColor.l);
+        d_pointer->m_chromaHueImageParameters.lightness = //
+            d_pointer->renderedLightness();
         // TODO xxx Enable this line one the performance problem is solved.
         // This is meant to free memory in the cache if the widget is
         // not currently visible.
@@ -462,17 +556,10 @@ qreal ChromaHueDiagramPrivate::diagramOffset() const
  * @param event The corresponding resize event */
 void ChromaHueDiagram::resizeEvent(QResizeEvent *event)
 {
-    Q_UNUSED(event)
+    AbstractDiagram::resizeEvent(event);
 
-    // Update the widget content
-    d_pointer->m_wheelImage.setImageSize(maximumPhysicalSquareSize());
-    d_pointer->m_chromaHueImageParameters.imageSizePhysical =
-        // Guaranteed to be ≥ 0:
-        maximumPhysicalSquareSize();
-    // TODO xxx Enable this line once the performance problem is solved.
-    // This is meant to free memory in the cache if the widget is
-    // not currently visible.
-    // d_pointer->m_chromaHueImage.setImageParameters(d_pointer->m_chromaHueImageParameters);
+    // The image sizes are not updated here, but in paintEvent(), which
+    // delays the rendering for the new size while isResizing().
 
     // As Qt documentation says:
     //     “The widget will be erased and receive a paint event
@@ -670,30 +757,52 @@ void ChromaHueDiagram::paintEvent(QPaintEvent *event)
     bufferPainter.setRenderHint(QPainter::Antialiasing, false);
     // As devicePixelRatioF() might have changed, we make sure everything
     // that might depend on devicePixelRatioF() is updated before painting.
-    d_pointer->m_chromaHueImageParameters.borderPhysical =
-        // TODO It might be useful to reduce this border to (near to) zero, and
-        // than paint with an offset (if this is possible with drawEllipse?).
-        // Then the memory consumption would be reduced somewhat.
-        d_pointer->diagramBorder() * devicePixelRatioF();
-    d_pointer->m_chromaHueImageParameters.imageSizePhysical =
-        // Guaranteed to be ≥ 0:
-        maximumPhysicalSquareSize();
-    const qreal temp = qBound(static_cast<qreal>(0), //
-                              d_pointer->m_currentColor.l, //
-                              static_cast<qreal>(100));
-    d_pointer->m_chromaHueImageParameters.lightness = temp;
-    d_pointer->m_chromaHueImageParameters.devicePixelRatioF = //
-        devicePixelRatioF();
+    // While the widget is resized, we keep the image size of the
+    // image that we have yet: Rendering all the intermediate sizes would be
+    // wasted effort. Once the size is stable, we get a new paint event.
+    const bool keepImageSize = isResizing() //
+        && !d_pointer->m_chromaHueImage.getCache().isNull();
+    if (!keepImageSize) {
+        // While the user interacts, we render at reduced resolution,
+        // which keeps the logical size of the image unchanged.
+        const qreal scale = renderScale();
+        d_pointer->m_chromaHueImageParameters.borderPhysical =
+            // TODO It might be useful to reduce this border to (near to) zero,
+            // and than paint with an offset (if this is possible with
+            // drawEllipse?). Then the memory consumption would be reduced
+            // somewhat.
+            d_pointer->diagramBorder() * devicePixelRatioF() * scale;
+        d_pointer->m_chromaHueImageParameters.imageSizePhysical =
+            // Guaranteed to be ≥ 0:
+            qRound(maximumPhysicalSquareSize() * scale);
+        d_pointer->m_chromaHueImageParameters.devicePixelRatioF = //
+            devicePixelRatioF() * scale;
+    }
+    d_pointer->m_chromaHueImageParameters.lightness = //
+        d_pointer->renderedLightness();
     d_pointer->m_chromaHueImageParameters.rgbColorSpace = //
         d_pointer->m_rgbColorSpace;
     d_pointer->m_chromaHueImage.setImageParameters( //
         d_pointer->m_chromaHueImageParameters);
     d_pointer->m_chromaHueImage.refreshAsync();
+    d_pointer->prefetchLightnessSlices();
     const qreal circleRadius = //
         (maximumWidgetSquareSize() - 2 * d_pointer->diagramBorder()) / 2.0;
     bufferPainter.setRenderHint(QPainter::Antialiasing, true);
     bufferPainter.setPen(QPen(Qt::NoPen));
-    bufferPainter.setBrush(d_pointer->m_chromaHueImage.getCache());
+    QImage chromaHueImage = d_pointer->m_chromaHueImage.getCache();
+    if (!chromaHueImage.isNull() //
+        && (chromaHueImage.width() != maximumPhysicalSquareSize())) {
+        // A placeholder while the widget is resized, or an image with
+        // reduced resolution while the user interacts.
+        chromaHueImage = chromaHueImage.scaled( //
+            maximumPhysicalSquareSize(),
+            maximumPhysicalSquareSize(),
+            Qt::AspectRatioMode::IgnoreAspectRatio,
+            Qt::TransformationMode::FastTransformation);
+        chromaHueImage.setDevicePixelRatio(devicePixelRatioF());
+    }
+    bufferPainter.setBrush(chromaHueImage);
     bufferPainter.drawEllipse(
         // center:
         QPointF(maximumWidgetSquareSize() / 2.0, //
@@ -707,16 +816,30 @@ void ChromaHueDiagram::paintEvent(QPaintEvent *event)
     bufferPainter.setRenderHint(QPainter::Antialiasing, false);
     // As devicePixelRatioF() might have changed, we make sure everything
     // that might depend on devicePixelRatioF() is updated before painting.
-    d_pointer->m_wheelImage.setBorder( //
-        spaceForFocusIndicator() * devicePixelRatioF());
-    d_pointer->m_wheelImage.setDevicePixelRatioF(devicePixelRatioF());
-    d_pointer->m_wheelImage.setImageSize(maximumPhysicalSquareSize());
-    d_pointer->m_wheelImage.setWheelThickness( //
-        gradientThickness() * devicePixelRatioF());
-    bufferPainter.drawImage( //
-        QPoint(0, 0), // position of the image
-        d_pointer->m_wheelImage.getImage() // the image itself
-    );
+    d_pointer->m_wheelImageParameters.borderPhysical = //
+        spaceForFocusIndicator() * devicePixelRatioF();
+    d_pointer->m_wheelImageParameters.devicePixelRatioF = devicePixelRatioF();
+    if (!isResizing() || d_pointer->m_wheelImage.getCache().isNull()) {
+        d_pointer->m_wheelImageParameters.imageSizePhysical = //
+            maximumPhysicalSquareSize();
+    }
+    d_pointer->m_wheelImageParameters.wheelThicknessPhysical = //
+        gradientThickness() * devicePixelRatioF();
+    d_pointer->m_wheelImage.setImageParameters( //
+        d_pointer->m_wheelImageParameters);
+    d_pointer->m_wheelImage.refreshAsync();
+    const QImage wheelImage = d_pointer->m_wheelImage.getCache();
+    if (wheelImage.isNull() || (wheelImage.width() == maximumPhysicalSquareSize())) {
+        bufferPainter.drawImage( //
+            QPoint(0, 0), // position of the image
+            wheelImage // the image itself
+        );
+    } else {
+        // Placeholder until the image for the current size is available
+        bufferPainter.drawImage( //
+            QRectF(0, 0, maximumWidgetSquareSize(), maximumWidgetSquareSize()),
+            wheelImage);
+    }
 
     // Paint a handle on the color wheel (only if a mouse event is
     // currently active).
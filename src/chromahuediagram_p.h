@@ -9,10 +9,11 @@
 
 #include "asyncimageprovider.h"
 #include "chromahueimageparameters.h"
-#include "colorwheelimage.h"
+#include "colorwheelimageparameters.h"
 #include "constpropagatingrawpointer.h"
 #include "lchdouble.h"
 #include "lcms2.h"
+#include <qelapsedtimer.h>
 #include <qglobal.h>
 #include <qpoint.h>
 #include <qsharedpointer.h>
@@ -71,21 +72,44 @@ public:
      * circular widget, only reacting on mouse events within the circle;
      * this requires this custom implementation. */
     bool m_isMouseEventActive = false;
+    /** @brief Measures the time since the last lightness change.
+     *
+     * Used to calculate @ref m_lightnessVelocity. */
+    QElapsedTimer m_lightnessChangeTimer;
+    /** @brief The speed of the last lightness change, measured in
+     * lightness units per millisecond. Can be negative. */
+    qreal m_lightnessVelocity = 0;
     /** @brief Pointer to @ref RgbColorSpace object used to describe the
      * color space. */
     QSharedPointer<PerceptualColor::RgbColorSpace> m_rgbColorSpace;
     /** @brief The image of the color wheel. */
-    ColorWheelImage m_wheelImage;
+    AsyncImageProvider<ColorWheelImageParameters> m_wheelImage;
+    /** @brief Properties for @ref m_wheelImage. */
+    ColorWheelImageParameters m_wheelImageParameters;
 
     // Member functions
     [[nodiscard]] int diagramBorder() const;
     [[nodiscard]] QPointF diagramCenter() const;
     [[nodiscard]] qreal diagramOffset() const;
     [[nodiscard]] cmsCIELab fromWidgetPixelPositionToLab(const QPoint position) const;
+    [[nodiscard]] bool isLightnessDragging() const;
     [[nodiscard]] bool isWidgetPixelPositionWithinMouseSensibleCircle(const QPoint widgetCoordinates) const;
+    void prefetchLightnessSlices();
+    [[nodiscard]] qreal renderedLightness() const;
     void setColorFromWidgetPixelPosition(const QPoint position);
+    void updateLightnessVelocity(const qreal oldLightness, const qreal newLightness);
     [[nodiscard]] QPointF widgetCoordinatesFromCurrentColor() const;
 
+    /** @brief Time step between the predicted lightness values,
+     * measured in milliseconds.
+     *
+     * @sa @ref prefetchLightnessSlices() */
+    static constexpr int lightnessPredictionStep = 50;
+    /** @brief Number of lightness values that are predicted.
+     *
+     * @sa @ref prefetchLightnessSlices() */
+    static constexpr int lightnessPredictionCount = 3;
+
 private:
     Q_DISABLE_COPY(ChromaHueDiagramPrivate)
 
@@ -7,23 +7,174 @@
 
 #include "asyncimagerendercallback.h"
 #include "cielchd50values.h"
+#include "gamutboundaryantialiasing.h"
+#include "helper.h"
 #include "helperconstants.h"
 #include "helpermath.h"
+#include "helperposixmath.h"
 #include "interlacingpass.h"
+#include "polarcoordinatetable.h"
 #include "rgbcolorspace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <lcms2.h>
+#include <memory>
+#include <qbitarray.h>
 #include <qcolor.h>
+#include <qglobal.h>
 #include <qimage.h>
-#include <qmath.h>
 #include <qnamespace.h>
-#include <qpainter.h>
 #include <qrgb.h>
 #include <qsharedpointer.h>
 #include <qsize.h>
 #include <type_traits>
+#include <vector>
 
 namespace PerceptualColor
 {
+namespace
+{
+
+/** @internal
+ *
+ * @brief Gamut boundary of a chroma-hue plane in polar coordinates.
+ *
+ * For each hue, it provides a radius below which all colors are in-gamut,
+ * and a radius above which all colors are out-of-gamut. Both radii are
+ * measured in pixels. Between both radii, the exact gamut test is
+ * necessary. */
+struct PolarGamutBoundary {
+    /** @brief Number of hue bins per degree. */
+    double binsPerDegree = 0;
+    /** @brief Radius below which all colors are in-gamut, for each
+     * hue bin. */
+    std::vector<float> innerRadius;
+    /** @brief Radius above which all colors are out-of-gamut, for each
+     * hue bin. */
+    std::vector<float> outerRadius;
+
+    /** @brief The hue bin.
+     *
+     * @param hueDegree The hue, measured in degree. Range:
+     *        <tt>[0°, 360°[</tt>
+     *
+     * @returns The index of the corresponding hue bin. */
+    [[nodiscard]] std::size_t bin(const float hueDegree) const
+    {
+        const auto result = static_cast<std::size_t>(hueDegree * binsPerDegree);
+        return qMin(result, innerRadius.size() - 1);
+    }
+
+    [[nodiscard]] bool calculate(const RgbColorSpace &colorSpace, const double lightness, const double maximumChroma, const double chromaPerPixel);
+};
+
+/** @brief Calculates the gamut boundary.
+ *
+ * For each hue, the maximum in-gamut chroma is searched by bisection. All
+ * hues are processed together, so that each bisection step needs only a
+ * single call to the batch gamut test. The bisection uses the approximate
+ * gamut test, the verification the exact one.
+ *
+ * The bisection assumes that the gamut is star-shaped around the gray
+ * axis: Along each hue, all colors up to the maximum chroma are in-gamut,
+ * and all colors beyond are out-of-gamut. This is verified with samples
+ * along each hue.
+ *
+ * @param colorSpace The color space
+ * @param lightness The lightness
+ * @param maximumChroma Chroma beyond which no pixels are rendered
+ * @param chromaPerPixel The chroma that corresponds to the size of a pixel
+ *
+ * @returns <tt>true</tt> on success. <tt>false</tt> if the gamut is not
+ * star-shaped around the gray axis at this lightness. The object is in an
+ * undefined state then. */
+bool PolarGamutBoundary::calculate(const RgbColorSpace &colorSpace, const double lightness, const double maximumChroma, const double chromaPerPixel)
+{
+    if (!colorSpace.isCielabD50InGamut(cmsCIELab{lightness, 0, 0})) {
+        return false;
+    }
+
+    // The distance between two hues at the maximum chroma should not be
+    // more than one pixel.
+    const double circumference = 2 * pi * maximumChroma / chromaPerPixel;
+    const auto hueCount = static_cast<std::size_t>( //
+        qBound(360., std::ceil(circumference), 8192.));
+    binsPerDegree = static_cast<double>(hueCount) / 360;
+    std::vector<double> hueCosine(hueCount);
+    std::vector<double> hueSine(hueCount);
+    for (std::size_t i = 0; i < hueCount; ++i) {
+        const double hueRadian = 2 * pi * static_cast<double>(i) / static_cast<double>(hueCount);
+        hueCosine[i] = std::cos(hueRadian);
+        hueSine[i] = std::sin(hueRadian);
+    }
+
+    // Bisection for all hues at once. Precision: A quarter of a pixel.
+    std::vector<double> lowerChroma(hueCount, 0); // in-gamut
+    std::vector<double> upperChroma(hueCount, maximumChroma); // out-of-gamut
+    std::vector<cmsCIELab> lab(hueCount);
+    const auto inGamut = std::make_unique<bool[]>(hueCount);
+    const auto count = static_cast<qsizetype>(hueCount);
+    for (double range = maximumChroma; range > chromaPerPixel / 4; range /= 2) {
+        for (std::size_t i = 0; i < hueCount; ++i) {
+            const double chroma = (lowerChroma[i] + upperChroma[i]) / 2;
+            lab[i] = cmsCIELab{lightness, chroma * hueCosine[i], chroma * hueSine[i]};
+        }
+        colorSpace.isCielabD50InGamutApproximate(lab.data(), inGamut.get(), count);
+        for (std::size_t i = 0; i < hueCount; ++i) {
+            const double chroma = (lowerChroma[i] + upperChroma[i]) / 2;
+            if (inGamut[i]) {
+                lowerChroma[i] = chroma;
+            } else {
+                upperChroma[i] = chroma;
+            }
+        }
+    }
+
+    // Verify samples along each hue, with a distance of some pixels.
+    const double sampleDistance = 8 * chromaPerPixel;
+    std::vector<cmsCIELab> samples;
+    std::vector<bool> expectedInGamut;
+    for (std::size_t i = 0; i < hueCount; ++i) {
+        for (double chroma = sampleDistance; chroma < maximumChroma; chroma += sampleDistance) {
+            const bool isInterior = chroma < lowerChroma[i] - chromaPerPixel;
+            const bool isExterior = chroma > upperChroma[i] + chromaPerPixel;
+            if (isInterior || isExterior) {
+                samples.push_back( //
+                    cmsCIELab{lightness, chroma * hueCosine[i], chroma * hueSine[i]});
+                expectedInGamut.push_back(isInterior);
+            }
+        }
+    }
+    if (!samples.empty()) {
+        const auto samplesInGamut = std::make_unique<bool[]>(samples.size());
+        colorSpace.isCielabD50InGamut(samples.data(), //
+                                      samplesInGamut.get(),
+                                      static_cast<qsizetype>(samples.size()));
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            if (samplesInGamut[i] != expectedInGamut[i]) {
+                return false;
+            }
+        }
+    }
+
+    // A bin covers the hues between two neighboring hues of the
+    // bisection. A margin covers the boundary between both hues.
+    constexpr double marginPixels = 1.5;
+    innerRadius.resize(hueCount);
+    outerRadius.resize(hueCount);
+    for (std::size_t i = 0; i < hueCount; ++i) {
+        const std::size_t next = (i + 1) % hueCount;
+        innerRadius[i] = static_cast<float>( //
+            qMin(lowerChroma[i], lowerChroma[next]) / chromaPerPixel - marginPixels);
+        outerRadius[i] = static_cast<float>( //
+            qMax(upperChroma[i], upperChroma[next]) / chromaPerPixel + marginPixels);
+    }
+    return true;
+}
+
+} // namespace
+
 /** @brief Equal operator
  *
  * @param other The object to compare with.
@@ -32,7 +183,9 @@ namespace PerceptualColor
 bool ChromaHueImageParameters::operator==(const ChromaHueImageParameters &other) const
 {
     return ( //
-        (borderPhysical == other.borderPhysical) //
+        (algorithm == other.algorithm) //
+        && (antialiasing == other.antialiasing) //
+        && (borderPhysical == other.borderPhysical) //
         && (devicePixelRatioF == other.devicePixelRatioF) //
         && (imageSizePhysical == other.imageSizePhysical) //
         && (lightness == other.lightness) //
@@ -59,6 +212,10 @@ bool ChromaHueImageParameters::operator!=(const ChromaHueImageParameters &other)
  * This function is thread-safe as long as each call of this function
  * uses different <tt>variantParameters</tt> and <tt>callbackObject</tt>.
  *
+ * Each interlacing pass is rendered in parallel with up to
+ * @ref threadCount threads. <tt>callbackObject.shouldAbort()</tt> is
+ * therefore called from various threads.
+ *
  * @param variantParameters A <tt>QVariant</tt> that contains the
  *        image parameters.
  * @param callbackObject Pointer to the object for the callbacks.
@@ -123,81 +280,188 @@ void ChromaHueImageParameters::render(const QVariant &variantParameters, AsyncIm
     myImage.fill(myNeutralGray);
 
     // Prepare for gamut painting
-    cmsCIELab cielabD50;
-    cielabD50.L = parameters.lightness;
-    int x;
-    int y;
-    QRgb tempColor;
+    const QRgb neutralGrayRgb = myNeutralGray.rgb();
     const auto chromaRange = parameters.rgbColorSpace->profileMaximumCielchD50Chroma();
     const qreal scaleFactor = static_cast<qreal>(2 * chromaRange)
         // The following line will never be 0 because we have have
         // tested above that circleRadius is > 0, so this line will
         // we > 0 also.
         / (parameters.imageSizePhysical - 2 * parameters.borderPhysical);
+    // The distance of a pixel center to the center of the image, measured
+    // in pixels, is independent of the border, because the border is the
+    // same on both sides. Therefore, the gamut circle test can use the
+    // cached radius instead of calculating a square root or a square for
+    // each pixel.
+    const auto polarTable = PolarCoordinateTable::forImageSize( //
+        parameters.imageSizePhysical);
+    const qreal maximumRadius = (chromaRange + overlap) / scaleFactor;
 
     // Paint the gamut.
-    // The pixel at position QPoint(x, y) is the square with the top-left
-    // edge at coordinate point QPoint(x, y) and the bottom-right edge at
-    // coordinate point QPoint(x+1, y+1). This pixel is supposed to have
-    // the color from coordinate point QPoint(x+0.5, y+0.5), which is
+    // The pixel at position QPoint(x, y) is the square with the top-left
+    // edge at coordinate point QPoint(x, y) and the bottom-right edge at
+    // coordinate point QPoint(x+1, y+1). This pixel is supposed to have
+    // the color from coordinate point QPoint(x+0.5, y+0.5), which is
     // the middle of this pixel. Therefore, with an offset of 0.5 we
     // can convert from the pixel position to the point in the middle of
     // the pixel.
     constexpr qreal pixelOffset = 0.5;
-    // TODO Could this be further optimized? For example not go from zero
-    // up to imageSizePhysical, but exclude the border (and add the
-    // tolerance)? Thought anyway the color transform (which is the heavy
-    // work) is only done when within a given diameter, reducing loop runs
-    // itself might also increase performance at least a little bit…
+    // With Algorithm::PolarBoundary, the gamut boundary is calculated
+    // first. Profiles with a color lookup table can have arbitrary gamut
+    // shapes and are always rendered with Algorithm::Exhaustive.
+    PolarGamutBoundary polarBoundary;
+    const bool usePolarBoundary = //
+        (parameters.algorithm == Algorithm::PolarBoundary) //
+        && !parameters.rgbColorSpace->profileHasClut() //
+        && polarBoundary.calculate(*parameters.rgbColorSpace, //
+                                   parameters.lightness,
+                                   chromaRange + overlap,
+                                   scaleFactor);
+    if (callbackObject.shouldAbort()) {
+        return;
+    }
+
+    // Each pass is split into bands of lines. The bands are rendered in
+    // parallel. Each line of a band is collected first and then converted
+    // all together with a single call to the batch conversion of
+    // RgbColorSpace, which is thread-safe. The result is written directly
+    // into the memory of the image. Different lines of a pass never write
+    // to the same pixels, because the rectangles of a pass are never
+    // higher than the line frequency. The passes themselves are still
+    // delivered one after another in the correct order.
+    constexpr int linesPerBand = 16;
+    // The gamut membership of each pixel, for the anti-aliasing. One byte
+    // per pixel, because the bands write to it in parallel.
+    std::vector<quint8> inGamut( //
+        parameters.antialiasing //
+            ? static_cast<std::size_t>(parameters.imageSizePhysical) //
+                * static_cast<std::size_t>(parameters.imageSizePhysical)
+            : 0,
+        0);
+    const auto lineCapacity = static_cast<std::size_t>(parameters.imageSizePhysical);
     constexpr auto numberOfPasses = 11;
     static_assert(isOdd(numberOfPasses));
     InterlacingPass currentPass{numberOfPasses};
-    QPainter myPainter(&myImage);
-    myPainter.setRenderHint(QPainter::Antialiasing, false);
     while (true) {
-        for (y = currentPass.lineOffset; //
-             y < parameters.imageSizePhysical; //
-             y += currentPass.lineFrequency) //
-        {
-            if (callbackObject.shouldAbort()) {
-                return;
-            }
-            cielabD50.b = chromaRange //
-                - (y + pixelOffset - parameters.borderPhysical) * scaleFactor;
-            for (x = currentPass.columnOffset; //
-                 x < parameters.imageSizePhysical; //
-                 x += currentPass.columnFrequency //
-            ) {
-                cielabD50.a = //
-                    (x + pixelOffset - parameters.borderPhysical) * scaleFactor //
-                    - chromaRange;
-                if ( //
-                    (qPow(cielabD50.a, 2) + qPow(cielabD50.b, 2)) //
-                    <= (qPow(chromaRange + overlap, 2)) //
+        // bits() detaches the image from copies that have been delivered
+        // before. It must be called here, before the parallel rendering.
+        uchar *const imageBits = myImage.bits();
+        const auto bytesPerLine = myImage.bytesPerLine();
+        const int lineCount = //
+            (parameters.imageSizePhysical - currentPass.lineOffset //
+             + currentPass.lineFrequency - 1)
+            / currentPass.lineFrequency;
+        const int bandCount = (lineCount + linesPerBand - 1) / linesPerBand;
+        const auto renderBand = [&](const int band) {
+            // Colors that need the exact gamut test
+            std::vector<cmsCIELab> exactCielabD50;
+            std::vector<int> exactX;
+            // Colors that are known to be in-gamut
+            std::vector<cmsCIELab> interiorCielabD50;
+            std::vector<int> interiorX;
+            // Colors that are known to be out-of-gamut
+            std::vector<int> exteriorX;
+            std::vector<QRgb> lineRgb(lineCapacity);
+            exactCielabD50.reserve(lineCapacity);
+            exactX.reserve(lineCapacity);
+            interiorCielabD50.reserve(lineCapacity);
+            interiorX.reserve(lineCapacity);
+            exteriorX.reserve(lineCapacity);
+            cmsCIELab cielabD50;
+            cielabD50.L = parameters.lightness;
+            const int firstLineIndex = band * linesPerBand;
+            const int lastLineIndex = qMin(firstLineIndex + linesPerBand, lineCount);
+            for (int lineIndex = firstLineIndex; lineIndex < lastLineIndex; ++lineIndex) {
+                if (callbackObject.shouldAbort()) {
+                    return;
+                }
+                const int y = currentPass.lineOffset //
+                    + lineIndex * currentPass.lineFrequency;
+                cielabD50.b = chromaRange //
+                    - (y + pixelOffset - parameters.borderPhysical) * scaleFactor;
+                exactCielabD50.clear();
+                exactX.clear();
+                interiorCielabD50.clear();
+                interiorX.clear();
+                exteriorX.clear();
+                for (int x = currentPass.columnOffset; //
+                     x < parameters.imageSizePhysical; //
+                     x += currentPass.columnFrequency //
                 ) {
-                    tempColor = parameters //
-                                    .rgbColorSpace //
-                                    ->fromCielabD50ToQRgbOrTransparent(cielabD50);
-                    if (qAlpha(tempColor) != 0) {
-                        // The pixel is within the gamut!
-                        myPainter.fillRect(
-                            //
-                            x, //
-                            y, //
-                            currentPass.rectangleSize.width(), //
-                            currentPass.rectangleSize.height(), //
-                            QColor(tempColor));
+                    const float radius = polarTable->radius(x, y);
+                    if (radius > maximumRadius) {
+                        continue;
+                    }
+                    cielabD50.a = //
+                        (x + pixelOffset - parameters.borderPhysical) * scaleFactor //
+                        - chromaRange;
+                    if (!usePolarBoundary) {
+                        exactCielabD50.push_back(cielabD50);
+                        exactX.push_back(x);
+                        continue;
+                    }
+                    const auto bin = polarBoundary.bin(polarTable->angleDegree(x, y));
+                    if (radius < polarBoundary.innerRadius[bin]) {
+                        interiorCielabD50.push_back(cielabD50);
+                        interiorX.push_back(x);
+                    } else if (radius > polarBoundary.outerRadius[bin]) {
+                        exteriorX.push_back(x);
                     } else {
-                        myPainter.fillRect(
-                            //
-                            x, //
-                            y, //
-                            currentPass.rectangleSize.width(), //
-                            currentPass.rectangleSize.height(), //
-                            myNeutralGray);
+                        exactCielabD50.push_back(cielabD50);
+                        exactX.push_back(x);
                     }
                 }
+                // Write the rectangles of this pass directly into the memory
+                // of the image. Colors out of gamut are transparent and get
+                // the neutral gray background. All other colors are opaque,
+                // so they are valid also for the premultiplied image format.
+                const int lastLine = qMin( //
+                    y + currentPass.rectangleSize.height(),
+                    parameters.imageSizePhysical);
+                const auto writeRectangles = [&](const std::vector<int> &xList, //
+                                                 const QRgb *colors) {
+                    if (!inGamut.empty()) {
+                        const auto lineIndex = static_cast<std::size_t>(y) //
+                            * static_cast<std::size_t>(parameters.imageSizePhysical);
+                        for (std::size_t i = 0; i < xList.size(); ++i) {
+                            inGamut[lineIndex + static_cast<std::size_t>(xList[i])] = //
+                                (colors != nullptr) && (qAlpha(colors[i]) != 0);
+                        }
+                    }
+                    for (int line = y; line < lastLine; ++line) {
+                        auto *const scanLine = reinterpret_cast<QRgb *>( //
+                            imageBits + static_cast<qsizetype>(line) * bytesPerLine);
+                        for (std::size_t i = 0; i < xList.size(); ++i) {
+                            const int first = xList[i];
+                            const int last = qMin( //
+                                first + currentPass.rectangleSize.width(),
+                                parameters.imageSizePhysical);
+                            const QRgb color = (colors == nullptr) //
+                                ? neutralGrayRgb
+                                : ((qAlpha(colors[i]) != 0) ? colors[i] : neutralGrayRgb);
+                            std::fill(scanLine + first, scanLine + last, color);
+                        }
+                    }
+                };
+                if (!exactX.empty()) {
+                    parameters.rgbColorSpace->fromCielabD50ToQRgbOrTransparent( //
+                        exactCielabD50.data(),
+                        lineRgb.data(),
+                        static_cast<qsizetype>(exactX.size()));
+                    writeRectangles(exactX, lineRgb.data());
+                }
+                if (!interiorX.empty()) {
+                    parameters.rgbColorSpace->fromCielabD50ToQRgbBound( //
+                        interiorCielabD50.data(),
+                        lineRgb.data(),
+                        static_cast<qsizetype>(interiorX.size()));
+                    writeRectangles(interiorX, lineRgb.data());
+                }
+                writeRectangles(exteriorX, nullptr);
             }
+        };
+        runInParallel(bandCount, parameters.threadCount, renderBand);
+        if (callbackObject.shouldAbort()) {
+            return;
         }
 
         const AsyncImageRenderCallback::InterlacingState state = //
@@ -205,6 +469,35 @@ void ChromaHueImageParameters::render(const QVariant &variantParameters, AsyncIm
             ? AsyncImageRenderCallback::InterlacingState::Intermediate //
             : AsyncImageRenderCallback::InterlacingState::Final;
 
+        // Out-of-gamut subsamples get the neutral gray background.
+        if ((state == AsyncImageRenderCallback::InterlacingState::Final) //
+            && parameters.antialiasing) {
+            QBitArray mask(static_cast<int>(inGamut.size()), false);
+            for (std::size_t i = 0; i < inGamut.size(); ++i) {
+                if (inGamut[i] != 0) {
+                    mask.setBit(static_cast<int>(i));
+                }
+            }
+            const auto cielabD50 = [&](const double x, const double y) {
+                return cmsCIELab{parameters.lightness,
+                                 (x - parameters.borderPhysical) * scaleFactor - chromaRange,
+                                 chromaRange - (y - parameters.borderPhysical) * scaleFactor};
+            };
+            const bool completed = GamutBoundaryAntialiasing::apply( //
+                myImage,
+                mask,
+                *parameters.rgbColorSpace,
+                cielabD50,
+                neutralGrayRgb,
+                GamutBoundaryAntialiasing::Pixels::All,
+                parameters.threadCount,
+                callbackObject,
+                nullptr);
+            if (!completed) {
+                return;
+            }
+        }
+
         myImage.setDevicePixelRatio(parameters.devicePixelRatioF);
         callbackObject.deliverInterlacingPass(myImage, variantParameters, state);
         myImage.setDevicePixelRatio(1);
@@ -32,7 +32,9 @@ class RgbColorSpace;
  *
  * Each pixel has the color that corresponds to the coordinate point <em>at
  * the middle</em> of the pixel for in-gamut coordinate points, and
- * a solid background color for out-of-gamut coordinate points.
+ * a solid background color for out-of-gamut coordinate points. With
+ * @ref antialiasing, the pixels at the gamut boundary of the final image
+ * are a mix of both instead.
  *
  * The <tt>QImage</tt> that is provided by this class has the
  * size <tt>QSize(@ref ChromaHueImageParameters::imageSizePhysical,
@@ -66,6 +68,33 @@ class RgbColorSpace;
  * be emitted, which will create a copy anyway… */
 struct ChromaHueImageParameters final {
 public:
+    /** @brief Algorithms for @ref render(). */
+    enum class Algorithm {
+        /** @brief Exact gamut test for each pixel within the circle. */
+        Exhaustive,
+        /** @brief Exact gamut test only near the gamut boundary.
+         *
+         * At the given lightness, the maximum in-gamut chroma is
+         * calculated for each hue first. Pixels well within this polar
+         * boundary are converted with a forward transform only. Pixels
+         * well beyond get the background color without any transform.
+         * Only the pixels near the boundary get the exact gamut test.
+         *
+         * This requires that the gamut is star-shaped around the gray
+         * axis at the given lightness. This is verified by samples; if the
+         * verification fails, and also for profiles with a color lookup
+         * table, @ref Algorithm::Exhaustive is used instead. */
+        PolarBoundary
+    };
+
+    /** @brief The algorithm for @ref render(). */
+    Algorithm algorithm = Algorithm::PolarBoundary;
+    /** @brief Anti-aliasing of the gamut boundary.
+     *
+     * If <tt>true</tt>, the final image gets an additional pass that
+     * supersamples the pixels at the gamut boundary. See
+     * @ref GamutBoundaryAntialiasing for details. */
+    bool antialiasing = true;
     /** @brief The border size, measured in physical pixels. */
     qreal borderPhysical = 0;
     /** @brief The device pixel ratio as floating point. */
@@ -84,6 +113,13 @@ public:
      * @ref rgbColorSpace. Before using this object, you must initialize
      * @ref rgbColorSpace. */
     QSharedPointer<PerceptualColor::RgbColorSpace> rgbColorSpace = nullptr;
+    /** @brief Maximum number of threads for rendering.
+     *
+     * <tt>0</tt> means <tt>QThread::idealThreadCount()</tt>.
+     *
+     * The rendered image does not depend on this value, therefore it is
+     * ignored by @ref operator==(). */
+    int threadCount = 0;
     [[nodiscard]] bool operator==(const ChromaHueImageParameters &other) const;
     [[nodiscard]] bool operator!=(const ChromaHueImageParameters &other) const;
 
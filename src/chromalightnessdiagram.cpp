@@ -27,6 +27,7 @@
 #include <qrect.h>
 #include <qrgb.h>
 #include <qsharedpointer.h>
+#include <qsize.h>
 #include <qsizepolicy.h>
 #include <qwidget.h>
 #include <type_traits>
@@ -57,6 +58,11 @@ ChromaLightnessDiagram::ChromaLightnessDiagram(const QSharedPointer<PerceptualCo
     d_pointer->m_chromaLightnessImage.setImageParameters( //
         d_pointer->m_chromaLightnessImageParameters);
 
+    // Keep the images of previous hue values, which are shown
+    // again when the user moves the hue back and forth.
+    d_pointer->m_chromaLightnessImage.setHistoryCacheLimitInBytes( //
+        diagramHistoryCacheLimitInBytes);
+
     // Connections
     connect(&d_pointer->m_chromaLightnessImage, //
             &AsyncImageProvider<ChromaLightnessImageParameters>::interlacingPassCompleted, //
@@ -302,6 +308,17 @@ void ChromaLightnessDiagram::paintEvent(QPaintEvent *event)
     painter.setRenderHint(QPainter::Antialiasing, false);
 
     // Paint the diagram itself.
+    // While the widget is resized, we keep the image size of the image
+    // that we have yet: Rendering all the intermediate sizes would be
+    // wasted effort. Once the size is stable, we get a new paint event.
+    // While the user interacts, we render at reduced resolution.
+    const QSize imageSize = d_pointer->calculateImageSizePhysical();
+    if (!isResizing() || d_pointer->m_chromaLightnessImage.getCache().isNull()) {
+        d_pointer->m_chromaLightnessImageParameters.imageSizePhysical = //
+            imageSize * renderScale();
+        d_pointer->m_chromaLightnessImage.setImageParameters( //
+            d_pointer->m_chromaLightnessImageParameters);
+    }
     // Request image update. If the cache is not up-to-date, this
     // will trigger a new paint event, once the cache has been updated.
     d_pointer->m_chromaLightnessImage.refreshAsync();
@@ -309,8 +326,6 @@ void ChromaLightnessDiagram::paintEvent(QPaintEvent *event)
         d_pointer->m_rgbColorSpace->fromCielchD50ToQRgbBound(CielchD50Values::neutralGray);
     painter.setPen(Qt::NoPen);
     painter.setBrush(myNeutralGray);
-    const auto imageSize = //
-        d_pointer->m_chromaLightnessImage.imageParameters().imageSizePhysical;
     painter.drawRect( // Paint diagram background
                       // Operating in physical pixels:
         d_pointer->leftBorderPhysical(), // x position (top-left)
@@ -318,9 +333,12 @@ void ChromaLightnessDiagram::paintEvent(QPaintEvent *event)
         imageSize.width(),
         imageSize.height());
     painter.drawImage( // Paint the diagram itself as available in the cache.
-                       // Operating in physical pixels:
-        d_pointer->leftBorderPhysical(), // x position (top-left)
-        d_pointer->defaultBorderPhysical(), // y position (top-left)
+                       // Operating in physical pixels. While the image does
+                       // not have the current size (during resizing or
+                       // interaction), it is scaled.
+        QRect(QPoint(d_pointer->leftBorderPhysical(), // x position (top-left)
+                     d_pointer->defaultBorderPhysical()), // y position (top-left)
+              imageSize),
         d_pointer->m_chromaLightnessImage.getCache() // image
     );
 
@@ -544,6 +562,7 @@ void ChromaLightnessDiagram::setCurrentColor(const PerceptualColor::LchDouble &n
             d_pointer->m_currentColor.h;
         d_pointer->m_chromaLightnessImage.setImageParameters( //
             d_pointer->m_chromaLightnessImageParameters);
+        registerInteraction();
     }
     update(); // Schedule a paint event
     Q_EMIT currentColorChanged(newCurrentColor);
@@ -556,11 +575,9 @@ void ChromaLightnessDiagram::setCurrentColor(const PerceptualColor::LchDouble &n
  * @param event The corresponding event */
 void ChromaLightnessDiagram::resizeEvent(QResizeEvent *event)
 {
-    Q_UNUSED(event)
-    d_pointer->m_chromaLightnessImageParameters.imageSizePhysical = //
-        d_pointer->calculateImageSizePhysical();
-    d_pointer->m_chromaLightnessImage.setImageParameters( //
-        d_pointer->m_chromaLightnessImageParameters);
+    AbstractDiagram::resizeEvent(event);
+    // The image size is not updated here, but in paintEvent(), which
+    // delays the rendering for the new size while isResizing().
     // As by Qt documentation:
     //     “The widget will be erased and receive a paint event
     //      immediately after processing the resize event. No drawing
@@ -783,6 +800,11 @@ ChromaLightnessDiagramPrivate::nearestNeighborSearch(const QPoint point, const Q
  * used to reduce the search rectangle significantly. */
 std::optional<QPoint> ChromaLightnessDiagramPrivate::nearestInGamutPixelPosition(const QPoint originalPixelPosition)
 {
+    // Make sure that the image has the current size, even while the
+    // widget is resized.
+    m_chromaLightnessImageParameters.imageSizePhysical = //
+        calculateImageSizePhysical();
+    m_chromaLightnessImage.setImageParameters(m_chromaLightnessImageParameters);
     m_chromaLightnessImage.refreshSync();
     const auto upToDateImage = m_chromaLightnessImage.getCache();
 
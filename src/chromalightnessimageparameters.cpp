@@ -6,14 +6,21 @@
 #include "chromalightnessimageparameters.h"
 
 #include "asyncimagerendercallback.h"
-#include "helperconversion.h"
+#include "gamutboundaryantialiasing.h"
 #include "helpermath.h"
+#include "interlacingpass.h"
 #include "rgbcolorspace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <lcms2.h>
 #include <qbitarray.h>
+#include <qglobal.h>
 #include <qimage.h>
+#include <qmath.h>
 #include <qnamespace.h>
 #include <qrgb.h>
+#include <vector>
 
 namespace PerceptualColor
 {
@@ -26,7 +33,9 @@ namespace PerceptualColor
 bool ChromaLightnessImageParameters::operator==(const ChromaLightnessImageParameters &other) const
 {
     return ( //
-        (hue == other.hue) //
+        (algorithm == other.algorithm) //
+        && (antialiasing == other.antialiasing) //
+        && (hue == other.hue) //
         && (imageSizePhysical == other.imageSizePhysical) //
         && (rgbColorSpace == other.rgbColorSpace) //
     );
@@ -42,10 +51,112 @@ bool ChromaLightnessImageParameters::operator!=(const ChromaLightnessImageParame
     return !(*this == other);
 }
 
+/** @brief Converts a line of colors to QRgb.
+ *
+ * @param colorSpace The color space
+ * @param lab Array with the colors of the line. They must be ordered by
+ *        increasing chroma, beginning near the gray axis, and have all the
+ *        same lightness and hue.
+ * @param result Array that will receive the results: The corresponding
+ *        opaque color if the original color is in-gamut. A transparent
+ *        color otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements.
+ * @param algorithm The algorithm. See @ref Algorithm for details.
+ * @param statistics If not <tt>nullptr</tt>, the number of transformed
+ *        colors is added to this object. */
+void ChromaLightnessImageParameters::convertLine(const RgbColorSpace &colorSpace, const cmsCIELab *lab, QRgb *result, const qsizetype count, const Algorithm algorithm, TransformStatistics *statistics)
+{
+    TransformStatistics dummyStatistics;
+    TransformStatistics &myStatistics = //
+        (statistics == nullptr) ? dummyStatistics : *statistics;
+    const auto convertExhaustive = [&]() {
+        colorSpace.fromCielabD50ToQRgbOrTransparent(lab, result, count);
+        myStatistics.roundtrip += count;
+    };
+    // Number of pixels on both sides of the boundary that get the exact
+    // gamut test.
+    constexpr qsizetype boundaryMargin = 2;
+    // Distance between the samples that verify the assumption that the
+    // in-gamut region is a single interval beginning at the gray axis.
+    constexpr qsizetype verificationStride = 16;
+    // For short lines, the bisection and the verification are not worth
+    // the effort.
+    constexpr qsizetype minimumCount = 4 * verificationStride;
+    if ((algorithm == Algorithm::Exhaustive) || (count < minimumCount)) {
+        convertExhaustive();
+        return;
+    }
+    // The bisection and the verification use the same round-trip as the
+    // exhaustive conversion (and not the approximate gamut test of the
+    // color space), so that their decisions are exact and each of them
+    // is correctly counted as one round-trip.
+    const auto isInGamutExact = [&colorSpace](const cmsCIELab &color) {
+        return qAlpha(colorSpace.fromCielabD50ToQRgbOrTransparent(color)) != 0;
+    };
+
+    // Find by bisection the first out-of-gamut color, assuming that all
+    // colors before are in-gamut and all colors after are out-of-gamut.
+    ++myStatistics.roundtrip;
+    if (!isInGamutExact(lab[0])) {
+        convertExhaustive();
+        return;
+    }
+    qsizetype lastInGamut = 0;
+    qsizetype firstOutOfGamut = count; // Might be beyond the line.
+    while (firstOutOfGamut - lastInGamut > 1) {
+        const qsizetype middle = lastInGamut + (firstOutOfGamut - lastInGamut) / 2;
+        ++myStatistics.roundtrip;
+        if (isInGamutExact(lab[middle])) {
+            lastInGamut = middle;
+        } else {
+            firstOutOfGamut = middle;
+        }
+    }
+    const qsizetype interiorEnd = qMax<qsizetype>(0, firstOutOfGamut - boundaryMargin);
+    const qsizetype exteriorBegin = qMin(count, firstOutOfGamut + boundaryMargin);
+
+    // Verify some samples of the interior and the exterior. If the
+    // assumption does not hold (non-convex gamut), fall back to the
+    // exact test for the whole line.
+    std::vector<cmsCIELab> samples;
+    for (qsizetype i = verificationStride / 2; i < interiorEnd; i += verificationStride) {
+        samples.push_back(lab[i]);
+    }
+    const std::size_t interiorSampleCount = samples.size();
+    for (qsizetype i = exteriorBegin; i < count; i += verificationStride) {
+        samples.push_back(lab[i]);
+    }
+    if (!samples.empty()) {
+        const auto sampleCount = static_cast<qsizetype>(samples.size());
+        std::vector<QRgb> samplesRgb(samples.size());
+        colorSpace.fromCielabD50ToQRgbOrTransparent(samples.data(), samplesRgb.data(), sampleCount);
+        myStatistics.roundtrip += sampleCount;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const bool expectedInGamut = (i < interiorSampleCount);
+            if ((qAlpha(samplesRgb[i]) != 0) != expectedInGamut) {
+                convertExhaustive();
+                return;
+            }
+        }
+    }
+
+    // The interior needs only the forward transform, the region near the
+    // boundary the exact test, and the exterior no transform at all.
+    colorSpace.fromCielabD50ToQRgbBound(lab, result, interiorEnd);
+    myStatistics.forward += interiorEnd;
+    colorSpace.fromCielabD50ToQRgbOrTransparent(lab + interiorEnd, //
+                                                result + interiorEnd,
+                                                exteriorBegin - interiorEnd);
+    myStatistics.roundtrip += exteriorBegin - interiorEnd;
+    std::fill(result + exteriorBegin, result + count, qRgba(0, 0, 0, 0));
+}
+
 /** @brief Render an image.
  *
  * The function will render the image with the given parameters,
- * and deliver the result by means of <tt>callbackObject</tt>.
+ * and deliver the result of each interlacing pass and also the final
+ * result by means of <tt>callbackObject</tt>.
  *
  * This function is thread-safe as long as each call of this function
  * uses different <tt>variantParameters</tt> and <tt>callbackObject</tt>.
@@ -54,13 +165,25 @@ bool ChromaLightnessImageParameters::operator!=(const ChromaLightnessImageParame
  *        image parameters.
  * @param callbackObject Pointer to the object for the callbacks.
  *
- * @todo Interlacing support.
- *
  * @todo Could we get better performance? Even online tools like
  * https://bottosson.github.io/misc/colorpicker/#ff2a00 or
  * https://oklch.evilmartians.io/#65.4,0.136,146.7,100 get quite good
  * performance. How do they do that? */
 void ChromaLightnessImageParameters::render(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject)
+{
+    renderWithStatistics(variantParameters, callbackObject, nullptr);
+}
+
+/** @brief Render an image.
+ *
+ * Like @ref render(), but reports the number of transformed colors.
+ *
+ * @param variantParameters A <tt>QVariant</tt> that contains the
+ *        image parameters.
+ * @param callbackObject Pointer to the object for the callbacks.
+ * @param statistics If not <tt>nullptr</tt>, the number of transformed
+ *        colors is added to this object. */
+void ChromaLightnessImageParameters::renderWithStatistics(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject, TransformStatistics *statistics)
 {
     if (!variantParameters.canConvert<ChromaLightnessImageParameters>()) {
         return;
@@ -98,52 +221,137 @@ void ChromaLightnessImageParameters::render(const QVariant &variantParameters, A
         return;
     }
 
-    myImage.fill(Qt::transparent); // Initialize background color
-
     // Initialization
-    cmsCIELCh cielchD50;
-    QRgb rgbColor;
-    int x;
-    int y;
     const auto imageHeight = parameters.imageSizePhysical.height();
     const auto imageWidth = parameters.imageSizePhysical.width();
+    // The hue is the same for the whole image, so the conversion from
+    // LCH to Lab needs only a multiplication per pixel.
+    const double hueRadian = //
+        qDegreesToRadians(normalizedAngleDegree(parameters.hue));
+    const double hueCosine = std::cos(hueRadian);
+    const double hueSine = std::sin(hueRadian);
+    std::vector<cmsCIELab> lineCielabD50;
+    std::vector<QRgb> lineRgb;
+    lineCielabD50.reserve(static_cast<std::size_t>(imageWidth));
+    lineRgb.resize(static_cast<std::size_t>(imageWidth));
 
     // Paint the gamut.
-    cielchD50.h = normalizedAngleDegree(parameters.hue);
-    for (y = 0; y < imageHeight; ++y) {
-        if (callbackObject.shouldAbort()) {
-            return;
+    // The first pass covers the whole image with big rectangles, so
+    // there is no need to fill the image with a background color before.
+    // Each pixel is calculated exactly once, in the pass that has this
+    // pixel at the top-left corner of one of its rectangles.
+    const Algorithm algorithm = parameters.rgbColorSpace->profileHasClut() //
+        ? Algorithm::Exhaustive
+        : parameters.algorithm;
+    constexpr auto numberOfPasses = 11;
+    static_assert(isOdd(numberOfPasses));
+    InterlacingPass currentPass{numberOfPasses};
+    while (true) {
+        for (int y = currentPass.lineOffset; //
+             y < imageHeight; //
+             y += currentPass.lineFrequency) //
+        {
+            if (callbackObject.shouldAbort()) {
+                return;
+            }
+            const double lightness = 100 - (y + 0.5) * 100.0 / imageHeight;
+            lineCielabD50.clear();
+            for (int x = currentPass.columnOffset; //
+                 x < imageWidth; //
+                 x += currentPass.columnFrequency) //
+            {
+                // Using the same scale as on the y axis. floating point
+                // division thanks to 100 which is a "cmsFloat64Number"
+                const double chroma = (x + 0.5) * 100.0 / imageHeight;
+                lineCielabD50.push_back( //
+                    cmsCIELab{lightness, chroma * hueCosine, chroma * hueSine});
+            }
+            convertLine(*parameters.rgbColorSpace,
+                        lineCielabD50.data(),
+                        lineRgb.data(),
+                        static_cast<qsizetype>(lineCielabD50.size()),
+                        algorithm,
+                        statistics);
+            // The conversion provides opaque in-gamut colors and fully
+            // transparent out-of-gamut colors. Both are identical in
+            // premultiplied and non-premultiplied form, so the results can
+            // be written directly to the scanlines.
+            const int lastLine = qMin( //
+                y + currentPass.rectangleSize.height(),
+                imageHeight);
+            for (int line = y; line < lastLine; ++line) {
+                auto *const scanLine = //
+                    reinterpret_cast<QRgb *>(myImage.scanLine(line));
+                for (std::size_t i = 0; i < lineCielabD50.size(); ++i) {
+                    const int first = currentPass.columnOffset //
+                        + static_cast<int>(i) * currentPass.columnFrequency;
+                    const int last = qMin( //
+                        first + currentPass.rectangleSize.width(),
+                        imageWidth);
+                    std::fill(scanLine + first, scanLine + last, lineRgb[i]);
+                }
+            }
+            for (std::size_t i = 0; i < lineCielabD50.size(); ++i) {
+                if (qAlpha(lineRgb[i]) != 0) {
+                    // The pixel is within the gamut
+                    const int x = currentPass.columnOffset //
+                        + static_cast<int>(i) * currentPass.columnFrequency;
+                    m_mask.setBit(maskIndex(x, y, parameters.imageSizePhysical), //
+                                  true);
+                    // If color is out-of-gamut: We have chroma on the x axis and
+                    // lightness on the y axis. We are drawing the pixmap line per
+                    // line, so we go for given lightness from low chroma to high
+                    // chroma. Because of the nature of many gamuts, if once in a
+                    // line we have an out-of-gamut value, often all other pixels
+                    // that are more at the right will be out-of-gamut also. So we
+                    // could optimize our code and break here. But as we are not
+                    // sure about this: It’s just likely, but not always correct.
+                    // We do not know the gamut at compile time, so
+                    // for the moment we do not optimize the code.
+                }
+            }
         }
-        cielchD50.L = 100 - (y + 0.5) * 100.0 / imageHeight;
-        for (x = 0; x < imageWidth; ++x) {
-            // Using the same scale as on the y axis. floating point
-            // division thanks to 100 which is a "cmsFloat64Number"
-            cielchD50.C = (x + 0.5) * 100.0 / imageHeight;
-            rgbColor = //
-                parameters.rgbColorSpace->fromCielabD50ToQRgbOrTransparent( //
-                    toCmsLab(cielchD50));
-            if (qAlpha(rgbColor) != 0) {
-                // The pixel is within the gamut
-                myImage.setPixelColor(x, y, rgbColor);
-                m_mask.setBit(maskIndex(x, y, parameters.imageSizePhysical), //
-                              true);
-                // If color is out-of-gamut: We have chroma on the x axis and
-                // lightness on the y axis. We are drawing the pixmap line per
-                // line, so we go for given lightness from low chroma to high
-                // chroma. Because of the nature of many gamuts, if once in a
-                // line we have an out-of-gamut value, often all other pixels
-                // that are more at the right will be out-of-gamut also. So we
-                // could optimize our code and break here. But as we are not
-                // sure about this: It’s just likely, but not always correct.
-                // We do not know the gamut at compile time, so
-                // for the moment we do not optimize the code.
+
+        const AsyncImageRenderCallback::InterlacingState state = //
+            (currentPass.countdown > 1) //
+            ? AsyncImageRenderCallback::InterlacingState::Intermediate //
+            : AsyncImageRenderCallback::InterlacingState::Final;
+
+        // Only the in-gamut pixels are anti-aliased, so that transparent
+        // pixels are still exactly the out-of-gamut pixels.
+        if ((state == AsyncImageRenderCallback::InterlacingState::Final) //
+            && parameters.antialiasing) {
+            const auto cielabD50 = [&](const double x, const double y) {
+                const double lightness = 100 - y * 100.0 / imageHeight;
+                const double chroma = x * 100.0 / imageHeight;
+                return cmsCIELab{lightness, chroma * hueCosine, chroma * hueSine};
+            };
+            const bool completed = GamutBoundaryAntialiasing::apply( //
+                myImage,
+                m_mask,
+                *parameters.rgbColorSpace,
+                cielabD50,
+                qRgba(0, 0, 0, 0),
+                GamutBoundaryAntialiasing::Pixels::InGamutOnly,
+                1,
+                callbackObject,
+                (statistics == nullptr) ? nullptr : &statistics->antialiasing);
+            if (!completed) {
+                return;
             }
         }
+
+        callbackObject.deliverInterlacingPass( //
+            myImage, //
+            QVariant::fromValue(parameters), //
+            state);
+
+        if (state == AsyncImageRenderCallback::InterlacingState::Intermediate) {
+            currentPass.switchToNextPass();
+        } else {
+            return;
+        }
     }
-    callbackObject.deliverInterlacingPass( //
-        myImage, //
-        QVariant::fromValue(parameters), //
-        AsyncImageRenderCallback::InterlacingState::Final);
 }
 
 } // namespace PerceptualColor
@@ -4,8 +4,11 @@
 #ifndef CHROMALIGHTNESSIMAGEPARAMETERS_H
 #define CHROMALIGHTNESSIMAGEPARAMETERS_H
 
+#include "gamutboundaryantialiasing.h"
+#include <lcms2.h>
 #include <qglobal.h>
 #include <qmetatype.h>
+#include <qrgb.h>
 #include <qsharedpointer.h>
 #include <qsize.h>
 #include <qvariant.h>
@@ -38,15 +41,38 @@ class RgbColorSpace;
  * <a href="https://api.kde.org/frameworks/kwidgetsaddons/html/classKBusyIndicatorWidget.html">
  * KBusyIndicatorWidget</a>.
  *
- * @note Intentionally there is no anti-aliasing because this would be much
- * slower: As there is no mathematical description of the shape of the color
- * solid, the only easy way to get anti-aliasing would be to render at a
- * higher resolution (say two times higher, which would yet mean four times
- * more data), and then downscale it to the final resolution. This would be
- * too slow. */
+ * @note As there is no mathematical description of the shape of the color
+ * solid, rendering the whole image at a higher resolution would be the only
+ * easy way to get anti-aliasing, which would be too slow. Instead, with
+ * @ref antialiasing only the in-gamut pixels at the gamut boundary are
+ * supersampled for the final image. They get a partial alpha, but never
+ * become fully transparent: The alpha channel still tells reliably the
+ * gamut membership of the middle of each pixel. */
 class ChromaLightnessImageParameters final
 {
 public:
+    /** @brief Algorithms for @ref render(). */
+    enum class Algorithm {
+        /** @brief Exact gamut test for each pixel. */
+        Exhaustive,
+        /** @brief Exact gamut test only near the gamut boundary.
+         *
+         * For a fixed hue, the in-gamut region of each line of the image
+         * is, for typical gamuts, a single interval that begins at the
+         * gray axis. The gamut boundary of each line is therefore found
+         * by bisection. The pixels within the boundary are converted with
+         * a forward transform only, which is about twice as fast as the
+         * exact gamut test with its round-trip transform. The exact test
+         * is done only for the pixels near to the boundary. Some samples
+         * of the other pixels are verified with the exact test; if the
+         * verification fails (non-convex gamut), the line is rendered
+         * with @ref Algorithm::Exhaustive instead.
+         *
+         * Profiles with a color lookup table can have arbitrary gamut
+         * shapes. For them, @ref Algorithm::Exhaustive is used anyway. */
+        BoundaryTracing
+    };
+
     [[nodiscard]] bool operator==(const ChromaLightnessImageParameters &other) const;
     [[nodiscard]] bool operator!=(const ChromaLightnessImageParameters &other) const;
     static void render(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject);
@@ -59,11 +85,38 @@ public:
     QSize imageSizePhysical;
     /** @brief Pointer to @ref RgbColorSpace object */
     QSharedPointer<PerceptualColor::RgbColorSpace> rgbColorSpace;
+    /** @brief The algorithm for @ref render(). */
+    Algorithm algorithm = Algorithm::BoundaryTracing;
+    /** @brief Anti-aliasing of the gamut boundary.
+     *
+     * If <tt>true</tt>, the final image gets an additional pass that
+     * supersamples the pixels at the gamut boundary. See
+     * @ref GamutBoundaryAntialiasing for details. */
+    bool antialiasing = true;
 
 private:
     /** @internal @brief Only for unit tests. */
     friend class TestChromaLightnessImageParameters;
 
+    /** @brief Number of colors transformed by @ref convertLine(). */
+    struct TransformStatistics {
+        /** @brief Number of colors with only a forward transform. */
+        qint64 forward = 0;
+        /** @brief Number of colors with a round-trip transform (exact
+         * gamut test).
+         *
+         * Includes the gamut tests of the bisection and of the
+         * verification. */
+        qint64 roundtrip = 0;
+        /** @brief Extra work of the anti-aliasing of the gamut boundary.
+         *
+         * Not included in @ref forward and @ref roundtrip. */
+        GamutBoundaryAntialiasing::Statistics antialiasing;
+    };
+
+    static void renderWithStatistics(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject, TransformStatistics *statistics);
+    static void convertLine(const RgbColorSpace &colorSpace, const cmsCIELab *lab, QRgb *result, const qsizetype count, const Algorithm algorithm, TransformStatistics *statistics);
+
     /** @brief Calculate one-dimensional index for given <tt>x</tt> and
      * <tt>y</tt> coordinates.
      *
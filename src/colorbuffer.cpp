@@ -0,0 +1,36 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own header
+#include "colorbuffer.h"
+
+namespace PerceptualColor
+{
+
+/** @brief Constructor
+ *
+ * @param size Number of colors. Negative values are treated as 0. */
+ColorBuffer::ColorBuffer(const qsizetype size)
+{
+    resize(size);
+}
+
+/** @brief Changes the number of colors in the buffer.
+ *
+ * @param newSize The new number of colors. Negative values are treated
+ *        as 0.
+ *
+ * @post The values are unspecified. (Changing the size changes the
+ * distance between the channels, so the old values are not preserved.) */
+void ColorBuffer::resize(const qsizetype newSize)
+{
+    m_size = qMax<qsizetype>(newSize, 0);
+    // Round up, so that each channel begins at an aligned address.
+    constexpr std::size_t valuesPerAlignment = alignment / sizeof(double);
+    const auto size = static_cast<std::size_t>(m_size);
+    m_channelStride = //
+        (size + valuesPerAlignment - 1) / valuesPerAlignment * valuesPerAlignment;
+    m_data.resize(3 * m_channelStride);
+}
+
+} // namespace PerceptualColor
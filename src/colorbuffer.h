@@ -0,0 +1,357 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef COLORBUFFER_H
+#define COLORBUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <qglobal.h>
+#include <vector>
+
+/** @internal
+ *
+ * @file
+ *
+ * Buffers for many colors in structure-of-arrays layout. */
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Allocator for <tt>std::vector</tt> that aligns the memory.
+ *
+ * @tparam T The value type.
+ * @tparam Alignment The alignment, measured in bytes. Must be a power
+ *         of 2. */
+template<typename T, std::size_t Alignment>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, //
+                  "Alignment must be a power of 2.");
+
+    /** @brief The value type. */
+    using value_type = T;
+
+    /** @brief The same allocator for another value type. */
+    template<typename U>
+    struct rebind {
+        /** @brief The same allocator for another value type. */
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    /** @brief Default constructor */
+    AlignedAllocator() noexcept = default;
+
+    /** @brief Converting constructor
+     *
+     * @param other The allocator for another value type. */
+    template<typename U>
+    explicit AlignedAllocator(const AlignedAllocator<U, Alignment> &other) noexcept
+    {
+        Q_UNUSED(other)
+    }
+
+    /** @brief Allocates memory.
+     *
+     * @param count Number of elements.
+     *
+     * @returns Pointer to the aligned memory. */
+    [[nodiscard]] T *allocate(const std::size_t count)
+    {
+        return static_cast<T *>( //
+            ::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    /** @brief Frees memory.
+     *
+     * @param pointer Pointer that has been returned by @ref allocate().
+     * @param count Number of elements. */
+    void deallocate(T *pointer, const std::size_t count) noexcept
+    {
+        Q_UNUSED(count)
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    /** @brief Equal operator
+     *
+     * @returns Always <tt>true</tt>, because the allocator has no state. */
+    template<typename U>
+    [[nodiscard]] bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept
+    {
+        return true;
+    }
+
+    /** @brief Unequal operator
+     *
+     * @returns Always <tt>false</tt>, because the allocator has no state. */
+    template<typename U>
+    [[nodiscard]] bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept
+    {
+        return false;
+    }
+};
+
+/** @internal
+ *
+ * @brief Base class for buffers that hold many colors with three channels
+ * in structure-of-arrays layout.
+ *
+ * Single-color types like @ref LchDouble or @ref RgbDouble store the
+ * channels of a color next to each other (array-of-structures if used in
+ * an array). Bulk operations are faster if all values of a channel are
+ * stored next to each other instead: Loops that process the channels
+ * become simple enough to be vectorized by the compiler, and the batch
+ * functions of @ref helperconversion.h and @ref colorKernels() expect
+ * exactly this layout.
+ *
+ * The three channels are stored in a single memory block, one after
+ * another. Each channel begins at a 64-byte boundary, which is the size
+ * of a cache line on common hardware and the vector size of AVX-512.
+ *
+ * The derived classes provide the channels with meaningful names.
+ *
+ * @note The values are zero-initialized. After @ref resize(), the values
+ * are unspecified. */
+class ColorBuffer
+{
+public:
+    /** @brief Number of colors in the buffer.
+     *
+     * @returns Number of colors in the buffer. */
+    [[nodiscard]] qsizetype size() const
+    {
+        return m_size;
+    }
+
+    void resize(const qsizetype newSize);
+
+protected:
+    explicit ColorBuffer(const qsizetype size);
+    /** @brief Default destructor
+     *
+     * The destructor is non-<tt>virtual</tt> and protected, so that
+     * the buffers cannot be deleted by means of a base class pointer. */
+    ~ColorBuffer() = default;
+    /** @brief Default copy constructor
+     *
+     * @param other the object to copy */
+    ColorBuffer(const ColorBuffer &other) = default;
+    /** @brief Default copy assignment operator
+     *
+     * @param other the object to copy
+     *
+     * @returns The object itself */
+    ColorBuffer &operator=(const ColorBuffer &other) = default;
+    /** @brief Default move constructor
+     *
+     * @param other the object to move */
+    ColorBuffer(ColorBuffer &&other) noexcept = default;
+    /** @brief Default move assignment operator
+     *
+     * @param other the object to move
+     *
+     * @returns The object itself */
+    ColorBuffer &operator=(ColorBuffer &&other) noexcept = default;
+
+    /** @brief A channel.
+     *
+     * @param index Index of the channel. Range: <tt>[0, 2]</tt>
+     *
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *channel(const int index)
+    {
+        return m_data.data() + static_cast<std::size_t>(index) * m_channelStride;
+    }
+
+    /** @brief A channel.
+     *
+     * @param index Index of the channel. Range: <tt>[0, 2]</tt>
+     *
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *channel(const int index) const
+    {
+        return m_data.data() + static_cast<std::size_t>(index) * m_channelStride;
+    }
+
+private:
+    /** @brief Alignment of each channel, measured in bytes. */
+    static constexpr std::size_t alignment = 64;
+    /** @brief Distance between the beginnings of two channels, measured
+     * in values. */
+    std::size_t m_channelStride = 0;
+    /** @brief The values of all channels. */
+    std::vector<double, AlignedAllocator<double, alignment>> m_data;
+    /** @brief Number of colors. */
+    qsizetype m_size = 0;
+};
+
+/** @internal
+ *
+ * @brief Buffer for many Lab colors (CIELab or Oklab) in
+ * structure-of-arrays layout.
+ *
+ * @sa @ref ColorBuffer */
+class LabBuffer final : public ColorBuffer
+{
+public:
+    /** @brief Constructor
+     *
+     * @param size Number of colors. */
+    explicit LabBuffer(const qsizetype size = 0)
+        : ColorBuffer(size)
+    {
+    }
+    /** @brief The lightness channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *l()
+    {
+        return channel(0);
+    }
+    /** @brief The lightness channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *l() const
+    {
+        return channel(0);
+    }
+    /** @brief The a channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *a()
+    {
+        return channel(1);
+    }
+    /** @brief The a channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *a() const
+    {
+        return channel(1);
+    }
+    /** @brief The b channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *b()
+    {
+        return channel(2);
+    }
+    /** @brief The b channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *b() const
+    {
+        return channel(2);
+    }
+};
+
+/** @internal
+ *
+ * @brief Buffer for many LCH colors (CIELCh or Oklch) in
+ * structure-of-arrays layout.
+ *
+ * The hue is measured in degree.
+ *
+ * @sa @ref ColorBuffer */
+class LchBuffer final : public ColorBuffer
+{
+public:
+    /** @brief Constructor
+     *
+     * @param size Number of colors. */
+    explicit LchBuffer(const qsizetype size = 0)
+        : ColorBuffer(size)
+    {
+    }
+    /** @brief The lightness channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *l()
+    {
+        return channel(0);
+    }
+    /** @brief The lightness channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *l() const
+    {
+        return channel(0);
+    }
+    /** @brief The chroma channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *c()
+    {
+        return channel(1);
+    }
+    /** @brief The chroma channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *c() const
+    {
+        return channel(1);
+    }
+    /** @brief The hue channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *h()
+    {
+        return channel(2);
+    }
+    /** @brief The hue channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *h() const
+    {
+        return channel(2);
+    }
+};
+
+/** @internal
+ *
+ * @brief Buffer for many RGB colors in structure-of-arrays layout.
+ *
+ * The valid range of each channel is <tt>[0, 1]</tt>, like in
+ * @ref RgbDouble.
+ *
+ * @sa @ref ColorBuffer */
+class RgbBuffer final : public ColorBuffer
+{
+public:
+    /** @brief Constructor
+     *
+     * @param size Number of colors. */
+    explicit RgbBuffer(const qsizetype size = 0)
+        : ColorBuffer(size)
+    {
+    }
+    /** @brief The red channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *red()
+    {
+        return channel(0);
+    }
+    /** @brief The red channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *red() const
+    {
+        return channel(0);
+    }
+    /** @brief The green channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *green()
+    {
+        return channel(1);
+    }
+    /** @brief The green channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *green() const
+    {
+        return channel(1);
+    }
+    /** @brief The blue channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] double *blue()
+    {
+        return channel(2);
+    }
+    /** @brief The blue channel.
+     * @returns Pointer to the first value of the channel. */
+    [[nodiscard]] const double *blue() const
+    {
+        return channel(2);
+    }
+};
+
+} // namespace PerceptualColor
+
+#endif // COLORBUFFER_H
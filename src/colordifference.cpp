@@ -0,0 +1,194 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own header
+#include "colordifference.h"
+
+#include "colorkernels.h"
+#include <cmath>
+#include <qmath.h>
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Color difference according to CIEDE2000.
+ *
+ * This implementation follows literally the formulas of
+ * <a href="https://hajim.rochester.edu/ece/sites/gsharma/ciede2000/">
+ * Gaurav Sharma, Wencheng Wu, Edul N. Dalal: “The CIEDE2000
+ * Color-Difference Formula: Implementation Notes, Supplementary Test Data,
+ * and Mathematical Observations”</a>, including the handling of the
+ * discontinuities of the mean hue and the hue difference. It is the
+ * reference for the batch version.
+ *
+ * The parametric weighting factors k<sub>L</sub>, k<sub>C</sub> and
+ * k<sub>H</sub> are 1.
+ *
+ * @param first The first color, in CIELab
+ * @param second The second color, in CIELab
+ *
+ * @returns The color difference ΔE₀₀. */
+double deltaE2000(const cmsCIELab &first, const cmsCIELab &second)
+{
+    constexpr double pow25To7 = 6103515625.; // 25⁷
+    const double c1 = std::hypot(first.a, first.b);
+    const double c2 = std::hypot(second.a, second.b);
+    const double cMean = (c1 + c2) / 2;
+    const double cMeanPow7 = std::pow(cMean, 7);
+    const double g = 0.5 * (1 - std::sqrt(cMeanPow7 / (cMeanPow7 + pow25To7)));
+    const double a1Prime = (1 + g) * first.a;
+    const double a2Prime = (1 + g) * second.a;
+    const double c1Prime = std::hypot(a1Prime, first.b);
+    const double c2Prime = std::hypot(a2Prime, second.b);
+    const auto hueDegree = [](const double b, const double aPrime) -> double {
+        if ((b == 0) && (aPrime == 0)) {
+            return 0;
+        }
+        const double result = qRadiansToDegrees(std::atan2(b, aPrime));
+        return (result < 0) ? result + 360 : result;
+    };
+    const double h1Prime = hueDegree(first.b, a1Prime);
+    const double h2Prime = hueDegree(second.b, a2Prime);
+
+    const double deltaLPrime = second.L - first.L;
+    const double deltaCPrime = c2Prime - c1Prime;
+    const double chromaProduct = c1Prime * c2Prime;
+    double deltaHuePrime;
+    if (chromaProduct == 0) {
+        deltaHuePrime = 0;
+    } else {
+        deltaHuePrime = h2Prime - h1Prime;
+        if (deltaHuePrime > 180) {
+            deltaHuePrime -= 360;
+        } else if (deltaHuePrime < -180) {
+            deltaHuePrime += 360;
+        }
+    }
+    const double deltaBigHPrime = //
+        2 * std::sqrt(chromaProduct) * std::sin(qDegreesToRadians(deltaHuePrime / 2));
+
+    const double lPrimeMean = (first.L + second.L) / 2;
+    const double cPrimeMean = (c1Prime + c2Prime) / 2;
+    double hPrimeMean;
+    if (chromaProduct == 0) {
+        hPrimeMean = h1Prime + h2Prime;
+    } else if (std::abs(h1Prime - h2Prime) <= 180) {
+        hPrimeMean = (h1Prime + h2Prime) / 2;
+    } else if (h1Prime + h2Prime < 360) {
+        hPrimeMean = (h1Prime + h2Prime + 360) / 2;
+    } else {
+        hPrimeMean = (h1Prime + h2Prime - 360) / 2;
+    }
+
+    const double t = 1 //
+        - 0.17 * std::cos(qDegreesToRadians(hPrimeMean - 30)) //
+        + 0.24 * std::cos(qDegreesToRadians(2 * hPrimeMean)) //
+        + 0.32 * std::cos(qDegreesToRadians(3 * hPrimeMean + 6)) //
+        - 0.20 * std::cos(qDegreesToRadians(4 * hPrimeMean - 63));
+    const double deltaTheta = //
+        30 * std::exp(-std::pow((hPrimeMean - 275) / 25, 2));
+    const double cPrimeMeanPow7 = std::pow(cPrimeMean, 7);
+    const double rC = 2 * std::sqrt(cPrimeMeanPow7 / (cPrimeMeanPow7 + pow25To7));
+    const double lightnessOffsetSquare = std::pow(lPrimeMean - 50, 2);
+    const double sL = 1 + 0.015 * lightnessOffsetSquare / std::sqrt(20 + lightnessOffsetSquare);
+    const double sC = 1 + 0.045 * cPrimeMean;
+    const double sH = 1 + 0.015 * cPrimeMean * t;
+    const double rT = -std::sin(qDegreesToRadians(2 * deltaTheta)) * rC;
+
+    const double lightnessTerm = deltaLPrime / sL;
+    const double chromaTerm = deltaCPrime / sC;
+    const double hueTerm = deltaBigHPrime / sH;
+    return std::sqrt(lightnessTerm * lightnessTerm //
+                     + chromaTerm * chromaTerm //
+                     + hueTerm * hueTerm //
+                     + rT * chromaTerm * hueTerm);
+}
+
+/** @internal
+ *
+ * @brief Batch version of
+ * @ref deltaE2000(const cmsCIELab &first, const cmsCIELab &second).
+ *
+ * @param first Array with the first color of each pair, in CIELab
+ * @param second Array with the second color of each pair, in CIELab
+ * @param result Array that will receive the color differences ΔE₀₀
+ * @param count Number of color pairs. Each of the arrays must hold at
+ *        least this number of elements.
+ *
+ * The results differ from the single-value version by less than
+ * @ref deltaE2000BatchMaximumError. */
+void deltaE2000(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    colorKernels().ciede2000(first, second, result, count);
+}
+
+/** @internal
+ *
+ * @brief Color difference according to CIE76.
+ *
+ * This is the Euclidean distance in CIELab. It is cheap, but perceptually
+ * less uniform than @ref deltaE2000().
+ *
+ * @param first The first color, in CIELab
+ * @param second The second color, in CIELab
+ *
+ * @returns The color difference ΔE*<sub>ab</sub>. */
+double deltaE76(const cmsCIELab &first, const cmsCIELab &second)
+{
+    return std::sqrt(std::pow(second.L - first.L, 2) //
+                     + std::pow(second.a - first.a, 2) //
+                     + std::pow(second.b - first.b, 2));
+}
+
+/** @internal
+ *
+ * @brief Batch version of
+ * @ref deltaE76(const cmsCIELab &first, const cmsCIELab &second).
+ *
+ * @param first Array with the first color of each pair, in CIELab
+ * @param second Array with the second color of each pair, in CIELab
+ * @param result Array that will receive the color differences
+ * @param count Number of color pairs. Each of the arrays must hold at
+ *        least this number of elements. */
+void deltaE76(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    colorKernels().euclideanDistance(first, second, result, count);
+}
+
+/** @internal
+ *
+ * @brief Color difference in Oklab.
+ *
+ * This is the Euclidean distance in Oklab. Because Oklab is perceptually
+ * more uniform than CIELab, this gives better results than
+ * @ref deltaE76() at the same cost.
+ *
+ * @param first The first color, in Oklab
+ * @param second The second color, in Oklab
+ *
+ * @returns The color difference. Note that the range of Oklab
+ * lightness is <tt>[0, 1]</tt> and not <tt>[0, 100]</tt>, so the values
+ * are about 100 times smaller than CIELab-based color differences. */
+double deltaEOklab(const cmsCIELab &first, const cmsCIELab &second)
+{
+    return deltaE76(first, second);
+}
+
+/** @internal
+ *
+ * @brief Batch version of
+ * @ref deltaEOklab(const cmsCIELab &first, const cmsCIELab &second).
+ *
+ * @param first Array with the first color of each pair, in Oklab
+ * @param second Array with the second color of each pair, in Oklab
+ * @param result Array that will receive the color differences
+ * @param count Number of color pairs. Each of the arrays must hold at
+ *        least this number of elements. */
+void deltaEOklab(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    colorKernels().euclideanDistance(first, second, result, count);
+}
+
+} // namespace PerceptualColor
@@ -0,0 +1,68 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef COLORDIFFERENCE_H
+#define COLORDIFFERENCE_H
+
+#include <lcms2.h>
+#include <qglobal.h>
+
+/** @internal
+ *
+ * @file
+ *
+ * Color difference formulas (ΔE).
+ *
+ * There is a single-value version and a batch version of each formula.
+ * The batch versions work on arrays of color pairs and use
+ * @ref colorKernels(), which uses the best instruction set of the CPU.
+ *
+ * | Formula                  | Color space | Single value           | Batch                  |
+ * | :----------------------- | :---------- | :--------------------- | :--------------------- |
+ * | CIE76 (Euclidean)        | CIELab      | @ref deltaE76()        | @ref deltaE76()        |
+ * | CIEDE2000                | CIELab      | @ref deltaE2000()      | @ref deltaE2000()      |
+ * | Euclidean                | Oklab       | @ref deltaEOklab()     | @ref deltaEOklab()     |
+ *
+ * For the batch versions, the output array must not overlap with the
+ * input arrays. The input arrays may overlap with each other.
+ *
+ * The batch version of CIEDE2000 uses fast approximations of the
+ * trigonometric functions. Its results differ from the single-value
+ * version by less than @ref deltaE2000BatchMaximumError. */
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Maximum absolute difference between the batch version and the
+ * single-value version of @ref deltaE2000().
+ *
+ * The batch version uses the approximations @ref fastSinCosDegree(),
+ * @ref fastAtan2Degree() and @ref fastExp(). Their errors are in the order
+ * of magnitude of <tt>10⁻¹⁴</tt> and propagate only slightly. This value
+ * gives a generous margin and is nevertheless far below any perceptible
+ * difference.
+ *
+ * Exception: CIEDE2000 itself is discontinuous where the hue difference of
+ * both colors is 180°. Exactly opposite hues are handled like in the
+ * single-value version. But for hue differences that are not exactly, but
+ * within @ref fastAtan2MaximumErrorDegree of 180°, both versions might
+ * end up on different sides of the discontinuity. */
+constexpr double deltaE2000BatchMaximumError = 1e-9;
+
+[[nodiscard]] double deltaE2000(const cmsCIELab &first, const cmsCIELab &second);
+
+void deltaE2000(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count);
+
+[[nodiscard]] double deltaE76(const cmsCIELab &first, const cmsCIELab &second);
+
+void deltaE76(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count);
+
+[[nodiscard]] double deltaEOklab(const cmsCIELab &first, const cmsCIELab &second);
+
+void deltaEOklab(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count);
+
+} // namespace PerceptualColor
+
+#endif // COLORDIFFERENCE_H
@@ -0,0 +1,742 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own header
+#include "colorkernels.h"
+
+#include "colordifference.h"
+#include "helperconversion.h"
+#include "helpermath.h"
+#include <algorithm>
+#include <cmath>
+#include <qcolor.h>
+#include <qmath.h>
+
+// How the dispatch works: The actual loops are templates. For each
+// instruction set, there is a thin wrapper function that calls these
+// templates. The wrappers have a GCC-style “target” attribute, which
+// allows the compiler to use the corresponding instruction set within
+// them, and a “flatten” attribute, which forces all calls within the
+// wrapper to be expanded into the wrapper itself (so that the loops are
+// really compiled for the wrapper’s instruction set). The compiler
+// auto-vectorizes the loops accordingly. The loops are passed to
+// forEachBlock() as lambdas, not as function pointers: A lambda has its
+// own type, so the call within forEachBlock() is a direct call that can
+// always be expanded, while a function pointer would rely on the compiler
+// propagating the constant first.
+//
+// To check the result, look at the disassembly of the wrappers: With
+// GCC and optimization level O3 (CMake’s Release build), the AVX2 wrappers
+// use ymm registers and the AVX-512 wrappers zmm registers. Loops that call
+// std::cbrt() or std::sqrt() are not vectorized and are therefore identical
+// for all instruction sets. At optimization level O2, GCC does not
+// vectorize these loops at all. At runtime, colorKernels()
+// provides the wrappers that correspond to the active instruction set.
+
+#ifdef __GNUC__
+#define PERCEPTUALCOLOR_KERNEL_BASELINE __attribute__((flatten))
+#else
+#define PERCEPTUALCOLOR_KERNEL_BASELINE
+#endif
+#ifdef PERCEPTUALCOLOR_X86_DISPATCH
+#define PERCEPTUALCOLOR_KERNEL_AVX2 __attribute__((target("avx2,fma"), flatten))
+#define PERCEPTUALCOLOR_KERNEL_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma"), flatten))
+#endif
+
+namespace PerceptualColor
+{
+
+namespace
+{
+
+/** @internal
+ *
+ * @brief Functor for the precise cube root. */
+struct PreciseCubeRoot {
+    double operator()(const double value) const
+    {
+        // See fromXyzd65ToOklab(const Vector3 &) for why using std::cbrt().
+        return std::cbrt(value);
+    }
+};
+
+/** @internal
+ *
+ * @brief Functor for the fast cube root. */
+struct FastCubeRoot {
+    double operator()(const double value) const
+    {
+        return fastCubeRoot(value);
+    }
+};
+
+/** @internal
+ *
+ * @brief Number of values that @ref forEachBlock() processes at once. */
+constexpr qsizetype blockSize = 64;
+
+/** @internal
+ *
+ * @brief Applies a kernel block by block, using local buffers.
+ *
+ * The kernels read three input arrays and write three output arrays.
+ * Because these six arrays might alias (in-place calculation is allowed),
+ * the compiler would have to check at runtime for overlaps before it
+ * can use vectorized code. For six arrays, there are too many pairs to
+ * check, so compilers give up vectorizing. Therefore, this function copies
+ * the input data to local buffers, applies the kernel to the local buffers
+ * (which obviously do not alias), and copies the result back. The
+ * additional copies are cheap compared to the kernel itself.
+ *
+ * @param in0 First input array
+ * @param in1 Second input array
+ * @param in2 Third input array
+ * @param out0 First output array
+ * @param out1 Second output array
+ * @param out2 Third output array
+ * @param count Number of elements
+ * @param kernel Kernel with the same signature as this function, but
+ *        without the “kernel” argument. It is called with at most
+ *        @ref blockSize elements. */
+template<typename Kernel>
+void forEachBlock(const double *in0, const double *in1, const double *in2, double *out0, double *out1, double *out2, const qsizetype count, Kernel kernel)
+{
+    alignas(64) double inBuffer0[blockSize];
+    alignas(64) double inBuffer1[blockSize];
+    alignas(64) double inBuffer2[blockSize];
+    alignas(64) double outBuffer0[blockSize];
+    alignas(64) double outBuffer1[blockSize];
+    alignas(64) double outBuffer2[blockSize];
+    for (qsizetype begin = 0; begin < count; begin += blockSize) {
+        const qsizetype size = qMin(blockSize, count - begin);
+        std::copy_n(in0 + begin, size, inBuffer0);
+        std::copy_n(in1 + begin, size, inBuffer1);
+        std::copy_n(in2 + begin, size, inBuffer2);
+        kernel(inBuffer0, inBuffer1, inBuffer2, outBuffer0, outBuffer1, outBuffer2, size);
+        std::copy_n(outBuffer0, size, out0 + begin);
+        std::copy_n(outBuffer1, size, out1 + begin);
+        std::copy_n(outBuffer2, size, out2 + begin);
+    }
+}
+
+/** @internal
+ *
+ * @brief Like @ref forEachBlock(), but for kernels with two input arrays
+ * and two output arrays.
+ *
+ * @param in0 First input array
+ * @param in1 Second input array
+ * @param out0 First output array
+ * @param out1 Second output array
+ * @param count Number of elements
+ * @param kernel Kernel with the same signature as this function, but
+ *        without the “kernel” argument. It is called with at most
+ *        @ref blockSize elements. */
+template<typename Kernel>
+void forEachBlock(const double *in0, const double *in1, double *out0, double *out1, const qsizetype count, Kernel kernel)
+{
+    alignas(64) double inBuffer0[blockSize];
+    alignas(64) double inBuffer1[blockSize];
+    alignas(64) double outBuffer0[blockSize];
+    alignas(64) double outBuffer1[blockSize];
+    for (qsizetype begin = 0; begin < count; begin += blockSize) {
+        const qsizetype size = qMin(blockSize, count - begin);
+        std::copy_n(in0 + begin, size, inBuffer0);
+        std::copy_n(in1 + begin, size, inBuffer1);
+        kernel(inBuffer0, inBuffer1, outBuffer0, outBuffer1, size);
+        std::copy_n(outBuffer0, size, out0 + begin);
+        std::copy_n(outBuffer1, size, out1 + begin);
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch conversion from XYZ-D65 to Oklab.
+ *
+ * @param x Array with the X values of the input colors
+ * @param y Array with the Y values of the input colors
+ * @param z Array with the Z values of the input colors
+ * @param oklabL Array that will receive the L values of the output colors
+ * @param oklabA Array that will receive the a values of the output colors
+ * @param oklabB Array that will receive the b values of the output colors
+ * @param count Number of colors
+ *
+ * @tparam CubeRoot Functor that calculates the cube root */
+template<typename CubeRoot>
+void xyzd65ToOklabLoop(const double *x, const double *y, const double *z, double *oklabL, double *oklabA, double *oklabB, const qsizetype count)
+{
+    const CubeRoot cubeRoot;
+    // Working with individual scalars instead of Vector3 makes it easier
+    // for the compiler to vectorize the loop.
+    constexpr auto &m1 = oklabM1;
+    constexpr auto &m2 = oklabM2;
+    for (qsizetype i = 0; i < count; ++i) {
+        const double xValue = x[i];
+        const double yValue = y[i];
+        const double zValue = z[i];
+        const double l = cubeRoot(m1[0][0] * xValue + m1[0][1] * yValue + m1[0][2] * zValue);
+        const double m = cubeRoot(m1[1][0] * xValue + m1[1][1] * yValue + m1[1][2] * zValue);
+        const double s = cubeRoot(m1[2][0] * xValue + m1[2][1] * yValue + m1[2][2] * zValue);
+        oklabL[i] = m2[0][0] * l + m2[0][1] * m + m2[0][2] * s;
+        oklabA[i] = m2[1][0] * l + m2[1][1] * m + m2[1][2] * s;
+        oklabB[i] = m2[2][0] * l + m2[2][1] * m + m2[2][2] * s;
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch conversion from Oklab to XYZ-D65.
+ *
+ * @param oklabL Array with the L values of the input colors
+ * @param oklabA Array with the a values of the input colors
+ * @param oklabB Array with the b values of the input colors
+ * @param x Array that will receive the X values of the output colors
+ * @param y Array that will receive the Y values of the output colors
+ * @param z Array that will receive the Z values of the output colors
+ * @param count Number of colors */
+void oklabToXyzd65Loop(const double *oklabL, const double *oklabA, const double *oklabB, double *x, double *y, double *z, const qsizetype count)
+{
+    // Working with individual scalars instead of Vector3 makes it easier
+    // for the compiler to vectorize the loop.
+    constexpr auto &m1Inverse = oklabM1Inverse;
+    constexpr auto &m2Inverse = oklabM2Inverse;
+    for (qsizetype i = 0; i < count; ++i) {
+        const double lValue = oklabL[i];
+        const double aValue = oklabA[i];
+        const double bValue = oklabB[i];
+        const double lNonLinear = m2Inverse[0][0] * lValue + m2Inverse[0][1] * aValue + m2Inverse[0][2] * bValue;
+        const double mNonLinear = m2Inverse[1][0] * lValue + m2Inverse[1][1] * aValue + m2Inverse[1][2] * bValue;
+        const double sNonLinear = m2Inverse[2][0] * lValue + m2Inverse[2][1] * aValue + m2Inverse[2][2] * bValue;
+        const double l = lNonLinear * lNonLinear * lNonLinear;
+        const double m = mNonLinear * mNonLinear * mNonLinear;
+        const double s = sNonLinear * sNonLinear * sNonLinear;
+        x[i] = m1Inverse[0][0] * l + m1Inverse[0][1] * m + m1Inverse[0][2] * s;
+        y[i] = m1Inverse[1][0] * l + m1Inverse[1][1] * m + m1Inverse[1][2] * s;
+        z[i] = m1Inverse[2][0] * l + m1Inverse[2][1] * m + m1Inverse[2][2] * s;
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch conversion from polar to Cartesian coordinates.
+ *
+ * @param radius Array with the radii (for example the chroma)
+ * @param angleDegree Array with the angles, measured in degree (for
+ *        example the hue)
+ * @param x Array that will receive the x coordinates (for example a)
+ * @param y Array that will receive the y coordinates (for example b)
+ * @param count Number of values */
+void polarToCartesianLoop(const double *radius, const double *angleDegree, double *x, double *y, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        double sine;
+        double cosine;
+        fastSinCosDegree(angleDegree[i], sine, cosine);
+        x[i] = radius[i] * cosine;
+        y[i] = radius[i] * sine;
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch conversion from Cartesian to polar coordinates.
+ *
+ * @param x Array with the x coordinates (for example a)
+ * @param y Array with the y coordinates (for example b)
+ * @param radius Array that will receive the radii (for example the chroma)
+ * @param angleDegree Array that will receive the angles, measured in
+ *        degree, within <tt>[0°, 360°]</tt> (for example the hue)
+ * @param count Number of values */
+void cartesianToPolarLoop(const double *x, const double *y, double *radius, double *angleDegree, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double xValue = x[i];
+        const double yValue = y[i];
+        radius[i] = std::sqrt(xValue * xValue + yValue * yValue);
+        angleDegree[i] = fastAtan2Degree(yValue, xValue);
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch Euclidean distance.
+ *
+ * @param first Array with the first value of each pair
+ * @param second Array with the second value of each pair
+ * @param result Array that will receive the distances
+ * @param count Number of pairs */
+void euclideanDistanceLoop(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double deltaL = second[i].L - first[i].L;
+        const double deltaA = second[i].a - first[i].a;
+        const double deltaB = second[i].b - first[i].b;
+        result[i] = std::sqrt(deltaL * deltaL + deltaA * deltaA + deltaB * deltaB);
+    }
+}
+
+/** @internal
+ *
+ * @brief CIEDE2000 color difference for a single pair, without branches.
+ *
+ * Calculates the same as @ref deltaE2000(const cmsCIELab &, const cmsCIELab &),
+ * but all case distinctions are expressed as selections between
+ * already calculated values, and the trigonometric functions are
+ * replaced by @ref fastSinCosDegree() and @ref fastAtan2Degree(). This
+ * allows the compiler to auto-vectorize loops that call this function.
+ *
+ * @param first The first color, in CIELab
+ * @param second The second color, in CIELab
+ *
+ * @returns The color difference ΔE₀₀. */
+double ciede2000Value(const cmsCIELab &first, const cmsCIELab &second)
+{
+    constexpr double pow25To7 = 6103515625.; // 25⁷
+    const double c1 = std::sqrt(first.a * first.a + first.b * first.b);
+    const double c2 = std::sqrt(second.a * second.a + second.b * second.b);
+    const double cMean = (c1 + c2) / 2;
+    const double cMeanPow2 = cMean * cMean;
+    const double cMeanPow7 = cMeanPow2 * cMeanPow2 * cMeanPow2 * cMean;
+    const double g = 0.5 * (1 - std::sqrt(cMeanPow7 / (cMeanPow7 + pow25To7)));
+    const double a1Prime = (1 + g) * first.a;
+    const double a2Prime = (1 + g) * second.a;
+    const double c1Prime = std::sqrt(a1Prime * a1Prime + first.b * first.b);
+    const double c2Prime = std::sqrt(a2Prime * a2Prime + second.b * second.b);
+    // fastAtan2Degree() returns 0° for (0, 0), as required by CIEDE2000.
+    const double h1Prime = fastAtan2Degree(first.b, a1Prime);
+    const double h2Prime = fastAtan2Degree(second.b, a2Prime);
+
+    const double deltaLPrime = second.L - first.L;
+    const double deltaCPrime = c2Prime - c1Prime;
+    const double chromaProduct = c1Prime * c2Prime;
+    const bool isAchromatic = chromaProduct == 0;
+    const double hueDifference = h2Prime - h1Prime;
+    // CIEDE2000 is discontinuous where the hue difference is exactly 180°:
+    // The hue difference is wrapped around only if its absolute value
+    // exceeds 180°. The test data of Sharma et al. contains such cases.
+    // With approximated hues, the calculated hue difference might be
+    // slightly above 180° where it is exactly 180°. Therefore, exactly
+    // opposite hues are detected separately by a vanishing cross product.
+    // (Comparing both products instead of subtracting them prevents the
+    // compiler from contracting them to a fused multiply-add, which would
+    // round differently.)
+    const bool isOpposite = (a1Prime * second.b) == (first.b * a2Prime);
+    const bool isWrapped = (std::abs(hueDifference) > 180) & !isOpposite;
+    double deltaHuePrime = hueDifference;
+    deltaHuePrime = (isWrapped & (hueDifference > 0)) ? hueDifference - 360 : deltaHuePrime;
+    deltaHuePrime = (isWrapped & (hueDifference < 0)) ? hueDifference + 360 : deltaHuePrime;
+    deltaHuePrime = isAchromatic ? 0. : deltaHuePrime;
+    double sineOfHalfDeltaHue;
+    double unusedCosine;
+    fastSinCosDegree(deltaHuePrime / 2, sineOfHalfDeltaHue, unusedCosine);
+    const double deltaBigHPrime = 2 * std::sqrt(chromaProduct) * sineOfHalfDeltaHue;
+
+    const double lPrimeMean = (first.L + second.L) / 2;
+    const double cPrimeMean = (c1Prime + c2Prime) / 2;
+    const double hueSum = h1Prime + h2Prime;
+    double hPrimeMean = hueSum / 2;
+    hPrimeMean = (isWrapped & (hueSum < 360)) ? (hueSum + 360) / 2 : hPrimeMean;
+    hPrimeMean = (isWrapped & (hueSum >= 360)) ? (hueSum - 360) / 2 : hPrimeMean;
+    hPrimeMean = isAchromatic ? hueSum : hPrimeMean;
+
+    double unusedSine;
+    double cosine1;
+    double cosine2;
+    double cosine3;
+    double cosine4;
+    fastSinCosDegree(hPrimeMean - 30, unusedSine, cosine1);
+    fastSinCosDegree(2 * hPrimeMean, unusedSine, cosine2);
+    fastSinCosDegree(3 * hPrimeMean + 6, unusedSine, cosine3);
+    fastSinCosDegree(4 * hPrimeMean - 63, unusedSine, cosine4);
+    const double t = 1 - 0.17 * cosine1 + 0.24 * cosine2 + 0.32 * cosine3 - 0.20 * cosine4;
+    const double hueOffset = (hPrimeMean - 275) / 25;
+    const double deltaTheta = 30 * fastExp(-hueOffset * hueOffset);
+    const double cPrimeMeanPow2 = cPrimeMean * cPrimeMean;
+    const double cPrimeMeanPow7 = cPrimeMeanPow2 * cPrimeMeanPow2 * cPrimeMeanPow2 * cPrimeMean;
+    const double rC = 2 * std::sqrt(cPrimeMeanPow7 / (cPrimeMeanPow7 + pow25To7));
+    const double lightnessOffsetSquare = (lPrimeMean - 50) * (lPrimeMean - 50);
+    const double sL = 1 + 0.015 * lightnessOffsetSquare / std::sqrt(20 + lightnessOffsetSquare);
+    const double sC = 1 + 0.045 * cPrimeMean;
+    const double sH = 1 + 0.015 * cPrimeMean * t;
+    double sineOfDoubleDeltaTheta;
+    fastSinCosDegree(2 * deltaTheta, sineOfDoubleDeltaTheta, unusedCosine);
+    const double rT = -sineOfDoubleDeltaTheta * rC;
+
+    const double lightnessTerm = deltaLPrime / sL;
+    const double chromaTerm = deltaCPrime / sC;
+    const double hueTerm = deltaBigHPrime / sH;
+    return std::sqrt(lightnessTerm * lightnessTerm //
+                     + chromaTerm * chromaTerm //
+                     + hueTerm * hueTerm //
+                     + rT * chromaTerm * hueTerm);
+}
+
+/** @internal
+ *
+ * @brief Loop for the batch CIEDE2000 color difference.
+ *
+ * @param first Array with the first color of each pair, in CIELab
+ * @param second Array with the second color of each pair, in CIELab
+ * @param result Array that will receive the color differences
+ * @param count Number of pairs */
+void ciede2000Loop(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = ciede2000Value(first[i], second[i]);
+    }
+}
+
+/** @internal
+ *
+ * @brief In-gamut test for a single value, based on the results of
+ * a round-trip conversion.
+ *
+ * @param original Original CIELab-D50 value
+ * @param rgb Corresponding RGB value
+ * @param roundtrip Round-trip CIELab-D50 value
+ * @param maximumChromaSquare Square of the maximum chroma of the profile
+ * @param deviationLimitSquare Square of the deviation limit
+ *
+ * @returns <tt>true</tt> if the value is in-gamut, <tt>false</tt>
+ * otherwise. */
+bool isCielabD50InGamutValue(const cmsCIELab &original, const RgbDouble &rgb, const cmsCIELab &roundtrip, const double maximumChromaSquare, const double deviationLimitSquare)
+{
+    // Using the bitwise “&” instead of the logical “&&” to avoid
+    // branches, which would prevent the vectorization.
+    const bool lightnessIsOkay = (original.L >= 0) & (original.L <= 100);
+    const double chromaSquare = original.a * original.a + original.b * original.b;
+    const bool chromaIsOkay = chromaSquare <= maximumChromaSquare;
+    const bool rgbIsOkay = //
+        (rgb.red >= 0) & (rgb.red <= 1) //
+        & (rgb.green >= 0) & (rgb.green <= 1) //
+        & (rgb.blue >= 0) & (rgb.blue <= 1);
+    const double deltaL = original.L - roundtrip.L;
+    const double deltaA = original.a - roundtrip.a;
+    const double deltaB = original.b - roundtrip.b;
+    const double deviationSquare = deltaL * deltaL + deltaA * deltaA + deltaB * deltaB;
+    const bool deviationIsOkay = deviationSquare <= deviationLimitSquare;
+    return lightnessIsOkay & chromaIsOkay & rgbIsOkay & deviationIsOkay;
+}
+
+/** @internal
+ *
+ * @brief Loop for the final step of the batch in-gamut test.
+ *
+ * @param original Original CIELab-D50 values
+ * @param rgb Corresponding RGB values
+ * @param roundtrip Round-trip CIELab-D50 values
+ * @param result Array that will receive the results
+ * @param count Number of values
+ * @param maximumChromaSquare Square of the maximum chroma of the profile
+ * @param deviationLimitSquare Square of the deviation limit */
+void cielabD50InGamutLoop(const cmsCIELab *original, const RgbDouble *rgb, const cmsCIELab *roundtrip, bool *result, const qsizetype count, const double maximumChromaSquare, const double deviationLimitSquare)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = isCielabD50InGamutValue(original[i], //
+                                            rgb[i],
+                                            roundtrip[i],
+                                            maximumChromaSquare,
+                                            deviationLimitSquare);
+    }
+}
+
+/** @internal
+ *
+ * @brief Loop for the final step of the batch conversion to <tt>QRgb</tt>.
+ *
+ * @param original Original CIELab-D50 values
+ * @param rgb Corresponding RGB values
+ * @param roundtrip Round-trip CIELab-D50 values
+ * @param result Array that will receive the results
+ * @param count Number of values
+ * @param maximumChromaSquare Square of the maximum chroma of the profile
+ * @param deviationLimitSquare Square of the deviation limit */
+void cielabD50ToQRgbOrTransparentLoop(const cmsCIELab *original, const RgbDouble *rgb, const cmsCIELab *roundtrip, QRgb *result, const qsizetype count, const double maximumChromaSquare, const double deviationLimitSquare)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const bool inGamut = isCielabD50InGamutValue(original[i], //
+                                                     rgb[i],
+                                                     roundtrip[i],
+                                                     maximumChromaSquare,
+                                                     deviationLimitSquare);
+        // All bits set for in-gamut values, no bit set otherwise. Masking
+        // instead of branching allows vectorization.
+        const quint32 mask = 0U - static_cast<quint32>(inGamut);
+        result[i] = fromRgbDoubleToQRgb(rgb[i].red, rgb[i].green, rgb[i].blue) & mask;
+    }
+}
+
+// Scalar reference implementation
+
+void scalarXyzd65ToOklab(const double *x, const double *y, const double *z, double *oklabL, double *oklabA, double *oklabB, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const auto oklab = fromXyzd65ToOklab(Vector3{x[i], y[i], z[i]});
+        oklabL[i] = oklab[0];
+        oklabA[i] = oklab[1];
+        oklabB[i] = oklab[2];
+    }
+}
+
+void scalarXyzd65ToOklabFast(const double *x, const double *y, const double *z, double *oklabL, double *oklabA, double *oklabB, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const auto oklab = fromXyzd65ToOklab( //
+            Vector3{x[i], y[i], z[i]},
+            ConversionPrecision::Fast);
+        oklabL[i] = oklab[0];
+        oklabA[i] = oklab[1];
+        oklabB[i] = oklab[2];
+    }
+}
+
+void scalarOklabToXyzd65(const double *oklabL, const double *oklabA, const double *oklabB, double *x, double *y, double *z, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const auto xyz = fromOklabToXyzd65(Vector3{oklabL[i], oklabA[i], oklabB[i]});
+        x[i] = xyz[0];
+        y[i] = xyz[1];
+        z[i] = xyz[2];
+    }
+}
+
+void scalarPolarToCartesian(const double *radius, const double *angleDegree, double *x, double *y, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double angleRadian = qDegreesToRadians(angleDegree[i]);
+        const double radiusValue = radius[i];
+        x[i] = radiusValue * std::cos(angleRadian);
+        y[i] = radiusValue * std::sin(angleRadian);
+    }
+}
+
+void scalarCartesianToPolar(const double *x, const double *y, double *radius, double *angleDegree, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double xValue = x[i];
+        const double yValue = y[i];
+        radius[i] = std::hypot(xValue, yValue);
+        // Like LittleCMS, define the angle of (0, 0) as 0°. (std::atan2()
+        // would give 180° for (−0, −0).)
+        const double angle = ((xValue == 0) && (yValue == 0)) //
+            ? 0
+            : qRadiansToDegrees(std::atan2(yValue, xValue));
+        angleDegree[i] = (angle < 0) ? angle + 360 : angle;
+    }
+}
+
+void scalarEuclideanDistance(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = deltaE76(first[i], second[i]);
+    }
+}
+
+void scalarCiede2000(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = deltaE2000(first[i], second[i]);
+    }
+}
+
+void scalarCielabD50InGamut(const cmsCIELab *original, const RgbDouble *rgb, const cmsCIELab *roundtrip, bool *result, const qsizetype count, const double maximumChromaSquare, const double deviationLimitSquare)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const bool lightnessIsOkay = isInRange<double>(0, original[i].L, 100);
+        const double chromaSquare = //
+            original[i].a * original[i].a + original[i].b * original[i].b;
+        const bool colorIsValid = //
+            isInRange<double>(0, rgb[i].red, 1) //
+            && isInRange<double>(0, rgb[i].green, 1) //
+            && isInRange<double>(0, rgb[i].blue, 1);
+        const double deviationSquare = //
+            std::pow(original[i].L - roundtrip[i].L, 2) //
+            + std::pow(original[i].a - roundtrip[i].a, 2) //
+            + std::pow(original[i].b - roundtrip[i].b, 2);
+        result[i] = lightnessIsOkay //
+            && (chromaSquare <= maximumChromaSquare) //
+            && colorIsValid //
+            && (deviationSquare <= deviationLimitSquare);
+    }
+}
+
+void scalarCielabD50ToQRgbOrTransparent(const cmsCIELab *original, const RgbDouble *rgb, const cmsCIELab *roundtrip, QRgb *result, const qsizetype count, const double maximumChromaSquare, const double deviationLimitSquare)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        bool inGamut;
+        scalarCielabD50InGamut(original + i, rgb + i, roundtrip + i, &inGamut, 1, maximumChromaSquare, deviationLimitSquare);
+        if (inGamut) {
+            const QColor temp = qColorFromRgbDouble(rgb[i].red, rgb[i].green, rgb[i].blue);
+            result[i] = temp.rgb();
+        } else {
+            result[i] = 0;
+        }
+    }
+}
+
+// Wrappers for the instruction sets
+
+// The following macro defines the wrappers for a specific instruction set.
+// The wrapper names start with “prefix”, and they get the given attributes.
+#define PERCEPTUALCOLOR_DEFINE_KERNELS(prefix, attributes) /* NOLINT */ \
+    attributes void prefix##Xyzd65ToOklab(const double *x, const double *y, const double *z, double *oklabL, double *oklabA, double *oklabB, const qsizetype count) \
+    { \
+        forEachBlock(x, y, z, oklabL, oklabA, oklabB, count, [](auto... arguments) { xyzd65ToOklabLoop<PreciseCubeRoot>(arguments...); }); \
+    } \
+    attributes void prefix##Xyzd65ToOklabFast(const double *x, const double *y, const double *z, double *oklabL, double *oklabA, double *oklabB, const qsizetype count) \
+    { \
+        forEachBlock(x, y, z, oklabL, oklabA, oklabB, count, [](auto... arguments) { xyzd65ToOklabLoop<FastCubeRoot>(arguments...); }); \
+    } \
+    attributes void prefix##OklabToXyzd65(const double *oklabL, const double *oklabA, const double *oklabB, double *x, double *y, double *z, const qsizetype count) \
+    { \
+        forEachBlock(oklabL, oklabA, oklabB, x, y, z, count, [](auto... arguments) { oklabToXyzd65Loop(arguments...); }); \
+    } \
+    attributes void prefix##PolarToCartesian(const double *radius, const double *angleDegree, double *x, double *y, const qsizetype count) \
+    { \
+        forEachBlock(radius, angleDegree, x, y, count, [](auto... arguments) { polarToCartesianLoop(arguments...); }); \
+    } \
+    attributes void prefix##CartesianToPolar(const double *x, const double *y, double *radius, double *angleDegree, const qsizetype count) \
+    { \
+        forEachBlock(x, y, radius, angleDegree, count, [](auto... arguments) { cartesianToPolarLoop(arguments...); }); \
+    } \
+    attributes void prefix##EuclideanDistance(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count) \
+    { \
+        euclideanDistanceLoop(first, second, result, count); \
+    } \
+    attributes void prefix##Ciede2000(const cmsCIELab *first, const cmsCIELab *second, double *result, const qsizetype count) \
+    { \
+        ciede2000Loop(first, second, result, count); \
+    } \
+    attributes void prefix##CielabD50InGamut(const cmsCIELab *original, \
+                                             const RgbDouble *rgb, \
+                                             const cmsCIELab *roundtrip, \
+                                             bool *result, \
+                                             const qsizetype count, \
+                                             const double maximumChromaSquare, \
+                                             const double deviationLimitSquare) \
+    { \
+        cielabD50InGamutLoop(original, rgb, roundtrip, result, count, maximumChromaSquare, deviationLimitSquare); \
+    } \
+    attributes void prefix##CielabD50ToQRgbOrTransparent(const cmsCIELab *original, \
+                                                         const RgbDouble *rgb, \
+                                                         const cmsCIELab *roundtrip, \
+                                                         QRgb *result, \
+                                                         const qsizetype count, \
+                                                         const double maximumChromaSquare, \
+                                                         const double deviationLimitSquare) \
+    { \
+        cielabD50ToQRgbOrTransparentLoop(original, rgb, roundtrip, result, count, maximumChromaSquare, deviationLimitSquare); \
+    }
+
+PERCEPTUALCOLOR_DEFINE_KERNELS(baseline, PERCEPTUALCOLOR_KERNEL_BASELINE)
+#ifdef PERCEPTUALCOLOR_X86_DISPATCH
+PERCEPTUALCOLOR_DEFINE_KERNELS(avx2, PERCEPTUALCOLOR_KERNEL_AVX2)
+PERCEPTUALCOLOR_DEFINE_KERNELS(avx512, PERCEPTUALCOLOR_KERNEL_AVX512)
+#endif
+
+#undef PERCEPTUALCOLOR_DEFINE_KERNELS
+
+/** @internal
+ *
+ * @brief Kernels of @ref InstructionSet::Scalar */
+constexpr ColorKernels scalarKernels{&scalarXyzd65ToOklab, //
+                                     &scalarXyzd65ToOklabFast,
+                                     &scalarOklabToXyzd65,
+                                     &scalarPolarToCartesian,
+                                     &scalarCartesianToPolar,
+                                     &scalarEuclideanDistance,
+                                     &scalarCiede2000,
+                                     &scalarCielabD50InGamut,
+                                     &scalarCielabD50ToQRgbOrTransparent};
+
+/** @internal
+ *
+ * @brief Kernels of @ref InstructionSet::Baseline */
+constexpr ColorKernels baselineKernels{&baselineXyzd65ToOklab, //
+                                       &baselineXyzd65ToOklabFast,
+                                       &baselineOklabToXyzd65,
+                                       &baselinePolarToCartesian,
+                                       &baselineCartesianToPolar,
+                                       &baselineEuclideanDistance,
+                                       &baselineCiede2000,
+                                       &baselineCielabD50InGamut,
+                                       &baselineCielabD50ToQRgbOrTransparent};
+
+#ifdef PERCEPTUALCOLOR_X86_DISPATCH
+/** @internal
+ *
+ * @brief Kernels of @ref InstructionSet::Avx2 */
+constexpr ColorKernels avx2Kernels{&avx2Xyzd65ToOklab, //
+                                   &avx2Xyzd65ToOklabFast,
+                                   &avx2OklabToXyzd65,
+                                   &avx2PolarToCartesian,
+                                   &avx2CartesianToPolar,
+                                   &avx2EuclideanDistance,
+                                   &avx2Ciede2000,
+                                   &avx2CielabD50InGamut,
+                                   &avx2CielabD50ToQRgbOrTransparent};
+
+/** @internal
+ *
+ * @brief Kernels of @ref InstructionSet::Avx512 */
+constexpr ColorKernels avx512Kernels{&avx512Xyzd65ToOklab, //
+                                     &avx512Xyzd65ToOklabFast,
+                                     &avx512OklabToXyzd65,
+                                     &avx512PolarToCartesian,
+                                     &avx512CartesianToPolar,
+                                     &avx512EuclideanDistance,
+                                     &avx512Ciede2000,
+                                     &avx512CielabD50InGamut,
+                                     &avx512CielabD50ToQRgbOrTransparent};
+#endif
+
+} // namespace
+
+/** @internal
+ *
+ * @brief Kernels for a specific instruction set.
+ *
+ * This is useful for testing and benchmarking the different code paths.
+ * For production code, use @ref colorKernels() instead.
+ *
+ * @param instructionSet The requested instruction set. If it is not
+ * supported by the machine (or not available in this build), the best
+ * supported instruction set is used instead.
+ *
+ * @returns Kernels for the requested instruction set. */
+const ColorKernels &colorKernels(const InstructionSet instructionSet)
+{
+    const auto actual = static_cast<InstructionSet>( //
+        qMin(static_cast<int>(instructionSet), //
+             static_cast<int>(detectInstructionSet())));
+    switch (actual) {
+    case InstructionSet::Scalar:
+        return scalarKernels;
+    case InstructionSet::Baseline:
+        return baselineKernels;
+#ifdef PERCEPTUALCOLOR_X86_DISPATCH
+    case InstructionSet::Avx2:
+        return avx2Kernels;
+    case InstructionSet::Avx512:
+        return avx512Kernels;
+#else
+    case InstructionSet::Avx2:
+    case InstructionSet::Avx512:
+        break;
+#endif
+    }
+    return baselineKernels;
+}
+
+/** @internal
+ *
+ * @brief Kernels for the @ref activeInstructionSet().
+ *
+ * @returns Kernels for the @ref activeInstructionSet(). */
+const ColorKernels &colorKernels()
+{
+    static const ColorKernels &result = colorKernels(activeInstructionSet());
+    return result;
+}
+
+} // namespace PerceptualColor
@@ -0,0 +1,130 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef COLORKERNELS_H
+#define COLORKERNELS_H
+
+#include "instructionset.h"
+#include "rgbdouble.h"
+#include <lcms2.h>
+#include <qglobal.h>
+#include <qrgb.h>
+
+/** @internal
+ *
+ * @file
+ *
+ * Batch color conversion kernels with runtime dispatch to the best
+ * instruction set of the CPU. */
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Table of batch color conversion kernels for a specific
+ * @ref InstructionSet.
+ *
+ * All kernels work on arrays. Input and output arrays may be identical
+ * (in-place calculation), but must not overlap otherwise.
+ *
+ * All code paths compute the same formulas. However, the results are not
+ * necessarily bit-identical: Some instruction sets contract multiplications
+ * and additions to fused multiply-add operations, which changes the
+ * rounding. The differences are in the order of magnitude of the machine
+ * epsilon.
+ *
+ * Exception: The trigonometric kernels of @ref InstructionSet::Scalar use
+ * the standard library as reference, while the other code paths use
+ * approximations that can be vectorized. The differences are documented
+ * for each kernel.
+ *
+ * Usage: <tt>colorKernels().xyzd65ToOklab(…)</tt>
+ *
+ * @note Do not use this directly if there is a higher-level function. For
+ * example, prefer the batch versions of
+ * @ref fromXyzd65ToOklab(const double *, const double *, const double *, double *, double *, double *, const qsizetype, const ConversionPrecision)
+ * which use these kernels internally.
+ *
+ * @sa @ref colorKernels() */
+struct ColorKernels {
+    /** @brief Batch conversion from XYZ-D65 to Oklab using
+     * <tt>std::cbrt()</tt>.
+     *
+     * Parameters: x, y, z, oklabL, oklabA, oklabB, count */
+    void (*xyzd65ToOklab)(const double *, const double *, const double *, double *, double *, double *, const qsizetype);
+    /** @brief Batch conversion from XYZ-D65 to Oklab using
+     * @ref fastCubeRoot().
+     *
+     * Parameters: x, y, z, oklabL, oklabA, oklabB, count */
+    void (*xyzd65ToOklabFast)(const double *, const double *, const double *, double *, double *, double *, const qsizetype);
+    /** @brief Batch conversion from Oklab to XYZ-D65.
+     *
+     * Parameters: oklabL, oklabA, oklabB, x, y, z, count */
+    void (*oklabToXyzd65)(const double *, const double *, const double *, double *, double *, double *, const qsizetype);
+    /** @brief Batch conversion from polar to Cartesian coordinates, using
+     * @ref fastSinCosDegree().
+     *
+     * The @ref InstructionSet::Scalar version uses <tt>std::sin()</tt> and
+     * <tt>std::cos()</tt> instead and serves as reference.
+     *
+     * Parameters: radius, angle (in degree), x, y, count */
+    void (*polarToCartesian)(const double *, const double *, double *, double *, const qsizetype);
+    /** @brief Batch conversion from Cartesian to polar coordinates, using
+     * @ref fastAtan2Degree().
+     *
+     * The @ref InstructionSet::Scalar version uses <tt>std::atan2()</tt>
+     * instead and serves as reference.
+     *
+     * Parameters: x, y, radius, angle (in degree, within
+     * <tt>[0°, 360°]</tt>), count */
+    void (*cartesianToPolar)(const double *, const double *, double *, double *, const qsizetype);
+    /** @brief Batch Euclidean distance between pairs of values.
+     *
+     * Parameters: first values, second values, result, count */
+    void (*euclideanDistance)(const cmsCIELab *, const cmsCIELab *, double *, const qsizetype);
+    /** @brief Batch CIEDE2000 color difference between pairs of
+     * CIELab values.
+     *
+     * The @ref InstructionSet::Scalar version uses
+     * @ref deltaE2000(const cmsCIELab &, const cmsCIELab &) and serves as
+     * reference. The other versions use approximations of the
+     * trigonometric functions; the differences are within
+     * @ref deltaE2000BatchMaximumError.
+     *
+     * Parameters: first colors, second colors, result, count */
+    void (*ciede2000)(const cmsCIELab *, const cmsCIELab *, double *, const qsizetype);
+    /** @brief Final step of a batch in-gamut test.
+     *
+     * The in-gamut test of CIELab-D50 values is a round-trip conversion
+     * to RGB and back. This kernel evaluates the results of the
+     * round-trip: A value is in-gamut if its lightness is within
+     * [0, 100], its chroma does not exceed the maximum chroma of the
+     * profile, the RGB value is within [0, 1] and the round-trip
+     * deviation does not exceed the deviation limit.
+     *
+     * Parameters: original CIELab-D50 values, RGB values, round-trip
+     * CIELab-D50 values, result, count, square of the maximum chroma,
+     * square of the deviation limit */
+    void (*cielabD50InGamut)(const cmsCIELab *, const RgbDouble *, const cmsCIELab *, bool *, const qsizetype, const double, const double);
+    /** @brief Final step of a batch conversion from CIELab-D50 to
+     * <tt>QRgb</tt>.
+     *
+     * Like @ref cielabD50InGamut, but instead of a <tt>bool</tt> it
+     * provides the opaque <tt>QRgb</tt> value (quantized with
+     * @ref fromRgbDoubleToQRgb()) for in-gamut values and a transparent
+     * <tt>QRgb</tt> value for out-of-gamut values.
+     *
+     * Parameters: original CIELab-D50 values, RGB values, round-trip
+     * CIELab-D50 values, result, count, square of the maximum chroma,
+     * square of the deviation limit */
+    void (*cielabD50ToQRgbOrTransparent)(const cmsCIELab *, const RgbDouble *, const cmsCIELab *, QRgb *, const qsizetype, const double, const double);
+};
+
+[[nodiscard]] const ColorKernels &colorKernels();
+
+[[nodiscard]] const ColorKernels &colorKernels(const InstructionSet instructionSet);
+
+} // namespace PerceptualColor
+
+#endif // COLORKERNELS_H
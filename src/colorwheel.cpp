@@ -8,8 +8,9 @@
 #include "colorwheel_p.h" // IWYU pragma: associated
 
 #include "abstractdiagram.h"
+#include "asyncimageprovider.h"
 #include "cielchd50values.h"
-#include "colorwheelimage.h"
+#include "colorwheelimageparameters.h"
 #include "constpropagatingrawpointer.h"
 #include "constpropagatinguniquepointer.h"
 #include "helper.h"
@@ -23,6 +24,7 @@
 #include <qpainter.h>
 #include <qpen.h>
 #include <qpoint.h>
+#include <qrect.h>
 #include <qsharedpointer.h>
 #include <qwidget.h>
 
@@ -57,6 +59,12 @@ ColorWheel::ColorWheel(const QSharedPointer<PerceptualColor::RgbColorSpace> &col
     // circle. Therefore, this class simply defaults to
     // Qt::FocusPolicy::TabFocus for QWidget::focusPolicy().
     setFocusPolicy(Qt::FocusPolicy::TabFocus);
+
+    // Connections
+    connect(&d_pointer->m_wheelImage, //
+            &AsyncImageProvider<ColorWheelImageParameters>::interlacingPassCompleted, //
+            this,
+            &ColorWheel::callUpdate);
 }
 
 /** @brief Default destructor */
@@ -71,11 +79,11 @@ ColorWheel::~ColorWheel() noexcept
  *
  * @param colorSpace The color space within which this widget should operate. */
 ColorWheelPrivate::ColorWheelPrivate(ColorWheel *backLink, const QSharedPointer<PerceptualColor::RgbColorSpace> &colorSpace)
-    : m_wheelImage(colorSpace)
-    , q_pointer(backLink)
+    : q_pointer(backLink)
 {
     // Initialization
     m_hue = CielchD50Values::neutralHue;
+    m_wheelImageParameters.rgbColorSpace = colorSpace;
 }
 
 /** @brief Convert widget pixel positions to wheel coordinate points.
@@ -334,13 +342,32 @@ void ColorWheel::paintEvent(QPaintEvent *event)
     bufferPainter.setRenderHint(QPainter::Antialiasing, false);
     // As devicePixelRatioF() might have changed, we make sure everything
     // that might depend on devicePixelRatioF() is updated before painting.
-    d_pointer->m_wheelImage.setBorder(spaceForFocusIndicator() * devicePixelRatioF());
-    d_pointer->m_wheelImage.setDevicePixelRatioF(devicePixelRatioF());
-    d_pointer->m_wheelImage.setImageSize(maximumPhysicalSquareSize());
-    d_pointer->m_wheelImage.setWheelThickness(gradientThickness() * devicePixelRatioF());
-    bufferPainter.drawImage(QPoint(0, 0), // image position (top-left)
-                            d_pointer->m_wheelImage.getImage() // the image itself
-    );
+    d_pointer->m_wheelImageParameters.borderPhysical = //
+        spaceForFocusIndicator() * devicePixelRatioF();
+    d_pointer->m_wheelImageParameters.devicePixelRatioF = devicePixelRatioF();
+    // While the widget is resized, we keep the image size of the
+    // image that we have yet: Rendering all the intermediate sizes would be
+    // wasted effort. Once the size is stable, we get a new paint event.
+    if (!isResizing() || d_pointer->m_wheelImage.getCache().isNull()) {
+        d_pointer->m_wheelImageParameters.imageSizePhysical = //
+            maximumPhysicalSquareSize();
+    }
+    d_pointer->m_wheelImageParameters.wheelThicknessPhysical = //
+        gradientThickness() * devicePixelRatioF();
+    d_pointer->m_wheelImage.setImageParameters( //
+        d_pointer->m_wheelImageParameters);
+    d_pointer->m_wheelImage.refreshAsync();
+    const QImage wheelImage = d_pointer->m_wheelImage.getCache();
+    if (wheelImage.isNull() || (wheelImage.width() == maximumPhysicalSquareSize())) {
+        bufferPainter.drawImage(QPoint(0, 0), // image position (top-left)
+                                wheelImage // the image itself
+        );
+    } else {
+        // Placeholder until the image for the current size is available
+        bufferPainter.drawImage( //
+            QRectF(0, 0, maximumWidgetSquareSize(), maximumWidgetSquareSize()),
+            wheelImage);
+    }
 
     // Paint the handle
     const qreal wheelOuterRadius = maximumWidgetSquareSize() / 2.0 - spaceForFocusIndicator();
@@ -392,10 +419,11 @@ void ColorWheel::paintEvent(QPaintEvent *event)
  * @param event The corresponding resize event */
 void ColorWheel::resizeEvent(QResizeEvent *event)
 {
-    Q_UNUSED(event)
+    AbstractDiagram::resizeEvent(event);
+
+    // The image size is not updated here, but in paintEvent(), which
+    // delays the rendering for the new size while isResizing().
 
-    // Update the widget content
-    d_pointer->m_wheelImage.setImageSize(maximumPhysicalSquareSize());
     /* As by Qt documentation:
      *     “The widget will be erased and receive a paint event immediately
      *      after processing the resize event. No drawing need be (or should
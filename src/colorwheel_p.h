@@ -7,7 +7,8 @@
 // Include the header of the public class of this private implementation.
 // #include "colorwheel.h"
 
-#include "colorwheelimage.h"
+#include "asyncimageprovider.h"
+#include "colorwheelimageparameters.h"
 #include "constpropagatingrawpointer.h"
 #include "polarpointf.h"
 #include <qglobal.h>
@@ -57,7 +58,9 @@ public:
      * color space. */
     QSharedPointer<RgbColorSpace> m_rgbColorSpace;
     /** @brief The image of the wheel itself. */
-    ColorWheelImage m_wheelImage;
+    AsyncImageProvider<ColorWheelImageParameters> m_wheelImage;
+    /** @brief Properties for @ref m_wheelImage. */
+    ColorWheelImageParameters m_wheelImageParameters;
 
     [[nodiscard]] int border() const;
     [[nodiscard]] QPointF fromWheelToWidgetCoordinates(const PolarPointF wheelCoordinates) const;
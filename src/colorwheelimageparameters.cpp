@@ -0,0 +1,501 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own headers
+// First the interface, which forces the header to be self-contained.
+#include "colorwheelimageparameters.h"
+
+#include "asyncimagerendercallback.h"
+#include "cielchd50values.h"
+#include "helperconstants.h"
+#include "helperconversion.h"
+#include "helpermath.h"
+#include "helperposixmath.h"
+#include "interlacingpass.h"
+#include "polarcoordinatetable.h"
+#include "rgbcolorspace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <lcms2.h>
+#include <qbrush.h>
+#include <qglobal.h>
+#include <qlist.h>
+#include <qmath.h>
+#include <qmutex.h>
+#include <qnamespace.h>
+#include <qpainter.h>
+#include <qpen.h>
+#include <qpoint.h>
+#include <qrect.h>
+#include <qrgb.h>
+#include <qsharedpointer.h>
+#include <qsize.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace PerceptualColor
+{
+namespace
+{
+/** @internal
+ *
+ * @brief An entry of the @ref SharedImageCache.
+ *
+ * The entry does not keep the color space alive: The color space is
+ * referenced only by a raw pointer, which is used for the comparison,
+ * and a weak pointer, which tells if the color space still exists. */
+struct SharedImageCacheEntry {
+    /** @brief The parameters, without color space. */
+    ColorWheelImageParameters parameters;
+    /** @brief The color space. */
+    const RgbColorSpace *colorSpace = nullptr;
+    /** @brief The color space. Expires when the color space is
+     * destroyed. */
+    QWeakPointer<RgbColorSpace> weakColorSpace;
+    /** @brief The image. */
+    QImage image;
+};
+
+/** @internal
+ *
+ * @brief Process-wide cache of finished wheel images.
+ *
+ * The images are shared with their users by means of <tt>QImage</tt>’s
+ * implicit sharing. The reference counter of <tt>QImage</tt> therefore
+ * tells if an image is still used: If the copy within this cache is
+ * detached, nobody else uses the image anymore, and it is removed
+ * by @ref purge().
+ *
+ * Access must be protected by @ref mutex. */
+struct SharedImageCache {
+    /** @brief The entries. */
+    QList<SharedImageCacheEntry> entries;
+    /** @brief Mutex that protects all other members. */
+    QMutex mutex;
+    /** @brief Removes all images that are not used anymore, and all
+     * images of color spaces that have been destroyed. */
+    void purge()
+    {
+        for (int i = static_cast<int>(entries.count()) - 1; i >= 0; --i) {
+            if (entries.at(i).image.isDetached() || entries.at(i).weakColorSpace.isNull()) {
+                entries.removeAt(i);
+            }
+        }
+    }
+    /** @brief Search an entry.
+     *
+     * @param parameters The parameters of the image
+     *
+     * @returns The index of the entry for the parameters, or -1. */
+    [[nodiscard]] int indexOf(const ColorWheelImageParameters &parameters) const
+    {
+        ColorWheelImageParameters key = parameters;
+        key.rgbColorSpace.reset();
+        for (int i = 0; i < entries.count(); ++i) {
+            if ((entries.at(i).colorSpace == parameters.rgbColorSpace.data()) //
+                && (entries.at(i).parameters == key)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+/** @internal
+ *
+ * @returns The process-wide cache. */
+SharedImageCache &sharedImageCache()
+{
+    static SharedImageCache cache;
+    return cache;
+}
+
+} // namespace
+
+/** @brief Equal operator
+ *
+ * @param other The object to compare with.
+ *
+ * @returns <tt>true</tt> if equal, <tt>false</tt> otherwise. */
+bool ColorWheelImageParameters::operator==(const ColorWheelImageParameters &other) const
+{
+    return ( //
+        (borderPhysical == other.borderPhysical) //
+        && (devicePixelRatioF == other.devicePixelRatioF) //
+        && (imageSizePhysical == other.imageSizePhysical) //
+        && (rgbColorSpace == other.rgbColorSpace) //
+        && (wheelThicknessPhysical == other.wheelThicknessPhysical) //
+    );
+}
+
+/** @brief Unequal operator
+ *
+ * @param other The object to compare with.
+ *
+ * @returns <tt>true</tt> if unequal, <tt>false</tt> otherwise. */
+bool ColorWheelImageParameters::operator!=(const ColorWheelImageParameters &other) const
+{
+    return !(*this == other);
+}
+
+/** @brief Anti-aliased cut off everything that does not belong to the
+ * wheel.
+ *
+ * @param image The image. Its device pixel ratio must be <tt>1</tt>.
+ * @param parameters The parameters. The values must be within their
+ *        valid range. */
+void ColorWheelImageParameters::cutOffToWheel(QImage &image, const ColorWheelImageParameters &parameters)
+{
+    // Anti-aliased cut off everything outside the circle (that
+    // means: the overlap)
+    // The natural way would be to simply draw a circle with
+    // QPainter::CompositionMode_DestinationIn which should make transparent
+    // everything that is not in the circle. Unfortunately, this does not
+    // seem to work. Therefore, we use a workaround and draw a very think
+    // circle outline around the circle with QPainter::CompositionMode_Clear.
+    const qreal outerCircleDiameter = //
+        parameters.imageSizePhysical - 2 * parameters.borderPhysical;
+    const qreal circleRadius = outerCircleDiameter / 2;
+    const qreal cutOffThickness = //
+        qSqrt(qPow(parameters.imageSizePhysical, 2) * 2) / 2 // ½ of image diagonal
+        - circleRadius // circle radius
+        + overlap; // just to be sure
+    QPainter myPainter(&image);
+    myPainter.setRenderHint(QPainter::Antialiasing, true);
+    myPainter.setPen(QPen(Qt::SolidPattern, cutOffThickness));
+    myPainter.setCompositionMode(QPainter::CompositionMode_Clear);
+    const qreal halfImageSize = parameters.imageSizePhysical / static_cast<qreal>(2);
+    myPainter.drawEllipse(QPointF(halfImageSize, halfImageSize), // center
+                          circleRadius + cutOffThickness / 2, // width
+                          circleRadius + cutOffThickness / 2 // height
+    );
+
+    // set the inner circle of the wheel to anti-aliased transparency
+    const qreal innerCircleDiameter = //
+        parameters.imageSizePhysical //
+        - 2 * (parameters.wheelThicknessPhysical + parameters.borderPhysical);
+    if (innerCircleDiameter > 0) {
+        myPainter.setCompositionMode(QPainter::CompositionMode_Clear);
+        myPainter.setRenderHint(QPainter::Antialiasing, true);
+        myPainter.setPen(QPen(Qt::NoPen));
+        myPainter.setBrush(QBrush(Qt::SolidPattern));
+        myPainter.drawEllipse( //
+            QRectF(parameters.wheelThicknessPhysical + parameters.borderPhysical, //
+                   parameters.wheelThicknessPhysical + parameters.borderPhysical, //
+                   innerCircleDiameter, //
+                   innerCircleDiameter));
+    }
+}
+
+/** @brief Render an image.
+ *
+ * The function will render the image with the given parameters,
+ * and deliver the result of each interlacing pass and also the final
+ * result by means of <tt>callbackObject</tt>.
+ *
+ * This function is thread-safe as long as each call of this function
+ * uses different <tt>variantParameters</tt> and <tt>callbackObject</tt>.
+ *
+ * @param variantParameters A <tt>QVariant</tt> that contains the
+ *        image parameters.
+ * @param callbackObject Pointer to the object for the callbacks. */
+void ColorWheelImageParameters::render(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject)
+{
+    if (!variantParameters.canConvert<ColorWheelImageParameters>()) {
+        return;
+    }
+    ColorWheelImageParameters parameters = //
+        variantParameters.value<ColorWheelImageParameters>();
+    parameters.borderPhysical = qMax<qreal>(parameters.borderPhysical, 0);
+    parameters.devicePixelRatioF = qMax<qreal>(parameters.devicePixelRatioF, 1);
+    parameters.imageSizePhysical = qMax(parameters.imageSizePhysical, 0);
+    parameters.wheelThicknessPhysical = //
+        qMax<qreal>(parameters.wheelThicknessPhysical, 0);
+
+    // From Qt Example’s documentation:
+    //
+    //     “If we discover […] that restart has been set
+    //      to true (by render()), we break out […] immediately […].
+    //      Similarly, if we discover that abort has been set
+    //      to true (by the […] destructor), we return from the
+    //      function immediately […].”
+    if (callbackObject.shouldAbort()) {
+        return;
+    }
+
+    // Special case: zero-size-image
+    if (parameters.imageSizePhysical <= 0) {
+        callbackObject.deliverInterlacingPass( //
+            QImage(), //
+            variantParameters, //
+            AsyncImageRenderCallback::InterlacingState::Final);
+        return;
+    }
+
+    // Identical wheels are rendered only once.
+    {
+        SharedImageCache &cache = sharedImageCache();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        QMutexLocker<QMutex> locker(&cache.mutex);
+#else
+        QMutexLocker locker(&cache.mutex);
+#endif
+        cache.purge();
+        const int index = cache.indexOf(parameters);
+        if (index >= 0) {
+            // Copy while the mutex is locked, so that the image is not
+            // purged in the meantime.
+            const QImage cachedImage = cache.entries.at(index).image;
+            locker.unlock();
+            callbackObject.deliverInterlacingPass( //
+                cachedImage, //
+                variantParameters, //
+                AsyncImageRenderCallback::InterlacingState::Final);
+            return;
+        }
+    }
+
+    // construct our final QImage with transparent background
+    QImage myImage(QSize(parameters.imageSizePhysical, parameters.imageSizePhysical), //
+                   QImage::Format_ARGB32_Premultiplied);
+    // Because there may be out-of-gamut colors for some hue (depending on the
+    // given lightness and chroma value) which are drawn transparent, it is
+    // important to initialize this image with a transparent background.
+    myImage.fill(Qt::transparent);
+
+    // Calculate diameter of the outer circle
+    const qreal outerCircleDiameter = //
+        parameters.imageSizePhysical - 2 * parameters.borderPhysical;
+
+    // Special case: an empty image
+    if ((outerCircleDiameter <= 0) || parameters.rgbColorSpace.isNull()) {
+        // Make sure to return a completely transparent image.
+        // If we would continue, in spite of an outer diameter of 0,
+        // we might get a non-transparent pixel in the middle.
+        // Set the correct scaling information for the image and return
+        myImage.setDevicePixelRatio(parameters.devicePixelRatioF);
+        callbackObject.deliverInterlacingPass( //
+            myImage, //
+            variantParameters, //
+            AsyncImageRenderCallback::InterlacingState::Final);
+        return;
+    }
+
+    // Generate a temporary non-anti-aliased, intermediate, color wheel,
+    // but with some pixels extra at the inner and outer side. The overlap
+    // defines an overlap for the wheel, so there are some more pixels that
+    // are drawn at the outer and at the inner border of the wheel, to allow
+    // later clipping with anti-aliasing
+    const qreal center = (parameters.imageSizePhysical - 1) / static_cast<qreal>(2);
+    // Radius and angle of each pixel depend only on the image size, so they
+    // are looked up instead of being calculated again for each new image.
+    const auto polarTable = PolarCoordinateTable::forImageSize( //
+        parameters.imageSizePhysical);
+    // minimumRadial: Adding "+ 1" would reduce the workload (less pixel to
+    // process) and still work mostly, but not completely. It creates sometimes
+    // artifacts in the anti-aliasing process. So we don't do that.
+    const qreal minimumRadial = center //
+        - parameters.wheelThicknessPhysical //
+        - parameters.borderPhysical //
+        - overlap;
+    const qreal maximumRadial = center - parameters.borderPhysical + overlap;
+
+    // All pixels of the wheel have the same lightness and chroma, so their
+    // color depends only on the hue. The colors are therefore calculated
+    // once for a table of hues, with a single batch conversion. With at
+    // least one hue per pixel at the outer circumference, neighboring hues
+    // in the table differ by less than one pixel. Out-of-gamut hues are
+    // transparent in the table.
+    const auto hueCount = static_cast<int>( //
+        qBound(360., std::ceil(2 * pi * maximumRadial), 8192.));
+    std::vector<cmsCIELab> hueCielabD50(static_cast<std::size_t>(hueCount));
+    cmsCIELCh cielchD50;
+    cielchD50.L = CielchD50Values::neutralLightness;
+    cielchD50.C = CielchD50Values::srgbVersatileChroma;
+    for (int i = 0; i < hueCount; ++i) {
+        cielchD50.h = 360. * i / hueCount;
+        hueCielabD50[static_cast<std::size_t>(i)] = toCmsLab(cielchD50);
+    }
+    std::vector<QRgb> hueColor(hueCielabD50.size());
+    parameters.rgbColorSpace->fromCielabD50ToQRgbOrTransparent( //
+        hueCielabD50.data(),
+        hueColor.data(),
+        hueCount);
+    const float huesPerDegree = static_cast<float>(hueCount) / 360;
+
+    // Opaque and fully transparent colors are identical in premultiplied
+    // and non-premultiplied form, so the table values can be written
+    // directly to the scanlines.
+    // Only the annulus span of each line is visited: Between the outer
+    // circle and the inner circle on the left side, and between the inner
+    // circle and the outer circle on the right side. Each pixel of the
+    // annulus that belongs to the current pass fills the rectangle of
+    // the pass. Rectangles might reach beyond the annulus, but these
+    // pixels are cut off by cutOffToWheel() anyway.
+    const auto writeSpan = [&](const InterlacingPass &pass, const int y, int first, int last) {
+        first = qMax(first, 0);
+        last = qMin(last, parameters.imageSizePhysical - 1);
+        // First column of the pass within the span
+        first += ((pass.columnOffset - first) % pass.columnFrequency //
+                  + pass.columnFrequency)
+            % pass.columnFrequency;
+        const int lastLine = qMin( //
+            y + pass.rectangleSize.height(),
+            parameters.imageSizePhysical);
+        for (int x = first; x <= last; x += pass.columnFrequency) {
+            if (!isInRange<qreal>(minimumRadial, polarTable->radius(x, y), maximumRadial)) {
+                continue;
+            }
+            // We are within the wheel
+            int hueIndex = qRound(polarTable->angleDegree(x, y) * huesPerDegree);
+            if (hueIndex >= hueCount) {
+                hueIndex -= hueCount;
+            }
+            const QRgb color = hueColor[static_cast<std::size_t>(hueIndex)];
+            const int lastColumn = qMin( //
+                x + pass.rectangleSize.width(),
+                parameters.imageSizePhysical);
+            for (int line = y; line < lastLine; ++line) {
+                auto *const scanLine = //
+                    reinterpret_cast<QRgb *>(myImage.scanLine(line));
+                std::fill(scanLine + x, scanLine + lastColumn, color);
+            }
+        }
+    };
+
+    // The wheel is cheap compared to the chroma-hue diagram, so fewer
+    // passes are enough.
+    constexpr auto numberOfPasses = 5;
+    static_assert(isOdd(numberOfPasses));
+    InterlacingPass currentPass{numberOfPasses};
+    while (true) {
+        for (int y = currentPass.lineOffset; //
+             y < parameters.imageSizePhysical; //
+             y += currentPass.lineFrequency) //
+        {
+            if (callbackObject.shouldAbort()) {
+                return;
+            }
+            const qreal dy = center - y;
+            const qreal outerSquare = maximumRadial * maximumRadial - dy * dy;
+            if (outerSquare < 0) {
+                continue;
+            }
+            // One pixel more on each side, to be safe from rounding errors.
+            // The exact test is done anyway by writeSpan().
+            const qreal outerHalfWidth = std::sqrt(outerSquare) + 1;
+            const qreal innerSquare = minimumRadial * minimumRadial - dy * dy;
+            const qreal innerHalfWidth = ((minimumRadial > 0) && (innerSquare > 0)) //
+                ? std::sqrt(innerSquare) - 1
+                : -1;
+            const int outerLeft = qFloor(center - outerHalfWidth);
+            const int outerRight = qCeil(center + outerHalfWidth);
+            if (innerHalfWidth <= 0) {
+                writeSpan(currentPass, y, outerLeft, outerRight);
+            } else {
+                writeSpan(currentPass, y, outerLeft, qCeil(center - innerHalfWidth));
+                writeSpan(currentPass, y, qFloor(center + innerHalfWidth), outerRight);
+            }
+        }
+
+        const AsyncImageRenderCallback::InterlacingState state = //
+            (currentPass.countdown > 1) //
+            ? AsyncImageRenderCallback::InterlacingState::Intermediate //
+            : AsyncImageRenderCallback::InterlacingState::Final;
+
+        if (state == AsyncImageRenderCallback::InterlacingState::Intermediate) {
+            // The following passes still need the pixels of the overlap,
+            // so the cut off is done on a copy.
+            QImage intermediateImage = myImage.copy();
+            cutOffToWheel(intermediateImage, parameters);
+            intermediateImage.setDevicePixelRatio(parameters.devicePixelRatioF);
+            callbackObject.deliverInterlacingPass(intermediateImage, variantParameters, state);
+            currentPass.switchToNextPass();
+        } else {
+            cutOffToWheel(myImage, parameters);
+            // Set the correct scaling information for the image and return
+            myImage.setDevicePixelRatio(parameters.devicePixelRatioF);
+            addToSharedCache(parameters, myImage);
+            callbackObject.deliverInterlacingPass(myImage, variantParameters, state);
+            return;
+        }
+    }
+}
+
+/** @brief Adds an image to the process-wide cache.
+ *
+ * @param parameters The parameters of the image. The values must be
+ *        within their valid range.
+ * @param image The final image.
+ *
+ * If another thread has yet added an image with the same parameters in
+ * the meantime, the cache is left unchanged.
+ *
+ * The cache does not keep the color space alive. */
+void ColorWheelImageParameters::addToSharedCache(const ColorWheelImageParameters &parameters, const QImage &image)
+{
+    SharedImageCache &cache = sharedImageCache();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QMutexLocker<QMutex> locker(&cache.mutex);
+#else
+    QMutexLocker locker(&cache.mutex);
+#endif
+    cache.purge();
+    if (parameters.rgbColorSpace.isNull() || (cache.indexOf(parameters) >= 0)) {
+        return;
+    }
+    ColorWheelImageParameters key = parameters;
+    key.rgbColorSpace.reset();
+    cache.entries.append(SharedImageCacheEntry{key, //
+                                               parameters.rgbColorSpace.data(),
+                                               parameters.rgbColorSpace.toWeakRef(),
+                                               image});
+}
+
+/** @brief Number of images in the process-wide cache.
+ *
+ * @returns The number of different images that are currently shared
+ * through the process-wide cache.
+ *
+ * This function is thread-safe. */
+int ColorWheelImageParameters::sharedCacheCount()
+{
+    SharedImageCache &cache = sharedImageCache();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QMutexLocker<QMutex> locker(&cache.mutex);
+#else
+    QMutexLocker locker(&cache.mutex);
+#endif
+    cache.purge();
+    return static_cast<int>(cache.entries.count());
+}
+
+/** @brief Memory used by the process-wide cache.
+ *
+ * @returns The memory used by the pixel data of all images that are
+ * currently shared through the process-wide cache, measured in bytes.
+ * Each image is counted only once, regardless of how many users
+ * share it.
+ *
+ * This function is thread-safe. */
+qsizetype ColorWheelImageParameters::sharedCacheSizeInBytes()
+{
+    SharedImageCache &cache = sharedImageCache();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QMutexLocker<QMutex> locker(&cache.mutex);
+#else
+    QMutexLocker locker(&cache.mutex);
+#endif
+    cache.purge();
+    qsizetype result = 0;
+    for (const SharedImageCacheEntry &entry : std::as_const(cache.entries)) {
+        result += static_cast<qsizetype>(entry.image.sizeInBytes());
+    }
+    return result;
+}
+
+static_assert(std::is_standard_layout_v<ColorWheelImageParameters>);
+
+} // namespace PerceptualColor
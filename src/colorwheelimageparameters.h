@@ -0,0 +1,105 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef COLORWHEELIMAGEPARAMETERS_H
+#define COLORWHEELIMAGEPARAMETERS_H
+
+#include <qglobal.h>
+#include <qimage.h>
+#include <qmetatype.h>
+#include <qsharedpointer.h>
+#include <qvariant.h>
+
+namespace PerceptualColor
+{
+class AsyncImageRenderCallback;
+class RgbColorSpace;
+
+/** @internal
+ *
+ * @brief Parameters for an image of a color wheel.
+ *
+ * For usage with @ref AsyncImageProvider.
+ *
+ * @warning The default constructor constructs an object with an empty
+ * @ref rgbColorSpace. Before using this object, you should initialize
+ * @ref rgbColorSpace.
+ *
+ * The image is a square of <tt>QSize(@ref imageSizePhysical,
+ * @ref imageSizePhysical)</tt>. All pixels that do not belong to the
+ * wheel itself are transparent. Antialiasing is used, so there is no
+ * sharp border between transparent and non-transparent parts. Depending
+ * on the values for lightness and chroma and the available colors in
+ * the current color space, there may be some hue who is out of
+ * gamut; if so, this part of the wheel will be transparent.
+ *
+ * This type supports HiDPI via @ref devicePixelRatioF. Within a method of
+ * a class derived from <tt>QWidget</tt>, you could write:
+ *
+ * @snippet testcolorwheelimageparameters.cpp ColorWheelImageParameters HiDPI usage
+ *
+ * Identical wheels are rendered only once per process: Finished images
+ * are kept in a process-wide cache and are shared by means of
+ * <tt>QImage</tt>’s implicit sharing. An image stays in this cache as
+ * long as at least one copy of it is still used somewhere else. A
+ * @ref ColorDialog, which shows the same wheel in two different widgets,
+ * benefits from this, and so do several open dialogs. The memory that is
+ * used by this cache is reported by @ref sharedCacheSizeInBytes().
+ *
+ * This type is declared as type to Qt’s type system via
+ * <tt>Q_DECLARE_METATYPE</tt>. Depending on your use case (for
+ * example if you want to use for <em>queued</em> signal-slot connections),
+ * you might consider calling <tt>qRegisterMetaType()</tt> for
+ * this type, once you have a QApplication object.
+ *
+ * @todo Out-of-gamut situations should automatically be handled. */
+struct ColorWheelImageParameters final {
+public:
+    /** @brief The border size, measured in physical pixels.
+     *
+     * The border is the space between the outer outline of the wheel and
+     * the limits of the image. The wheel is always centered within the
+     * limits of the image. The default value is <tt>0</tt>, which means
+     * that the wheel touches the limits of the image. Negative values are
+     * treated as <tt>0</tt>. */
+    qreal borderPhysical = 0;
+    /** @brief The device pixel ratio as floating point.
+     *
+     * This value is set as device pixel ratio in the <tt>QImage</tt>. It
+     * does <em>not</em> change the <em>pixel</em> size of the image or
+     * the pixel size of wheel thickness or border. Values smaller than
+     * <tt>1</tt> are treated as <tt>1</tt>. */
+    qreal devicePixelRatioF = 1;
+    /** @brief Image size, measured in physical pixels.
+     *
+     * Negative values are treated as <tt>0</tt>. */
+    int imageSizePhysical = 0;
+    /** @brief Pointer to @ref RgbColorSpace object
+     *
+     * @warning The default constructor constructs an object with an empty
+     * @ref rgbColorSpace. Before using this object, you must initialize
+     * @ref rgbColorSpace. */
+    QSharedPointer<PerceptualColor::RgbColorSpace> rgbColorSpace = nullptr;
+    /** @brief The wheel thickness, measured in physical pixels.
+     *
+     * The wheel thickness is the distance between the inner outline and the
+     * outer outline of the wheel. Negative values are treated
+     * as <tt>0</tt>. */
+    qreal wheelThicknessPhysical = 0;
+    [[nodiscard]] bool operator==(const ColorWheelImageParameters &other) const;
+    [[nodiscard]] bool operator!=(const ColorWheelImageParameters &other) const;
+
+    static void render(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject);
+    [[nodiscard]] static int sharedCacheCount();
+    [[nodiscard]] static qsizetype sharedCacheSizeInBytes();
+
+private:
+    static void addToSharedCache(const ColorWheelImageParameters &parameters, const QImage &image);
+    static void cutOffToWheel(QImage &image, const ColorWheelImageParameters &parameters);
+};
+
+} // namespace PerceptualColor
+
+Q_DECLARE_METATYPE(PerceptualColor::ColorWheelImageParameters)
+
+#endif // COLORWHEELIMAGEPARAMETERS_H
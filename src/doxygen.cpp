@@ -550,7 +550,7 @@
  * @todo Remove setDevicePixelRatioF from all *Image classes. (It is
  * confusing, and at the same time there is no real need/benefit.)
  * Complete list: @ref PerceptualColor::ChromaHueImageParameters,
- * @ref PerceptualColor::ColorWheelImage,
+ * @ref PerceptualColor::ColorWheelImageParameters,
  * @ref PerceptualColor::GradientImageParameters.
  *
  * @todo Test also on Windows. (Does it work well with VisualStudio?)
@@ -0,0 +1,180 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own headers
+// First the interface, which forces the header to be self-contained.
+#include "gamutboundaryantialiasing.h"
+
+#include "asyncimagerendercallback.h"
+#include "helper.h"
+#include "rgbcolorspace.h"
+#include <cstddef>
+#include <qbitarray.h>
+#include <qimage.h>
+#include <vector>
+
+namespace PerceptualColor
+{
+
+/** @brief Anti-aliases the gamut boundary of an image.
+ *
+ * Finds the pixels at the gamut boundary and supersamples them. The new
+ * color of such a pixel is the average of its subsamples: In-gamut
+ * subsamples contribute their color, out-of-gamut subsamples contribute
+ * the <tt>background</tt>.
+ *
+ * This function is thread-safe as long as each call of this function
+ * uses a different <tt>image</tt> and <tt>callbackObject</tt>.
+ *
+ * @param image The image. Format:
+ *        <tt>QImage::Format_ARGB32_Premultiplied</tt>
+ * @param inGamutMask The gamut membership of the middle of each pixel.
+ *        <tt>true</tt> for in-gamut pixels. Index: <tt>x + y * width</tt>
+ * @param colorSpace The color space
+ * @param cielabD50 Provides the color for a given coordinate point within
+ *        the image. The pixel at position <tt>(x, y)</tt> covers the
+ *        square from <tt>(x, y)</tt> to <tt>(x + 1, y + 1)</tt>.
+ * @param background The color of out-of-gamut subsamples, as premultiplied
+ *        value. Might be transparent.
+ * @param pixels The pixels that can be modified.
+ * @param threadCount Maximum number of threads. <tt>0</tt> means
+ *        <tt>QThread::idealThreadCount()</tt>. The result does not depend
+ *        on this value.
+ * @param callbackObject Provides <tt>shouldAbort()</tt>, which is called
+ *        from various threads.
+ * @param statistics If not <tt>nullptr</tt>, the extra work is added to
+ *        this object.
+ *
+ * @returns <tt>false</tt> if aborted, <tt>true</tt> otherwise. The image
+ * might be partially anti-aliased after an abort. */
+bool GamutBoundaryAntialiasing::apply(QImage &image,
+                                      const QBitArray &inGamutMask,
+                                      const RgbColorSpace &colorSpace,
+                                      const std::function<cmsCIELab(double x, double y)> &cielabD50,
+                                      const QRgb background,
+                                      const Pixels pixels,
+                                      const int threadCount,
+                                      AsyncImageRenderCallback &callbackObject,
+                                      Statistics *statistics)
+{
+    const int width = image.width();
+    const int height = image.height();
+    if ((width <= 0) || (height <= 0) || (inGamutMask.size() != width * height)) {
+        return true;
+    }
+    const auto isInGamut = [&](const int x, const int y) -> bool {
+        return inGamutMask.testBit(x + y * width);
+    };
+    const auto isEdge = [&](const int x, const int y) -> bool {
+        const bool center = isInGamut(x, y);
+        return ((x > 0) && (isInGamut(x - 1, y) != center)) //
+            || ((x + 1 < width) && (isInGamut(x + 1, y) != center)) //
+            || ((y > 0) && (isInGamut(x, y - 1) != center)) //
+            || ((y + 1 < height) && (isInGamut(x, y + 1) != center));
+    };
+
+    // bits() detaches the image from copies that have been delivered
+    // before. It must be called here, before the parallel rendering.
+    uchar *const imageBits = image.bits();
+    const auto bytesPerLine = image.bytesPerLine();
+    constexpr int subsamplesPerPixel = subsamplesPerAxis * subsamplesPerAxis;
+    constexpr double subsampleDistance = 1.0 / subsamplesPerAxis;
+    constexpr auto subsampleStride = static_cast<std::size_t>(subsamplesPerPixel);
+
+    // Each band collects the edge pixels of its lines first and then
+    // converts all their subsamples together with a single call to the
+    // batch conversion of RgbColorSpace. Different bands never write to
+    // the same pixels.
+    constexpr int linesPerBand = 16;
+    const int bandCount = (height + linesPerBand - 1) / linesPerBand;
+    std::vector<Statistics> bandStatistics(static_cast<std::size_t>(bandCount));
+    const auto antialiasBand = [&](const int band) {
+        if (callbackObject.shouldAbort()) {
+            return;
+        }
+        std::vector<int> edgeX;
+        std::vector<int> edgeY;
+        const int firstLine = band * linesPerBand;
+        const int lastLine = qMin(firstLine + linesPerBand, height);
+        for (int y = firstLine; y < lastLine; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if ((pixels == Pixels::InGamutOnly) && !isInGamut(x, y)) {
+                    continue;
+                }
+                if (isEdge(x, y)) {
+                    edgeX.push_back(x);
+                    edgeY.push_back(y);
+                }
+            }
+        }
+        if (edgeX.empty()) {
+            return;
+        }
+        std::vector<cmsCIELab> subsampleCielabD50;
+        subsampleCielabD50.reserve(edgeX.size() * subsampleStride);
+        for (std::size_t i = 0; i < edgeX.size(); ++i) {
+            for (int row = 0; row < subsamplesPerAxis; ++row) {
+                const double y = edgeY[i] + (row + 0.5) * subsampleDistance;
+                for (int column = 0; column < subsamplesPerAxis; ++column) {
+                    const double x = edgeX[i] + (column + 0.5) * subsampleDistance;
+                    subsampleCielabD50.push_back(cielabD50(x, y));
+                }
+            }
+        }
+        std::vector<QRgb> subsampleRgb(subsampleCielabD50.size());
+        colorSpace.fromCielabD50ToQRgbOrTransparent( //
+            subsampleCielabD50.data(),
+            subsampleRgb.data(),
+            static_cast<qsizetype>(subsampleCielabD50.size()));
+        auto &myStatistics = bandStatistics[static_cast<std::size_t>(band)];
+        myStatistics.edgePixels += static_cast<qint64>(edgeX.size());
+        myStatistics.subsamples += static_cast<qint64>(subsampleRgb.size());
+
+        // In-gamut subsamples are opaque, so their colors are identical
+        // in premultiplied and non-premultiplied form. The average is
+        // calculated in premultiplied form, with rounding.
+        for (std::size_t i = 0; i < edgeX.size(); ++i) {
+            int inGamutCount = 0;
+            int red = 0;
+            int green = 0;
+            int blue = 0;
+            for (int j = 0; j < subsamplesPerPixel; ++j) {
+                const QRgb color = subsampleRgb[i * subsampleStride + static_cast<std::size_t>(j)];
+                if (qAlpha(color) != 0) {
+                    ++inGamutCount;
+                    red += qRed(color);
+                    green += qGreen(color);
+                    blue += qBlue(color);
+                }
+            }
+            if ((pixels == Pixels::InGamutOnly) && (inGamutCount == 0)) {
+                continue;
+            }
+            const int backgroundCount = subsamplesPerPixel - inGamutCount;
+            const auto average = [&](const int inGamutSum, const int backgroundValue) {
+                return (inGamutSum + backgroundValue * backgroundCount + subsamplesPerPixel / 2) //
+                    / subsamplesPerPixel;
+            };
+            auto *const scanLine = reinterpret_cast<QRgb *>( //
+                imageBits + static_cast<qsizetype>(edgeY[i]) * bytesPerLine);
+            scanLine[edgeX[i]] = qRgba(average(red, qRed(background)),
+                                       average(green, qGreen(background)),
+                                       average(blue, qBlue(background)),
+                                       average(255 * inGamutCount, qAlpha(background)));
+        }
+    };
+    runInParallel(bandCount, threadCount, antialiasBand);
+    if (callbackObject.shouldAbort()) {
+        return false;
+    }
+
+    if (statistics != nullptr) {
+        for (const auto &item : bandStatistics) {
+            statistics->edgePixels += item.edgePixels;
+            statistics->subsamples += item.subsamples;
+        }
+    }
+    return true;
+}
+
+} // namespace PerceptualColor
@@ -0,0 +1,76 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef GAMUTBOUNDARYANTIALIASING_H
+#define GAMUTBOUNDARYANTIALIASING_H
+
+#include <functional>
+#include <lcms2.h>
+#include <qglobal.h>
+#include <qrgb.h>
+
+class QBitArray;
+class QImage;
+
+namespace PerceptualColor
+{
+
+class AsyncImageRenderCallback;
+class RgbColorSpace;
+
+/** @internal
+ *
+ * @brief Anti-aliasing of the gamut boundary within a rendered diagram.
+ *
+ * The diagram images decide gamut membership with a single sample at the
+ * middle of each pixel. Therefore, the gamut boundary looks jagged. Rendering
+ * the whole image at a higher resolution would be too slow. However, only
+ * the pixels at the gamut boundary need more samples: These are the pixels
+ * with at least one direct neighbor that has a different gamut membership.
+ * Only these pixels are supersampled with
+ * <tt>@ref subsamplesPerAxis × @ref subsamplesPerAxis</tt> samples. All
+ * other pixels stay untouched, so the extra work is proportional to the
+ * length of the boundary, not to the area of the image. */
+struct GamutBoundaryAntialiasing final {
+public:
+    /** @brief The pixels that can be modified by @ref apply(). */
+    enum class Pixels {
+        /** @brief All pixels at the gamut boundary. */
+        All,
+        /** @brief Only in-gamut pixels at the gamut boundary.
+         *
+         * These pixels get at least one in-gamut subsample, otherwise they
+         * stay untouched. Out-of-gamut pixels stay untouched anyway. So if
+         * the background is transparent, the alpha channel of the image
+         * still tells reliably the gamut membership of the middle of each
+         * pixel. */
+        InGamutOnly
+    };
+
+    /** @brief Number of subsamples per axis for each pixel. */
+    static constexpr int subsamplesPerAxis = 4;
+
+    /** @brief Statistics of @ref apply(). */
+    struct Statistics {
+        /** @brief Number of pixels at the gamut boundary that have been
+         * supersampled. */
+        qint64 edgePixels = 0;
+        /** @brief Number of subsamples that have been converted (each with
+         * a round-trip transform). */
+        qint64 subsamples = 0;
+    };
+
+    [[nodiscard]] static bool apply(QImage &image,
+                                    const QBitArray &inGamutMask,
+                                    const RgbColorSpace &colorSpace,
+                                    const std::function<cmsCIELab(double x, double y)> &cielabD50,
+                                    const QRgb background,
+                                    const Pixels pixels,
+                                    const int threadCount,
+                                    AsyncImageRenderCallback &callbackObject,
+                                    Statistics *statistics);
+};
+
+} // namespace PerceptualColor
+
+#endif // GAMUTBOUNDARYANTIALIASING_H
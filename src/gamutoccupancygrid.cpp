@@ -0,0 +1,158 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own headers
+// First the interface, which forces the header to be self-contained.
+#include "gamutoccupancygrid.h"
+
+#include <cmath>
+#include <memory>
+#include <qmath.h>
+
+namespace PerceptualColor
+{
+
+/** @brief Constructor
+ *
+ * Builds the grid. This is expensive, as it calls the exact test for
+ * all samples, so it should be done in a background thread.
+ *
+ * @param exactTest The exact gamut test. It must be thread-safe if the
+ *        grid is built in a background thread.
+ * @param maximumChroma The maximum chroma of the gamut. Colors with a
+ *        higher chroma are out-of-gamut.
+ * @param cellSize The distance between neighboring samples, measured in
+ *        CIELab units. Smaller values give more uniform cells, but need
+ *        more memory and more time to build. Must be greater than 0.
+ * @param abortFlag If not <tt>nullptr</tt>, the build is aborted as soon
+ *        as possible when the flag becomes <tt>true</tt>. The grid
+ *        is not @ref isValid() then. */
+GamutOccupancyGrid::GamutOccupancyGrid(const ExactTest &exactTest, const double maximumChroma, const double cellSize, const std::atomic<bool> *abortFlag)
+    : m_cellSize(qMax(cellSize, 0.01))
+{
+    const double chroma = qMax(maximumChroma, 0.);
+    // One more sample than cells: The last sample is at or beyond the limit.
+    m_lightnessCount = qCeil(100 / m_cellSize) + 1;
+    m_abCount = 2 * qCeil(chroma / m_cellSize) + 1;
+    m_abOrigin = -qCeil(chroma / m_cellSize) * m_cellSize;
+    const qsizetype sampleCount = //
+        static_cast<qsizetype>(m_lightnessCount) * m_abCount * m_abCount;
+    const auto wordCount = static_cast<std::size_t>((sampleCount + 63) / 64);
+    m_samples.assign(wordCount, 0);
+
+    // Sample the exact test row by row, so that an abort request is
+    // noticed quickly.
+    const auto rowSize = static_cast<std::size_t>(m_abCount);
+    std::vector<cmsCIELab> row(rowSize);
+    std::unique_ptr<bool[]> rowResult(new bool[rowSize]);
+    for (int l = 0; l < m_lightnessCount; ++l) {
+        const double lightness = l * m_cellSize;
+        if (lightness > 100) {
+            continue; // Out-of-gamut: The bits stay 0.
+        }
+        for (int a = 0; a < m_abCount; ++a) {
+            if ((abortFlag != nullptr) && abortFlag->load()) {
+                return;
+            }
+            for (int b = 0; b < m_abCount; ++b) {
+                row[static_cast<std::size_t>(b)] = //
+                    cmsCIELab{lightness, //
+                              m_abOrigin + a * m_cellSize, //
+                              m_abOrigin + b * m_cellSize};
+            }
+            exactTest(row.data(), rowResult.get(), m_abCount);
+            for (int b = 0; b < m_abCount; ++b) {
+                if (rowResult[static_cast<std::size_t>(b)]) {
+                    setBit(m_samples, sampleIndex(l, a, b));
+                }
+            }
+        }
+    }
+
+    // Find the uniform cells: All samples from one sample before
+    // the cell up to one sample after the cell must be equal.
+    m_uniformCells.assign(wordCount, 0);
+    for (int l = 0; l + 1 < m_lightnessCount; ++l) {
+        const int lFirst = qMax(l - 1, 0);
+        const int lLast = qMin(l + 2, m_lightnessCount - 1);
+        for (int a = 0; a + 1 < m_abCount; ++a) {
+            if ((abortFlag != nullptr) && abortFlag->load()) {
+                return;
+            }
+            const int aFirst = qMax(a - 1, 0);
+            const int aLast = qMin(a + 2, m_abCount - 1);
+            for (int b = 0; b + 1 < m_abCount; ++b) {
+                const int bFirst = qMax(b - 1, 0);
+                const int bLast = qMin(b + 2, m_abCount - 1);
+                const bool reference = bit(m_samples, sampleIndex(l, a, b));
+                bool isUniform = true;
+                for (int i = lFirst; isUniform && (i <= lLast); ++i) {
+                    for (int j = aFirst; isUniform && (j <= aLast); ++j) {
+                        for (int k = bFirst; k <= bLast; ++k) {
+                            if (bit(m_samples, sampleIndex(i, j, k)) != reference) {
+                                isUniform = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (isUniform) {
+                    setBit(m_uniformCells, sampleIndex(l, a, b));
+                }
+            }
+        }
+    }
+
+    m_isValid = true;
+}
+
+/** @brief Sets a bit.
+ *
+ * @param bits The bit-packed data
+ * @param index The index of the bit */
+void GamutOccupancyGrid::setBit(std::vector<quint64> &bits, const qsizetype index)
+{
+    bits[static_cast<std::size_t>(index >> 6)] |= (quint64(1) << (index & 63));
+}
+
+/** @brief Gamut membership of a color.
+ *
+ * @param lab The color
+ *
+ * @returns The gamut membership of the color. Colors outside of the area
+ * covered by the grid get always @ref Occupancy::Boundary. */
+GamutOccupancyGrid::Occupancy GamutOccupancyGrid::occupancy(const cmsCIELab &lab) const
+{
+    if (!m_isValid) {
+        return Occupancy::Boundary;
+    }
+    const double lPosition = std::floor(lab.L / m_cellSize);
+    const double aPosition = std::floor((lab.a - m_abOrigin) / m_cellSize);
+    const double bPosition = std::floor((lab.b - m_abOrigin) / m_cellSize);
+    // The negated comparisons catch also NaN.
+    const bool isCovered = //
+        (lPosition >= 0) && (lPosition < m_lightnessCount - 1) //
+        && (aPosition >= 0) && (aPosition < m_abCount - 1) //
+        && (bPosition >= 0) && (bPosition < m_abCount - 1);
+    if (!isCovered) {
+        return Occupancy::Boundary;
+    }
+    const qsizetype index = sampleIndex(static_cast<int>(lPosition), //
+                                        static_cast<int>(aPosition), //
+                                        static_cast<int>(bPosition));
+    if (!bit(m_uniformCells, index)) {
+        return Occupancy::Boundary;
+    }
+    return bit(m_samples, index) ? Occupancy::Inside : Occupancy::Outside;
+}
+
+/** @brief Memory usage.
+ *
+ * @returns The memory used by the bit-packed data, measured in bytes. */
+qsizetype GamutOccupancyGrid::sizeInBytes() const
+{
+    return static_cast<qsizetype>( //
+        (m_samples.size() + m_uniformCells.size()) * sizeof(quint64));
+}
+
+} // namespace PerceptualColor
@@ -0,0 +1,143 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef GAMUTOCCUPANCYGRID_H
+#define GAMUTOCCUPANCYGRID_H
+
+#include <atomic>
+#include <functional>
+#include <lcms2.h>
+#include <qglobal.h>
+#include <vector>
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Bit-packed 3D grid of the gamut membership in CIELab.
+ *
+ * The exact gamut test of @ref RgbColorSpace needs two LittleCMS
+ * transforms for each color. This grid allows to answer most gamut
+ * queries without any transform.
+ *
+ * The grid samples the exact gamut test at regular points in the CIELab
+ * space, with a distance of @ref cellSize() between neighboring points.
+ * The samples divide the space into cubic cells. A cell is considered
+ * <em>uniform</em> if all samples at its corners <em>and</em> at the
+ * corners of all its neighbor cells have the same result. Colors within
+ * uniform cells are reported as @ref Occupancy::Inside or
+ * @ref Occupancy::Outside. All other cells are near to the gamut boundary:
+ * For colors within these cells, @ref Occupancy::Boundary is reported,
+ * and the exact gamut test has to be done.
+ *
+ * Requiring the neighbors to be uniform as well adds a safety margin: Small
+ * gamut features that fall between the samples would otherwise be missed.
+ * Still, this is a heuristic: Features that are smaller than a cell can
+ * be missed nevertheless, so the answers are approximate.
+ *
+ * Both the samples and the uniformity of the cells are stored with only
+ * one bit each.
+ *
+ * Objects are immutable and can be used from several threads at the
+ * same time.
+ *
+ * @sa @ref RgbColorSpace::isCielabD50InGamutApproximate() */
+class GamutOccupancyGrid final
+{
+public:
+    /** @brief The exact gamut test.
+     *
+     * Gets an array of colors and an array for the results, and the
+     * number of colors. Writes to the result array <tt>true</tt> for
+     * in-gamut colors and <tt>false</tt> for out-of-gamut colors. */
+    using ExactTest = std::function<void(const cmsCIELab *lab, bool *result, qsizetype count)>;
+
+    /** @brief Gamut membership of a color. */
+    enum class Occupancy {
+        Inside, /**< The color is in-gamut. */
+        Outside, /**< The color is out-of-gamut. */
+        Boundary /**< The color is near to the gamut boundary. The
+            exact gamut test is necessary. */
+    };
+
+    GamutOccupancyGrid(const ExactTest &exactTest, const double maximumChroma, const double cellSize, const std::atomic<bool> *abortFlag = nullptr);
+    /** @brief Default destructor */
+    ~GamutOccupancyGrid() noexcept = default;
+
+    /** @brief The distance between neighboring samples.
+     *
+     * @returns The distance between neighboring samples, measured in
+     * CIELab units. */
+    [[nodiscard]] double cellSize() const
+    {
+        return m_cellSize;
+    }
+    /** @brief Whether the grid has been built completely.
+     *
+     * @returns <tt>true</tt> if the grid has been built completely.
+     * <tt>false</tt> if the build has been aborted. In this case,
+     * @ref occupancy() returns always @ref Occupancy::Boundary. */
+    [[nodiscard]] bool isValid() const
+    {
+        return m_isValid;
+    }
+    [[nodiscard]] Occupancy occupancy(const cmsCIELab &lab) const;
+    [[nodiscard]] qsizetype sizeInBytes() const;
+
+private:
+    Q_DISABLE_COPY(GamutOccupancyGrid)
+
+    /** @internal @brief Only for unit tests. */
+    friend class TestGamutOccupancyGrid;
+
+    /** @brief Reads a bit.
+     *
+     * @param bits The bit-packed data
+     * @param index The index of the bit
+     *
+     * @returns The value of the bit */
+    [[nodiscard]] static bool bit(const std::vector<quint64> &bits, const qsizetype index)
+    {
+        return (bits[static_cast<std::size_t>(index >> 6)] >> (index & 63)) & 1;
+    }
+    /** @brief Index of a sample.
+     *
+     * @param l The index along the lightness axis.
+     * @param a The index along the a axis.
+     * @param b The index along the b axis.
+     *
+     * @returns The index of the sample within @ref m_samples. */
+    [[nodiscard]] qsizetype sampleIndex(const int l, const int a, const int b) const
+    {
+        return (static_cast<qsizetype>(l) * m_abCount + a) * m_abCount + b;
+    }
+    static void setBit(std::vector<quint64> &bits, const qsizetype index);
+
+    /** @brief The coordinate of the first sample on the a axis and on
+     * the b axis. */
+    double m_abOrigin = 0;
+    /** @brief Number of samples along the a axis and along the b axis. */
+    int m_abCount = 0;
+    /** @brief Internal storage for @ref cellSize(). */
+    double m_cellSize = 1;
+    /** @brief Internal storage for @ref isValid(). */
+    bool m_isValid = false;
+    /** @brief Number of samples along the lightness axis. */
+    int m_lightnessCount = 0;
+    /** @brief The exact gamut test results for the samples.
+     *
+     * Bit-packed. One bit per sample. Indices are calculated by
+     * @ref sampleIndex(). */
+    std::vector<quint64> m_samples;
+    /** @brief Whether the cells are uniform.
+     *
+     * Bit-packed. One bit per cell. The cell is identified by the
+     * sample at its lower corner, so the index is calculated by
+     * @ref sampleIndex(). */
+    std::vector<quint64> m_uniformCells;
+};
+
+} // namespace PerceptualColor
+
+#endif // GAMUTOCCUPANCYGRID_H
@@ -7,20 +7,49 @@
 
 #include "asyncimagerendercallback.h"
 #include "helper.h"
-#include "helperqttypes.h"
 #include "lchadouble.h"
 #include "lchdouble.h"
 #include "rgbcolorspace.h"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <qbrush.h>
-#include <qcolor.h>
+#include <qglobal.h>
 #include <qimage.h>
+#include <qlist.h>
+#include <qmutex.h>
 #include <qnamespace.h>
 #include <qpainter.h>
+#include <qrgb.h>
 #include <qsharedpointer.h>
 
 namespace PerceptualColor
 {
+namespace
+{
+
+/** @internal
+ *
+ * @brief An entry of the cache of
+ * @ref GradientImageParameters::colorLineImage().
+ *
+ * The entry does not keep the color space alive: The color space is
+ * referenced only by a raw pointer, which is used for the comparison,
+ * and a weak pointer, which tells if the color space still exists. */
+struct ColorLineCacheEntry {
+    /** @brief The parameters, without color space. */
+    GradientImageParameters parameters;
+    /** @brief The color space. */
+    const RgbColorSpace *colorSpace = nullptr;
+    /** @brief The color space. Expires when the color space is
+     * destroyed. */
+    QWeakPointer<RgbColorSpace> weakColorSpace;
+    /** @brief The color line. */
+    QImage image;
+};
+
+} // namespace
+
 /** @brief Constructor */
 GradientImageParameters::GradientImageParameters()
 {
@@ -111,10 +140,8 @@ void GradientImageParameters::updateSecondColor()
  *        image parameters.
  * @param callbackObject Pointer to the object for the callbacks.
  *
- * @todo Could we get better performance? Even online tools like
- * https://bottosson.github.io/misc/colorpicker/#ff2a00 or
- * https://oklch.evilmartians.io/#65.4,0.136,146.7,100 get quite good
- * performance. How do they do that? */
+ * The colors are calculated by the fastest @ref Kernel that fits the
+ * gradient. */
 void GradientImageParameters::render(const QVariant &variantParameters, AsyncImageRenderCallback &callbackObject)
 {
     if (!variantParameters.canConvert<GradientImageParameters>()) {
@@ -137,28 +164,10 @@ void GradientImageParameters::render(const QVariant &variantParameters, AsyncIma
         return;
     }
 
-    // First, create an image of the gradient with only one pixel thickness.
+    // First, get an image of the gradient with only one pixel thickness.
     // (Color management operations are expensive in CPU time; we try to
     // minimize this.)
-    QImage onePixelLine(parameters.m_gradientLength, //
-                        1, //
-                        QImage::Format_ARGB32_Premultiplied);
-    onePixelLine.fill(Qt::transparent); // Initialize image with transparency.
-    LchaDouble color;
-    LchDouble cielchD50;
-    QColor temp;
-    for (int i = 0; i < parameters.m_gradientLength; ++i) {
-        color = parameters.colorFromValue( //
-            (i + 0.5) / static_cast<qreal>(parameters.m_gradientLength));
-        cielchD50.l = color.l;
-        cielchD50.c = color.c;
-        cielchD50.h = color.h;
-        temp = parameters.rgbColorSpace->fromCielchD50ToQRgbBound(cielchD50);
-        temp.setAlphaF(
-            // Reduce floating point precision if necessary.
-            static_cast<QColorFloatType>(color.a));
-        onePixelLine.setPixelColor(i, 0, temp);
-    }
+    const QImage onePixelLine = colorLineImage(parameters);
     if (callbackObject.shouldAbort()) {
         return;
     }
@@ -191,9 +200,14 @@ void GradientImageParameters::render(const QVariant &variantParameters, AsyncIma
                          QBrush(background));
     }
 
-    // Paint the gradient itself.
-    for (int i = 0; i < parameters.m_gradientThickness; ++i) {
-        painter.drawImage(0, i, onePixelLine);
+    // Paint the gradient itself. The one-pixel line is used as texture
+    // brush, which repeats it for all rows within a single call.
+    if (!onePixelLine.isNull()) {
+        painter.fillRect(0, //
+                         0, //
+                         parameters.m_gradientLength, //
+                         parameters.m_gradientThickness, //
+                         QBrush(onePixelLine));
     }
 
     result.setDevicePixelRatio(parameters.m_devicePixelRatioF);
@@ -208,6 +222,274 @@ void GradientImageParameters::render(const QVariant &variantParameters, AsyncIma
         AsyncImageRenderCallback::InterlacingState::Final);
 }
 
+/** @brief Image of the gradient with a thickness of one pixel.
+ *
+ * @param parameters The parameters of the gradient.
+ *
+ * @returns Image of the gradient with a thickness of one pixel and alpha
+ * applied. Depends only on the colors, the gradient length and the color
+ * space, but not on the gradient thickness or the device pixel ratio. If
+ * an image for the same colors, gradient length and color space is in the
+ * cache, it is returned immediately. Otherwise, a new image is calculated
+ * and added to the cache, which keeps the images of the
+ * @ref colorLineCacheCapacity most recently used gradients.
+ *
+ * This function is thread-safe. */
+QImage GradientImageParameters::colorLineImage(const GradientImageParameters &parameters)
+{
+    // The gradient thickness and the device pixel ratio do not influence
+    // the color line, so they are ignored as cache key. The color space
+    // is not part of the key, so that the cache does not keep it alive.
+    GradientImageParameters key = parameters;
+    key.m_devicePixelRatioF = 1;
+    key.m_gradientThickness = 0;
+    key.m_image = QImage();
+    key.rgbColorSpace.reset();
+    const RgbColorSpace *const colorSpace = parameters.rgbColorSpace.data();
+
+    static QMutex mutex;
+    // Most recently used line first
+    static QList<ColorLineCacheEntry> cache;
+    // Removes the entries of color spaces that have been destroyed and
+    // returns the index of the entry for the key, or -1.
+    const auto findEntry = [&]() -> int {
+        for (int i = static_cast<int>(cache.count()) - 1; i >= 0; --i) {
+            if (cache.at(i).weakColorSpace.isNull()) {
+                cache.removeAt(i);
+            }
+        }
+        for (int i = 0; i < cache.count(); ++i) {
+            if ((cache.at(i).colorSpace == colorSpace) //
+                && (cache.at(i).parameters == key)) {
+                return i;
+            }
+        }
+        return -1;
+    };
+    {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        QMutexLocker<QMutex> locker(&mutex);
+#else
+        QMutexLocker locker(&mutex);
+#endif
+        const int index = findEntry();
+        if (index >= 0) {
+            cache.move(index, 0);
+            return cache.at(0).image;
+        }
+    }
+
+    // The calculation is done without locking the mutex, so that other
+    // threads are not blocked meanwhile.
+    const std::vector<QRgb> colors = parameters.colorLine(parameters.kernel());
+    QImage result(parameters.m_gradientLength, //
+                  1, //
+                  QImage::Format_ARGB32_Premultiplied);
+    if (!result.isNull()) {
+        auto *const scanLine = reinterpret_cast<QRgb *>(result.scanLine(0));
+        constexpr int alphaMaximum = 255;
+        for (int i = 0; i < parameters.m_gradientLength; ++i) {
+            const qreal position = //
+                (i + 0.5) / static_cast<qreal>(parameters.m_gradientLength);
+            const qreal alpha = parameters.colorFromValue(position).a;
+            const QRgb color = colors[static_cast<std::size_t>(i)];
+            scanLine[i] = qPremultiply(qRgba(qRed(color), //
+                                             qGreen(color),
+                                             qBlue(color),
+                                             qRound(alpha * alphaMaximum)));
+        }
+    }
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QMutexLocker<QMutex> locker(&mutex);
+#else
+    QMutexLocker locker(&mutex);
+#endif
+    if (!parameters.rgbColorSpace.isNull() && (findEntry() < 0)) {
+        cache.prepend(ColorLineCacheEntry{key, //
+                                          colorSpace,
+                                          parameters.rgbColorSpace.toWeakRef(),
+                                          result});
+        while (cache.count() > colorLineCacheCapacity) {
+            cache.removeLast();
+        }
+    }
+    return result;
+}
+
+/** @brief The kernel that fits best to the colors of the gradient.
+ *
+ * @returns The fastest kernel that can render the current colors. */
+GradientImageParameters::Kernel GradientImageParameters::kernel() const
+{
+    const int changingChannels = //
+        ((m_firstColorCorrected.l != m_secondColorCorrectedAndAltered.l) ? 1 : 0) //
+        + ((m_firstColorCorrected.c != m_secondColorCorrectedAndAltered.c) ? 1 : 0) //
+        + ((m_firstColorCorrected.h != m_secondColorCorrectedAndAltered.h) ? 1 : 0);
+    switch (changingChannels) {
+    case 0:
+        return Kernel::Constant;
+    case 1:
+        return Kernel::SingleChannel;
+    default:
+        return Kernel::General;
+    }
+}
+
+/** @brief The opaque colors of the gradient.
+ *
+ * @param kernel The kernel to use. @ref Kernel::General works for all
+ *        gradients; the other kernels only work for the gradients that
+ *        are described in @ref Kernel.
+ *
+ * @returns One opaque color for each pixel of the gradient length. Alpha
+ * is not taken into account.
+ *
+ * @ref Kernel::SingleChannel converts only knots in regular distances
+ * and interpolates linearly in RGB between them. Within each segment
+ * between two knots, the interpolation is verified at some sample
+ * positions. If the interpolation error at any of these sample positions
+ * is bigger than one unit in any RGB channel (which typically happens
+ * where the gradient leaves the gamut), the whole segment is converted
+ * exactly.
+ *
+ * This tolerance is a heuristic, not a guaranteed bound: The color
+ * transform is not linear, and there is no practical bound for its
+ * curvature (profiles might even have lookup tables). The pixels between
+ * the samples might therefore have a bigger error. Because the segments
+ * are short and a single channel changes smoothly, this error is small
+ * in practice; the unit tests accept up to three units per channel. Where
+ * an exact result matters, use @ref Kernel::General. */
+std::vector<QRgb> GradientImageParameters::colorLine(const Kernel kernel) const
+{
+    const auto length = static_cast<std::size_t>(m_gradientLength);
+    std::vector<QRgb> result(length);
+    if ((length == 0) || rgbColorSpace.isNull()) {
+        return result;
+    }
+    const auto cielchD50At = [this](const std::size_t index) {
+        const LchaDouble color = colorFromValue( //
+            (static_cast<qreal>(index) + 0.5) / static_cast<qreal>(m_gradientLength));
+        return LchDouble{color.l, color.c, color.h};
+    };
+
+    if (kernel == Kernel::Constant) {
+        std::fill(result.begin(), //
+                  result.end(),
+                  rgbColorSpace->fromCielchD50ToQRgbBound(cielchD50At(0)));
+        return result;
+    }
+
+    // Distance between two knots, measured in pixels
+    constexpr std::size_t knotDistance = 32;
+    // Number of positions within each segment where the interpolation is
+    // verified
+    constexpr std::size_t samplesPerSegment = 3;
+    // Maximum accepted interpolation error per channel
+    constexpr int tolerance = 1;
+    if ((kernel == Kernel::General) || (length <= 2 * knotDistance)) {
+        std::vector<LchDouble> cielchD50(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            cielchD50[i] = cielchD50At(i);
+        }
+        rgbColorSpace->fromCielchD50ToQRgbBound(cielchD50.data(), //
+                                                result.data(),
+                                                static_cast<qsizetype>(length));
+        return result;
+    }
+
+    // Knots are at 0, knotDistance, 2 * knotDistance… and at the last pixel.
+    // The knots and the sample positions are converted in a single batch.
+    std::vector<std::size_t> knots;
+    for (std::size_t i = 0; i < length - 1; i += knotDistance) {
+        knots.push_back(i);
+    }
+    knots.push_back(length - 1);
+    const std::size_t segmentCount = knots.size() - 1;
+    const auto samplePosition = [&knots](const std::size_t segment, const std::size_t sample) {
+        const std::size_t begin = knots[segment];
+        const std::size_t end = knots[segment + 1];
+        return begin + (end - begin) * (sample + 1) / (samplesPerSegment + 1);
+    };
+    std::vector<LchDouble> cielchD50;
+    cielchD50.reserve(knots.size() + segmentCount * samplesPerSegment);
+    for (const std::size_t knot : knots) {
+        cielchD50.push_back(cielchD50At(knot));
+    }
+    for (std::size_t segment = 0; segment < segmentCount; ++segment) {
+        for (std::size_t sample = 0; sample < samplesPerSegment; ++sample) {
+            cielchD50.push_back(cielchD50At(samplePosition(segment, sample)));
+        }
+    }
+    std::vector<QRgb> converted(cielchD50.size());
+    rgbColorSpace->fromCielchD50ToQRgbBound(cielchD50.data(), //
+                                            converted.data(),
+                                            static_cast<qsizetype>(converted.size()));
+
+    const auto interpolate = [&](const std::size_t segment, const std::size_t index) {
+        const std::size_t begin = knots[segment];
+        const std::size_t end = knots[segment + 1];
+        const QRgb first = converted[segment];
+        const QRgb last = converted[segment + 1];
+        const qreal ratio = static_cast<qreal>(index - begin) / static_cast<qreal>(end - begin);
+        const auto channel = [ratio](const int firstValue, const int lastValue) {
+            return qRound(firstValue + (lastValue - firstValue) * ratio);
+        };
+        return qRgb(channel(qRed(first), qRed(last)), //
+                    channel(qGreen(first), qGreen(last)),
+                    channel(qBlue(first), qBlue(last)));
+    };
+    const auto isClose = [](const QRgb a, const QRgb b) {
+        return (qAbs(qRed(a) - qRed(b)) <= tolerance) //
+            && (qAbs(qGreen(a) - qGreen(b)) <= tolerance) //
+            && (qAbs(qBlue(a) - qBlue(b)) <= tolerance);
+    };
+
+    // Segments where the interpolation is not good enough are collected
+    // and converted exactly in a second batch.
+    std::vector<std::size_t> exactSegments;
+    for (std::size_t segment = 0; segment < segmentCount; ++segment) {
+        bool interpolationIsGood = true;
+        for (std::size_t sample = 0; sample < samplesPerSegment; ++sample) {
+            const QRgb exact = //
+                converted[knots.size() + segment * samplesPerSegment + sample];
+            if (!isClose(exact, interpolate(segment, samplePosition(segment, sample)))) {
+                interpolationIsGood = false;
+                break;
+            }
+        }
+        if (interpolationIsGood) {
+            for (std::size_t i = knots[segment]; i < knots[segment + 1]; ++i) {
+                result[i] = interpolate(segment, i);
+            }
+        } else {
+            exactSegments.push_back(segment);
+        }
+    }
+    result[length - 1] = converted[segmentCount];
+    if (!exactSegments.empty()) {
+        std::vector<LchDouble> exactCielchD50;
+        for (const std::size_t segment : exactSegments) {
+            for (std::size_t i = knots[segment]; i < knots[segment + 1]; ++i) {
+                exactCielchD50.push_back(cielchD50At(i));
+            }
+        }
+        std::vector<QRgb> exactColors(exactCielchD50.size());
+        rgbColorSpace->fromCielchD50ToQRgbBound( //
+            exactCielchD50.data(),
+            exactColors.data(),
+            static_cast<qsizetype>(exactColors.size()));
+        std::size_t exactIndex = 0;
+        for (const std::size_t segment : exactSegments) {
+            for (std::size_t i = knots[segment]; i < knots[segment + 1]; ++i) {
+                result[i] = exactColors[exactIndex];
+                ++exactIndex;
+            }
+        }
+    }
+    return result;
+}
+
 /** @brief The color that the gradient has at a given position of the gradient.
  * @param value The position. Valid range: <tt>[0.0, 1.0]</tt>. <tt>0.0</tt>
  * means the first color, <tt>1.0</tt> means the second color, and everything
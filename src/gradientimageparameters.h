@@ -8,8 +8,10 @@
 #include <qglobal.h>
 #include <qimage.h>
 #include <qmetatype.h>
+#include <qrgb.h>
 #include <qsharedpointer.h>
 #include <qvariant.h>
+#include <vector>
 
 namespace PerceptualColor
 {
@@ -58,11 +60,35 @@ private:
     /** @internal @brief Only for unit tests. */
     friend class TestGradientImageParameters;
 
+    /** @brief Specialized algorithms to calculate the colors of the
+     * gradient.
+     *
+     * @sa @ref kernel()
+     * @sa @ref colorLine() */
+    enum class Kernel {
+        Constant, /**< Lightness, chroma and hue are identical for the
+            whole gradient; only alpha might change. A single color
+            conversion is done. */
+        SingleChannel, /**< Only one of lightness, chroma and hue changes.
+            Only some knots are converted; the colors in between are
+            interpolated. This is a heuristic: The interpolation error is
+            checked only at some samples of each segment, so there is no
+            guaranteed bound for the error of the other pixels. See
+            @ref colorLine() for details. */
+        General /**< Each pixel is converted individually. */
+    };
+
     // Methods
+    [[nodiscard]] std::vector<QRgb> colorLine(const Kernel kernel) const;
+    [[nodiscard]] static QImage colorLineImage(const GradientImageParameters &parameters);
     [[nodiscard]] static LchaDouble completlyNormalizedAndBounded(const LchaDouble &color);
+    [[nodiscard]] Kernel kernel() const;
     void updateSecondColor();
 
     // Data members
+    /** @brief Maximum number of images that @ref colorLineImage() keeps
+     * in its cache. */
+    static constexpr int colorLineCacheCapacity = 8;
     /** @brief Internal storage of the device pixel ratio as floating point.
      *
      * @sa @ref setDevicePixelRatioF() */
@@ -21,6 +21,7 @@
 #include <qpen.h>
 #include <qpoint.h>
 #include <qsharedpointer.h>
+#include <qsize.h>
 #include <qsizepolicy.h>
 #include <qtransform.h>
 #include <qwidget.h>
@@ -164,15 +165,9 @@ void GradientSlider::setColors(const PerceptualColor::LchaDouble &newFirstColor,
  * @param event The corresponding resize event */
 void GradientSlider::resizeEvent(QResizeEvent *event)
 {
-    Q_UNUSED(event)
-    d_pointer->m_gradientImageParameters.setGradientLength( //
-        d_pointer->physicalPixelLength());
-    d_pointer->m_gradientImageParameters.setGradientThickness(
-        // Normally, this should not change, but maybe on Hight-DPI
-        // devices there might be some differences.
-        d_pointer->physicalPixelThickness());
-    d_pointer->m_gradientImage.setImageParameters( //
-        d_pointer->m_gradientImageParameters);
+    AbstractDiagram::resizeEvent(event);
+    // The image size is not updated here, but in paintEvent(), which
+    // delays the rendering for the new size while isResizing().
     update();
 }
 
@@ -554,14 +549,19 @@ void GradientSlider::paintEvent(QPaintEvent *event)
     // first and the second color because we have complete control
     // about these values and are sure the any changes have yet been
     // applied.
+    // While the widget is resized, we keep the image size of the
+    // image that we have yet: Rendering all the intermediate sizes would be
+    // wasted effort. Once the size is stable, we get a new paint event.
     d_pointer->m_gradientImageParameters.setDevicePixelRatioF( //
         devicePixelRatioF());
-    d_pointer->m_gradientImageParameters.setGradientLength( //
-        d_pointer->physicalPixelLength());
-    d_pointer->m_gradientImageParameters.setGradientThickness(
-        // Normally, this should not change, but maybe on Hight-DPI
-        // devices there are some differences.
-        d_pointer->physicalPixelThickness());
+    if (!isResizing() || d_pointer->m_gradientImage.getCache().isNull()) {
+        d_pointer->m_gradientImageParameters.setGradientLength( //
+            d_pointer->physicalPixelLength());
+        d_pointer->m_gradientImageParameters.setGradientThickness(
+            // Normally, this should not change, but maybe on Hight-DPI
+            // devices there are some differences.
+            d_pointer->physicalPixelThickness());
+    }
     d_pointer->m_gradientImage.setImageParameters( //
         d_pointer->m_gradientImageParameters);
     d_pointer->m_gradientImage.refreshAsync();
@@ -569,6 +569,15 @@ void GradientSlider::paintEvent(QPaintEvent *event)
     if (paintBuffer.isNull()) {
         return;
     }
+    const QSize physicalSize(d_pointer->physicalPixelLength(), //
+                             d_pointer->physicalPixelThickness());
+    if (paintBuffer.size() != physicalSize) {
+        // Placeholder until the image for the current size is available
+        paintBuffer = paintBuffer.scaled( //
+            physicalSize,
+            Qt::AspectRatioMode::IgnoreAspectRatio,
+            Qt::TransformationMode::FastTransformation);
+    }
 
     // Draw slider handle
     QPainter bufferPainter(&paintBuffer);
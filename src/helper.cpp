@@ -4,13 +4,18 @@
 // Own header
 #include "helper.h"
 
+#include <atomic>
+#include <memory>
 #include <qcolor.h>
 #include <qevent.h>
 #include <qpainter.h>
 #include <qpoint.h>
+#include <qrunnable.h>
+#include <qsemaphore.h>
 #include <qstringliteral.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
+#include <qthreadpool.h>
 #include <qwidget.h>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -21,6 +26,115 @@
 
 namespace PerceptualColor
 {
+namespace
+{
+
+/** @internal
+ *
+ * @brief Shared state of @ref runInParallel().
+ *
+ * The tasks are distributed dynamically: Each thread takes the next
+ * task that has not yet been taken by another thread. */
+struct ParallelTasks {
+    /** @brief Index of the next task that has not yet been taken. */
+    std::atomic<int> nextTask{0};
+    /** @brief Number of tasks. */
+    int taskCount = 0;
+    /** @brief The function that executes a task. */
+    const std::function<void(int)> *task = nullptr;
+    /** @brief Released once by each worker thread when it has finished. */
+    QSemaphore finishedWorkers;
+    /** @brief Executes tasks until no task is left. */
+    void work()
+    {
+        int index = nextTask.fetch_add(1);
+        while (index < taskCount) {
+            (*task)(index);
+            index = nextTask.fetch_add(1);
+        }
+    }
+};
+
+/** @internal
+ *
+ * @brief Worker for @ref runInParallel() on a <tt>QThreadPool</tt>. */
+class ParallelTaskWorker final : public QRunnable
+{
+public:
+    /** @brief Constructor
+     *
+     * @param state The shared state. */
+    explicit ParallelTaskWorker(const std::shared_ptr<ParallelTasks> &state)
+        : m_state(state)
+    {
+    }
+    /** @brief Executes tasks until no task is left. */
+    void run() override
+    {
+        m_state->work();
+        // After the release, the caller of runInParallel() might have
+        // returned already, so the task function must not be used
+        // anymore. m_state itself stays valid as it is shared.
+        m_state->finishedWorkers.release();
+    }
+
+private:
+    /** @brief The shared state. */
+    std::shared_ptr<ParallelTasks> m_state;
+};
+
+} // namespace
+
+/** @internal
+ *
+ * @brief Executes tasks in parallel and waits until all tasks are done.
+ *
+ * The calling thread executes tasks itself. Additional worker threads are
+ * taken from <tt>QThreadPool::globalInstance()</tt>, but only if they are
+ * available immediately. Therefore, this function never waits for other
+ * work of the thread pool, and can be called safely from within a thread
+ * of the thread pool itself.
+ *
+ * @param taskCount Number of tasks.
+ * @param threadCount Maximum number of threads, including the calling
+ *        thread. <tt>0</tt> or negative values mean
+ *        <tt>QThread::idealThreadCount()</tt>.
+ * @param task Function that executes the task with the given index. It
+ *        is called exactly once for each index in the range
+ *        <tt>[0, taskCount[</tt>, in arbitrary order and from arbitrary
+ *        threads, so it must be thread-safe. To allow cancellation, it can
+ *        simply return immediately.
+ *
+ * @post All tasks have been executed. */
+void runInParallel(int taskCount, int threadCount, const std::function<void(int)> &task)
+{
+    if (taskCount <= 0) {
+        return;
+    }
+    if (threadCount <= 0) {
+        threadCount = QThread::idealThreadCount();
+    }
+    threadCount = qBound(1, threadCount, taskCount);
+    const auto state = std::make_shared<ParallelTasks>();
+    state->taskCount = taskCount;
+    state->task = &task;
+    int startedWorkers = 0;
+    for (int i = 1; i < threadCount; ++i) {
+        auto worker = std::make_unique<ParallelTaskWorker>(state);
+        if (!QThreadPool::globalInstance()->tryStart(worker.get())) {
+            // No thread is available at the moment. The tasks
+            // will be done by the threads that have already started.
+            break;
+        }
+        // The thread pool has taken ownership because autoDelete()
+        // is true.
+        worker.release();
+        ++startedWorkers;
+    }
+    state->work();
+    state->finishedWorkers.acquire(startedWorkers);
+}
+
 /** @internal
  *
  * @brief Number of vertical <em>standard</em> wheel steps done by a
@@ -4,6 +4,7 @@
 #ifndef HELPER_H
 #define HELPER_H
 
+#include <functional>
 #include <qcoreapplication.h>
 #include <qglobal.h>
 #include <qimage.h>
@@ -39,6 +40,8 @@ bool isIn(First &&first, T &&...t)
     return ((first == t) || ...);
 }
 
+void runInParallel(int taskCount, int threadCount, const std::function<void(int)> &task);
+
 [[nodiscard]] qreal standardWheelStepCount(QWheelEvent *event);
 
 [[nodiscard]] QImage transparencyBackground(qreal devicePixelRatioF);
@@ -47,6 +47,48 @@ constexpr qreal gamutPrecisionOklab = gamutPrecisionCielab / 100;
  * to be sure. */
 constexpr int overlap = 2;
 
+/** @internal
+ *
+ * @brief Memory limit for the history cache of diagrams, measured in bytes.
+ *
+ * Diagrams that show a slice of the gamut (like @ref ChromaHueDiagram) keep
+ * the images of previously shown slices, so that they are available
+ * immediately when the user goes back to them.
+ *
+ * @sa @ref AsyncImageProvider::setHistoryCacheLimitInBytes() */
+// This value is somewhat arbitrary: It allows about 16 slices for a
+// diagram of 1000 × 1000 physical pixels.
+constexpr qsizetype diagramHistoryCacheLimitInBytes = 64 * 1024 * 1024;
+
+/** @internal
+ *
+ * @brief Time the size of a diagram has to be stable before the images are
+ * rendered for the new size, measured in milliseconds.
+ *
+ * @sa @ref AbstractDiagram::resizeRenderDelay() */
+// Long enough to cover the interval between two resize events during an
+// interactive window resize, and short enough to go unnoticed otherwise.
+constexpr int diagramResizeRenderDelay = 150;
+
+/** @internal
+ *
+ * @brief Time without changes after which an interaction is considered
+ * as finished, measured in milliseconds.
+ *
+ * @sa @ref AbstractDiagram::registerInteraction() */
+constexpr int diagramInteractionIdleDelay = 200;
+
+/** @internal
+ *
+ * @brief Scale factor for the resolution of images that are rendered
+ * during an interaction.
+ *
+ * Applies to both width and height, so only a quarter of the pixels is
+ * rendered.
+ *
+ * @sa @ref AbstractDiagram::renderScale() */
+constexpr qreal diagramInteractionRenderScale = 0.5;
+
 /** @internal
  *
  * @brief Proposed scale factor for gradients
@@ -4,71 +4,19 @@
 // Own header
 #include "helperconversion.h"
 
+#include "colorbuffer.h"
+#include "colorkernels.h"
 #include "helpermath.h"
 #include "lchdouble.h"
 #include "rgbdouble.h"
-#include <array>
+#include <algorithm>
 #include <cmath>
-#include <optional>
 #include <qgenericmatrix.h>
 #include <qglobal.h>
 
 namespace PerceptualColor
 {
 
-// Doxygen doesn’t handle correctly the Q_GLOBAL_STATIC_WITH_ARGS macro, so
-// we instruct Doxygen with the @cond command to ignore  this part of the code.
-
-/// @cond
-
-// clang-format off
-
-// https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab
-Q_GLOBAL_STATIC_WITH_ARGS(
-    const SquareMatrix3,
-    m1,
-    (std::array<double, 9>{{
-        +0.8189330101, +0.3618667424, -0.1288597137,
-        +0.0329845436, +0.9293118715, +0.0361456387,
-        +0.0482003018, +0.2643662691, +0.6338517070}}.data()))
-
-// https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab
-Q_GLOBAL_STATIC_WITH_ARGS(
-    const SquareMatrix3,
-    m2,
-    (std::array<double, 9>{{
-        +0.2104542553, +0.7936177850, -0.0040720468,
-        +1.9779984951, -2.4285922050, +0.4505937099,
-        +0.0259040371, +0.7827717662, -0.8086757660}}.data()))
-
-// https://fujiwaratko.sakura.ne.jp/infosci/colorspace/bradford_e.html
-Q_GLOBAL_STATIC_WITH_ARGS(
-    const SquareMatrix3,
-    xyzD65ToXyzD50,
-    (std::array<double, 9>{{
-        +1.047886, +0.022919, -0.050216,
-        +0.029582, +0.990484, -0.017079,
-        -0.009252, +0.015073, +0.751678}}.data()))
-
-// clang-format on
-
-Q_GLOBAL_STATIC_WITH_ARGS( //
-    const SquareMatrix3,
-    m1inverse,
-    (inverseMatrix(*m1).value_or(SquareMatrix3())))
-
-Q_GLOBAL_STATIC_WITH_ARGS( //
-    const SquareMatrix3,
-    m2inverse,
-    (inverseMatrix(*m2).value_or(SquareMatrix3())))
-
-Q_GLOBAL_STATIC_WITH_ARGS( //
-    const SquareMatrix3,
-    xyzD50ToXyzD65,
-    (inverseMatrix(*xyzD65ToXyzD50).value_or(SquareMatrix3())))
-
-/// @endcond
-
 /** @internal
  *
  * @brief Type conversion.
@@ -122,6 +70,145 @@ cmsCIELab toCmsLab(const cmsCIELCh &value)
     return lab;
 }
 
+/** @internal
+ *
+ * @brief Batch conversion from polar to Cartesian coordinates.
+ *
+ * Works on whole arrays in structure-of-arrays layout. The actual work is
+ * done by @ref colorKernels(), which uses the best instruction set of the
+ * CPU and @ref fastSinCosDegree(), so the precision is given by
+ * @ref fastSinCosMaximumError (multiplied by the radius).
+ *
+ * @param radius Array with the radii
+ * @param angleDegree Array with the angles, measured in degree
+ * @param x Array that will receive the x coordinates
+ * @param y Array that will receive the y coordinates
+ * @param count Number of values. Each of the arrays must hold at least
+ *        this number of elements.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromPolarToCartesian(const double *radius, const double *angleDegree, double *x, double *y, const qsizetype count)
+{
+    colorKernels().polarToCartesian(radius, angleDegree, x, y, count);
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from Cartesian to polar coordinates.
+ *
+ * Works on whole arrays in structure-of-arrays layout. The actual work is
+ * done by @ref colorKernels(), which uses the best instruction set of the
+ * CPU and @ref fastAtan2Degree(), so the precision of the angle is given
+ * by @ref fastAtan2MaximumErrorDegree.
+ *
+ * @param x Array with the x coordinates
+ * @param y Array with the y coordinates
+ * @param radius Array that will receive the radii
+ * @param angleDegree Array that will receive the angles, measured in
+ *        degree, within <tt>[0°, 360°]</tt>
+ * @param count Number of values. Each of the arrays must hold at least
+ *        this number of elements.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromCartesianToPolar(const double *x, const double *y, double *radius, double *angleDegree, const qsizetype count)
+{
+    colorKernels().cartesianToPolar(x, y, radius, angleDegree, count);
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from LCh to Lab.
+ *
+ * Gives (within @ref fastSinCosMaximumError multiplied by the chroma)
+ * the same results as @ref toCmsLab(const cmsCIELCh &), but works on
+ * whole arrays in structure-of-arrays layout. This works for both,
+ * CIELCh and Oklch.
+ *
+ * @param lchL Array with the lightness values
+ * @param lchC Array with the chroma values
+ * @param lchH Array with the hue values, measured in degree
+ * @param labL Array that will receive the lightness values
+ * @param labA Array that will receive the a values
+ * @param labB Array that will receive the b values
+ * @param count Number of colors. Each of the arrays must hold at least
+ *        this number of elements.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromLchToLab(const double *lchL, const double *lchC, const double *lchH, double *labL, double *labA, double *labB, const qsizetype count)
+{
+    if (labL != lchL) {
+        std::copy_n(lchL, count, labL);
+    }
+    fromPolarToCartesian(lchC, lchH, labA, labB, count);
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from LCh to Lab.
+ *
+ * Buffer version of
+ * @ref fromLchToLab(const double *, const double *, const double *, double *, double *, double *, const qsizetype)
+ *
+ * @param lch The original colors
+ * @param lab Buffer that will receive the converted colors. It is resized
+ *        to the size of <tt>lch</tt>. */
+void fromLchToLab(const LchBuffer &lch, LabBuffer &lab)
+{
+    lab.resize(lch.size());
+    fromLchToLab(lch.l(), lch.c(), lch.h(), lab.l(), lab.a(), lab.b(), lch.size());
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from Lab to LCh.
+ *
+ * Gives (within @ref fastAtan2MaximumErrorDegree) the same results as
+ * <tt>cmsLab2LCh()</tt>, but works on whole arrays in structure-of-arrays
+ * layout. This works for both, CIELab and Oklab.
+ *
+ * @param labL Array with the lightness values
+ * @param labA Array with the a values
+ * @param labB Array with the b values
+ * @param lchL Array that will receive the lightness values
+ * @param lchC Array that will receive the chroma values
+ * @param lchH Array that will receive the hue values, measured in degree,
+ *        within <tt>[0°, 360°]</tt>
+ * @param count Number of colors. Each of the arrays must hold at least
+ *        this number of elements.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromLabToLch(const double *labL, const double *labA, const double *labB, double *lchL, double *lchC, double *lchH, const qsizetype count)
+{
+    if (lchL != labL) {
+        std::copy_n(labL, count, lchL);
+    }
+    fromCartesianToPolar(labA, labB, lchC, lchH, count);
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from Lab to LCh.
+ *
+ * Buffer version of
+ * @ref fromLabToLch(const double *, const double *, const double *, double *, double *, double *, const qsizetype)
+ *
+ * @param lab The original colors
+ * @param lch Buffer that will receive the converted colors. It is resized
+ *        to the size of <tt>lab</tt>. */
+void fromLabToLch(const LabBuffer &lab, LchBuffer &lch)
+{
+    lch.resize(lab.size());
+    fromLabToLch(lab.l(), lab.a(), lab.b(), lch.l(), lch.c(), lch.h(), lab.size());
+}
+
 /** @internal
  *
  * @brief Conversion from
@@ -131,6 +218,7 @@ cmsCIELab toCmsLab(const cmsCIELCh &value)
  * Oklab color space</a>.
  *
  * @param value The value to be converted
+ * @param precision Precision of the cube root calculation
  *
  * @pre The XYZ value has
  * <a href="https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab">
@@ -149,14 +237,14 @@ cmsCIELab toCmsLab(const cmsCIELCh &value)
  * @returns the same color in
  * <a href="https://bottosson.github.io/posts/oklab/">
  * Oklab color space</a>. */
-Trio fromXyzd65ToOklab(const Trio &value)
+Vector3 fromXyzd65ToOklab(const Vector3 &value, const ConversionPrecision precision)
 {
     // The following algorithm is as described in
     // https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab
     //
     // Oklab: “First the XYZ coordinates are converted to an approximate
     // cone responses:”
-    auto lms = (*m1) * value; // NOTE Might contain negative entries
+    auto lms = multiplyMatrix3(oklabM1, value); // NOTE Might contain negative entries
     // LMS (long, medium, short) is the response of the three types of
     // cones of the human eye.
 
@@ -177,12 +265,90 @@ Trio fromXyzd65ToOklab(const Trio &value)
     // because it gives unique results for each x value. Therefore, here
     // we do the same, but using std::cbrt() instead of std::cbrtf() to
     // allow double precision instead of float precision.
-    lms(/*row*/ 0, /*column*/ 0) = std::cbrt(lms(/*row*/ 0, /*column*/ 0));
-    lms(/*row*/ 1, /*column*/ 0) = std::cbrt(lms(/*row*/ 1, /*column*/ 0));
-    lms(/*row*/ 2, /*column*/ 0) = std::cbrt(lms(/*row*/ 2, /*column*/ 0));
+    if (precision == ConversionPrecision::Fast) {
+        lms[0] = fastCubeRoot(lms[0]);
+        lms[1] = fastCubeRoot(lms[1]);
+        lms[2] = fastCubeRoot(lms[2]);
+    } else {
+        lms[0] = std::cbrt(lms[0]);
+        lms[1] = std::cbrt(lms[1]);
+        lms[2] = std::cbrt(lms[2]);
+    }
 
     // Oklab: “Finally, this is transformed into the Lab-coordinates:”
-    return (*m2) * lms;
+    return multiplyMatrix3(oklabM2, lms);
+}
+
+/** @internal
+ *
+ * @brief Conversion from
+ * <a href="https://en.wikipedia.org/wiki/CIE_1931_color_space#Definition_of_the_CIE_XYZ_color_space">
+ * CIE 1931 XYZ color space</a> to
+ * <a href="https://bottosson.github.io/posts/oklab/">
+ * Oklab color space</a>.
+ *
+ * Convenience overload for @ref Trio.
+ *
+ * @param value The value to be converted
+ *
+ * @returns the same color in
+ * <a href="https://bottosson.github.io/posts/oklab/">
+ * Oklab color space</a>.
+ *
+ * @sa @ref fromXyzd65ToOklab(const Vector3 &value) */
+Trio fromXyzd65ToOklab(const Trio &value)
+{
+    const auto oklab = fromXyzd65ToOklab( //
+        Vector3{value(0, 0), value(1, 0), value(2, 0)});
+    return Trio(oklab.data());
+}
+
+/** @internal
+ *
+ * @brief Batch conversion from
+ * <a href="https://en.wikipedia.org/wiki/CIE_1931_color_space#Definition_of_the_CIE_XYZ_color_space">
+ * CIE 1931 XYZ color space</a> to
+ * <a href="https://bottosson.github.io/posts/oklab/">
+ * Oklab color space</a>.
+ *
+ * Gives the same results as @ref fromXyzd65ToOklab(const Vector3 &value),
+ * but works on whole arrays in structure-of-arrays layout: Each channel
+ * lives in its own contiguous array. This layout allows the compiler to
+ * vectorize the matrix products, and it amortizes the function call
+ * overhead across all values. The actual work is done by
+ * @ref colorKernels(), which uses the best instruction set of the CPU.
+ *
+ * @param x Array with the X values of the input colors
+ * @param y Array with the Y values of the input colors
+ * @param z Array with the Z values of the input colors
+ * @param oklabL Array that will receive the L values of the output colors
+ * @param oklabA Array that will receive the a values of the output colors
+ * @param oklabB Array that will receive the b values of the output colors
+ * @param count Number of colors. Each of the arrays must hold at least
+ *        this number of elements.
+ * @param precision Precision of the cube root calculation
+ *
+ * @pre The XYZ values have
+ * <a href="https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab">
+ * “a D65 whitepoint and white as Y=1”</a>.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromXyzd65ToOklab(const double *x,
+                       const double *y,
+                       const double *z,
+                       double *oklabL,
+                       double *oklabA,
+                       double *oklabB,
+                       const qsizetype count,
+                       const ConversionPrecision precision)
+{
+    if (precision == ConversionPrecision::Fast) {
+        colorKernels().xyzd65ToOklabFast(x, y, z, oklabL, oklabA, oklabB, count);
+    } else {
+        colorKernels().xyzd65ToOklab(x, y, z, oklabL, oklabA, oklabB, count);
+    }
 }
 
 /** @internal
@@ -209,22 +375,74 @@ Trio fromXyzd65ToOklab(const Trio &value)
  * CIE 1931 XYZ color space</a>. The XYZ value has
  * <a href="https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab">
  * “a D65 whitepoint and white as Y=1”</a>. */
-Trio fromOklabToXyzd65(const Trio &value)
+Vector3 fromOklabToXyzd65(const Vector3 &value)
 {
     // The following algorithm is as described in
     // https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab
     //
     // Oklab: “The inverse operation, going from Oklab to XYZ is done with
     // the following steps:”
-    auto lms = (*m2inverse) * value; // NOTE Might contain negative entries
+    auto lms = multiplyMatrix3(oklabM2Inverse, value); // NOTE Might contain negative entries
     // LMS (long, medium, short) is the response of the three types of
     // cones of the human eye.
 
-    lms(/*row*/ 0, /*column*/ 0) = std::pow(lms(/*row*/ 0, /*column*/ 0), 3);
-    lms(/*row*/ 1, /*column*/ 0) = std::pow(lms(/*row*/ 1, /*column*/ 0), 3);
-    lms(/*row*/ 2, /*column*/ 0) = std::pow(lms(/*row*/ 2, /*column*/ 0), 3);
+    lms[0] = lms[0] * lms[0] * lms[0];
+    lms[1] = lms[1] * lms[1] * lms[1];
+    lms[2] = lms[2] * lms[2] * lms[2];
+
+    return multiplyMatrix3(oklabM1Inverse, lms);
+}
+
+/** @internal
+ *
+ * @brief Conversion from <a href="https://bottosson.github.io/posts/oklab/">
+ * Oklab color space</a> to
+ * <a href="https://en.wikipedia.org/wiki/CIE_1931_color_space#Definition_of_the_CIE_XYZ_color_space">
+ * CIE 1931 XYZ color space</a>.
+ *
+ * Convenience overload for @ref Trio.
+ *
+ * @param value The value to be converted
+ *
+ * @returns the same color in
+ * <a href="https://en.wikipedia.org/wiki/CIE_1931_color_space#Definition_of_the_CIE_XYZ_color_space">
+ * CIE 1931 XYZ color space</a>.
+ *
+ * @sa @ref fromOklabToXyzd65(const Vector3 &value) */
+Trio fromOklabToXyzd65(const Trio &value)
+{
+    const auto xyz = fromOklabToXyzd65( //
+        Vector3{value(0, 0), value(1, 0), value(2, 0)});
+    return Trio(xyz.data());
+}
 
-    return (*m1inverse) * lms;
+/** @internal
+ *
+ * @brief Batch conversion from
+ * <a href="https://bottosson.github.io/posts/oklab/">Oklab color space</a>
+ * to <a href="https://en.wikipedia.org/wiki/CIE_1931_color_space#Definition_of_the_CIE_XYZ_color_space">
+ * CIE 1931 XYZ color space</a>.
+ *
+ * Gives the same results as @ref fromOklabToXyzd65(const Vector3 &value),
+ * but works on whole arrays in structure-of-arrays layout. See
+ * @ref fromXyzd65ToOklab(const double *, const double *, const double *, double *, double *, double *, const qsizetype)
+ * for details about the memory layout.
+ *
+ * @param oklabL Array with the L values of the input colors
+ * @param oklabA Array with the a values of the input colors
+ * @param oklabB Array with the b values of the input colors
+ * @param x Array that will receive the X values of the output colors
+ * @param y Array that will receive the Y values of the output colors
+ * @param z Array that will receive the Z values of the output colors
+ * @param count Number of colors. Each of the arrays must hold at least
+ *        this number of elements.
+ *
+ * @note The conversion can be done in-place: An output array may be
+ * identical to an input array. Apart from that, the arrays must not
+ * overlap. */
+void fromOklabToXyzd65(const double *oklabL, const double *oklabA, const double *oklabB, double *x, double *y, double *z, const qsizetype count)
+{
+    colorKernels().oklabToXyzd65(oklabL, oklabA, oklabB, x, y, z, count);
 }
 
 /** @internal
@@ -235,23 +453,21 @@ Trio fromOklabToXyzd65(const Trio &value)
  * <a href="https://bottosson.github.io/posts/oklab/">Oklab color space</a>.
  *
  * @param cielabD50 The CIELab D50 value to be converted.
+ * @param precision Precision of the cube root calculation
  *
  * @returns the same color in
  * <a href="https://bottosson.github.io/posts/oklab/">Oklab color space</a>. */
-cmsCIELab fromCmscielabD50ToOklab(const cmsCIELab &cielabD50)
+cmsCIELab fromCmscielabD50ToOklab(const cmsCIELab &cielabD50, const ConversionPrecision precision)
 {
     cmsCIEXYZ xyzD50;
     cmsLab2XYZ(cmsD50_XYZ(), // white point (for both, XYZ and also Lab)
                &xyzD50, // output
                &cielabD50); // input
-    const double xyzD50Array[]{xyzD50.X, xyzD50.Y, xyzD50.Z};
-    const Trio xyzD50Matrix(xyzD50Array);
-    const auto resultMatrix = fromXyzd65ToOklab( //
-        (*xyzD50ToXyzD65) * xyzD50Matrix);
-    const cmsCIELab result = {resultMatrix(0, 0), //
-                              resultMatrix(1, 0), //
-                              resultMatrix(2, 0)};
-    return result;
+    const auto oklab = fromXyzd65ToOklab( //
+        multiplyMatrix3(xyzD50ToXyzD65, //
+                        Vector3{xyzD50.X, xyzD50.Y, xyzD50.Z}),
+        precision);
+    return cmsCIELab{oklab[0], oklab[1], oklab[2]};
 }
 
 /** @internal
@@ -268,11 +484,10 @@ cmsCIELab fromCmscielabD50ToOklab(const cmsCIELab &cielabD50)
  * CIELab D50 color space</a>. */
 cmsCIELab fromOklabToCmscielabD50(const cmsCIELab &oklab)
 {
-    const double oklabArray[] = {oklab.L, oklab.a, oklab.b};
-    const Trio oklabMatrix(oklabArray);
-    const auto xyzD65 = fromOklabToXyzd65(oklabMatrix);
-    const auto xyzD50 = (*xyzD65ToXyzD50) * xyzD65;
-    const cmsCIEXYZ cmsXyzD50{xyzD50(0, 0), xyzD50(1, 0), xyzD50(2, 0)};
+    const auto xyzD65 = fromOklabToXyzd65( //
+        Vector3{oklab.L, oklab.a, oklab.b});
+    const auto xyzD50 = multiplyMatrix3(xyzD65ToXyzD50, xyzD65);
+    const cmsCIEXYZ cmsXyzD50{xyzD50[0], xyzD50[1], xyzD50[2]};
     cmsCIELab result;
     cmsXYZ2Lab(cmsD50_XYZ(), // white point (for both, XYZ and also Lab)
                &result, // output
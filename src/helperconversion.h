@@ -10,6 +10,7 @@
 #include <lcms2.h>
 #include <qcolor.h>
 #include <qglobal.h>
+#include <qrgb.h>
 #include <type_traits>
 
 /** @internal
@@ -21,9 +22,59 @@
 namespace PerceptualColor
 {
 
+class LabBuffer;
+class LchBuffer;
 struct RgbDouble;
 
-[[nodiscard]] cmsCIELab fromCmscielabD50ToOklab(const cmsCIELab &cielabD50);
+/** @internal
+ *
+ * @brief Precision of conversions that involve a cube root.
+ *
+ * The conversion to Oklab needs a cube root for each of the three channels.
+ * Using the standard library for this is precise, but comparatively slow.
+ * Hot loops can choose a fast approximation instead. */
+enum class ConversionPrecision {
+    Precise, /**< Uses <tt>std::cbrt()</tt>. */
+    Fast /**< Uses @ref fastCubeRoot(), which has a maximum relative error
+    of @ref fastCubeRootMaximumRelativeError. The resulting error in Oklab
+    is well below the deviation limit that is used for the Oklab gamut
+    detection, so this is suitable for rendering and gamut
+    detection. */
+};
+
+void fromCartesianToPolar(const double *x, const double *y, double *radius, double *angleDegree, const qsizetype count);
+
+[[nodiscard]] cmsCIELab fromCmscielabD50ToOklab(const cmsCIELab &cielabD50, const ConversionPrecision precision = ConversionPrecision::Precise);
+
+/** @internal
+ *
+ * @brief Converts from <tt>[0, 1]</tt> to <tt>[0, 255]</tt> using
+ * fixed-point arithmetic.
+ *
+ * Gives the same result as the conversion within <tt>QColor</tt>, which
+ * first quantizes to 16 bit and then reduces to 8 bit with correct
+ * rounding. However, it does not construct a <tt>QColor</tt> object
+ * and it works without branches, so that the compiler can vectorize loops
+ * that call this function.
+ *
+ * @param original A value on a scale <tt>[0, 1]</tt>. Out-of-range
+ *        values are bound to the valid range. <tt>NaN</tt> gives
+ *        <tt>0</tt>.
+ *
+ * @returns Value converted to the scale <tt>[0, 255]</tt>.
+ *
+ * @sa @ref fromRgbDoubleToQRgb */
+[[nodiscard]] constexpr quint32 fromDoubleToEightBitFixedPoint(const double original)
+{
+    // qBound() maps NaN to the lower bound.
+    const double bounded = qBound<double>(0, original, 1);
+    // Adding 0.5 and truncating is correct rounding for non-negative
+    // values. The value fits into qint32, which is faster to convert
+    // to on many instruction sets than quint32.
+    const auto sixteenBit = static_cast<quint32>(static_cast<qint32>(bounded * 65535 + 0.5));
+    // Division by 257 with correct rounding (equivalent to qt_div_257)
+    return (sixteenBit - (sixteenBit >> 8) + 0x80) >> 8;
+}
 
 /** @internal
  *
@@ -44,14 +95,60 @@ template<typename T>
     return static_cast<quint8>(bounded);
 }
 
+void fromLabToLch(const double *labL, const double *labA, const double *labB, double *lchL, double *lchC, double *lchH, const qsizetype count);
+
+void fromLabToLch(const LabBuffer &lab, LchBuffer &lch);
+
+void fromLchToLab(const double *lchL, const double *lchC, const double *lchH, double *labL, double *labA, double *labB, const qsizetype count);
+
+void fromLchToLab(const LchBuffer &lch, LabBuffer &lab);
+
 [[nodiscard]] Trio fromOklabToXyzd65(const Trio &value);
 
+[[nodiscard]] Vector3 fromOklabToXyzd65(const Vector3 &value);
+
+void fromOklabToXyzd65(const double *oklabL, const double *oklabA, const double *oklabB, double *x, double *y, double *z, const qsizetype count);
+
 [[nodiscard]] cmsCIELab fromOklabToCmscielabD50(const cmsCIELab &oklab);
 
+void fromPolarToCartesian(const double *radius, const double *angleDegree, double *x, double *y, const qsizetype count);
+
 QColor fromRgbDoubleToQColor(const RgbDouble &color);
 
+/** @internal
+ *
+ * @brief Converts an RGB value to an opaque <tt>QRgb</tt>.
+ *
+ * Same result as <tt>QColor::fromRgbF(red, green, blue).rgb()</tt>, but
+ * faster. See @ref fromDoubleToEightBitFixedPoint() for details.
+ *
+ * @param red Red component. Range: <tt>[0, 1]</tt>
+ * @param green See above.
+ * @param blue See above.
+ *
+ * @returns The corresponding opaque <tt>QRgb</tt> value. */
+[[nodiscard]] constexpr QRgb fromRgbDoubleToQRgb(const double red, const double green, const double blue)
+{
+    constexpr quint32 opaqueAlpha = 0xFF000000;
+    return opaqueAlpha //
+        | (fromDoubleToEightBitFixedPoint(red) << 16) //
+        | (fromDoubleToEightBitFixedPoint(green) << 8) //
+        | fromDoubleToEightBitFixedPoint(blue);
+}
+
 [[nodiscard]] Trio fromXyzd65ToOklab(const Trio &value);
 
+[[nodiscard]] Vector3 fromXyzd65ToOklab(const Vector3 &value, const ConversionPrecision precision = ConversionPrecision::Precise);
+
+void fromXyzd65ToOklab(const double *x,
+                       const double *y,
+                       const double *z,
+                       double *oklabL,
+                       double *oklabA,
+                       double *oklabB,
+                       const qsizetype count,
+                       const ConversionPrecision precision = ConversionPrecision::Precise);
+
 /** @internal
  *
  * @brief Like <tt>QColor::fromRgbF</tt> but for all floating point types.
@@ -97,6 +194,66 @@ template<typename T>
  * Normalizing this to Y = 1 as expected by LittleCMS, gives this value. */
 constexpr cmsCIEXYZ whitePointD65TwoDegree{0.95047, 1.00000, 1.08883};
 
+// clang-format off
+
+/** @internal
+ *
+ * @brief Oklab matrix that converts from XYZ-D65 to an approximation of the
+ * cone responses (LMS).
+ *
+ * Source: <a href="https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab">
+ * Oklab</a> (“M1”).
+ *
+ * @sa @ref oklabM1Inverse */
+constexpr Matrix3 oklabM1{{
+    {+0.8189330101, +0.3618667424, -0.1288597137},
+    {+0.0329845436, +0.9293118715, +0.0361456387},
+    {+0.0482003018, +0.2643662691, +0.6338517070}}};
+
+/** @internal
+ *
+ * @brief Oklab matrix that converts from the non-linear cone responses
+ * to Oklab.
+ *
+ * Source: <a href="https://bottosson.github.io/posts/oklab/#converting-from-xyz-to-oklab">
+ * Oklab</a> (“M2”).
+ *
+ * @sa @ref oklabM2Inverse */
+constexpr Matrix3 oklabM2{{
+    {+0.2104542553, +0.7936177850, -0.0040720468},
+    {+1.9779984951, -2.4285922050, +0.4505937099},
+    {+0.0259040371, +0.7827717662, -0.8086757660}}};
+
+/** @internal
+ *
+ * @brief Bradford chromatic adaption from XYZ-D65 to XYZ-D50.
+ *
+ * Source: <a href="https://fujiwaratko.sakura.ne.jp/infosci/colorspace/bradford_e.html">
+ * Bradford transformation</a>
+ *
+ * @sa @ref xyzD50ToXyzD65 */
+constexpr Matrix3 xyzD65ToXyzD50{{
+    {+1.047886, +0.022919, -0.050216},
+    {+0.029582, +0.990484, -0.017079},
+    {-0.009252, +0.015073, +0.751678}}};
+
+// clang-format on
+
+/** @internal
+ *
+ * @brief Inverse of @ref oklabM1, calculated at compile time. */
+constexpr Matrix3 oklabM1Inverse = inverseMatrix3(oklabM1).value();
+
+/** @internal
+ *
+ * @brief Inverse of @ref oklabM2, calculated at compile time. */
+constexpr Matrix3 oklabM2Inverse = inverseMatrix3(oklabM2).value();
+
+/** @internal
+ *
+ * @brief Inverse of @ref xyzD65ToXyzD50, calculated at compile time. */
+constexpr Matrix3 xyzD50ToXyzD65 = inverseMatrix3(xyzD65ToXyzD50).value();
+
 } // namespace PerceptualColor
 
 #endif // HELPERCONVERSION_H
@@ -87,4 +87,26 @@ std::optional<SquareMatrix3> inverseMatrix(const SquareMatrix3 &matrix)
     return temp / determinant;
 }
 
+/** @internal
+ *
+ * @brief Batch version of @ref fastCubeRoot(const T value).
+ *
+ * The loop has no branches and no function calls, so the compiler can
+ * auto-vectorize it.
+ *
+ * @param input Array with the radicands
+ * @param output Array that will receive the results
+ * @param count Number of elements. Both arrays must hold at least
+ *        this number of elements.
+ *
+ * @note <em>input</em> and <em>output</em> may be identical, which
+ * allows in-place calculation. Apart from that, the arrays must not
+ * overlap. */
+void fastCubeRoot(const double *input, double *output, const qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        output[i] = fastCubeRoot(input[i]);
+    }
+}
+
 } // namespace PerceptualColor
@@ -4,7 +4,11 @@
 #ifndef HELPERMATH_H
 #define HELPERMATH_H
 
+#include "helperposixmath.h"
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <optional>
 #include <qgenericmatrix.h>
@@ -57,6 +61,34 @@ using SquareMatrix3 = QGenericMatrix<3, 3, double>;
  * @sa @ref createTrio() */
 using Trio = QGenericMatrix<1, 3, double>;
 
+/** @internal
+ *
+ * @brief A vector with 3 elements (double precision) that is usable
+ * in <tt>constexpr</tt> context.
+ *
+ * Unlike @ref Trio, this is a plain aggregate without any run-time
+ * initialization, which makes it suitable for hot loops and for constant
+ * expressions.
+ *
+ * @sa @ref Matrix3 */
+using Vector3 = std::array<double, 3>;
+
+/** @internal
+ *
+ * @brief A 3×3 matrix (double precision) that is usable
+ * in <tt>constexpr</tt> context.
+ *
+ * The storage is row-major: <tt>matrix[row][column]</tt>.
+ *
+ * Unlike @ref SquareMatrix3, this is a plain aggregate without any run-time
+ * initialization, which makes it suitable for hot loops and for constant
+ * expressions.
+ *
+ * @sa @ref Vector3
+ * @sa @ref multiplyMatrix3()
+ * @sa @ref inverseMatrix3() */
+using Matrix3 = std::array<Vector3, 3>;
+
 /** @internal
  *
  * @brief Convenience constructor for QGenericMatrix.
@@ -84,6 +116,82 @@ Trio createTrio(double first, double second, double third);
 
 std::optional<SquareMatrix3> inverseMatrix(const SquareMatrix3 &matrix);
 
+/** @internal
+ *
+ * @brief Matrix-vector product.
+ *
+ * @param matrix The matrix
+ * @param vector The (column) vector
+ *
+ * @returns The product <tt>matrix × vector</tt>. */
+[[nodiscard]] constexpr Vector3 multiplyMatrix3(const Matrix3 &matrix, const Vector3 &vector)
+{
+    return Vector3{
+        matrix[0][0] * vector[0] + matrix[0][1] * vector[1] + matrix[0][2] * vector[2],
+        matrix[1][0] * vector[0] + matrix[1][1] * vector[1] + matrix[1][2] * vector[2],
+        matrix[2][0] * vector[0] + matrix[2][1] * vector[1] + matrix[2][2] * vector[2]};
+}
+
+/** @internal
+ *
+ * @brief Matrix-matrix product.
+ *
+ * @param first The first matrix
+ * @param second The second matrix
+ *
+ * @returns The product <tt>first × second</tt>. */
+[[nodiscard]] constexpr Matrix3 multiplyMatrix3(const Matrix3 &first, const Matrix3 &second)
+{
+    Matrix3 result{};
+    for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t column = 0; column < 3; ++column) {
+            result[row][column] = first[row][0] * second[0][column] //
+                + first[row][1] * second[1][column] //
+                + first[row][2] * second[2][column];
+        }
+    }
+    return result;
+}
+
+/** @internal
+ *
+ * @brief Try to find the inverse matrix.
+ *
+ * This is the <tt>constexpr</tt> counterpart of @ref inverseMatrix(). It
+ * uses the very same algorithm, so both functions give identical results.
+ *
+ * @param matrix The original matrix.
+ *
+ * @returns If the original matrix is invertible, its inverse matrix.
+ * An empty value otherwise. */
+[[nodiscard]] constexpr std::optional<Matrix3> inverseMatrix3(const Matrix3 &matrix)
+{
+    const double a = matrix[0][0];
+    const double b = matrix[0][1];
+    const double c = matrix[0][2];
+    const double d = matrix[1][0];
+    const double e = matrix[1][1];
+    const double f = matrix[1][2];
+    const double g = matrix[2][0];
+    const double h = matrix[2][1];
+    const double i = matrix[2][2];
+    const double determinant = a * e * i //
+        + b * f * g //
+        + c * d * h //
+        - c * e * g //
+        - b * d * i //
+        - a * f * h;
+    if (determinant == 0) {
+        return std::nullopt;
+    }
+    // clang-format off
+    return Matrix3{{
+        {(e * i - f * h) / determinant, (c * h - b * i) / determinant, (b * f - c * e) / determinant},
+        {(f * g - d * i) / determinant, (a * i - c * g) / determinant, (c * d - a * f) / determinant},
+        {(d * h - e * g) / determinant, (b * g - a * h) / determinant, (a * e - b * d) / determinant}}};
+    // clang-format on
+}
+
 /** @internal
  *
  * @brief Template function to test if a value is within a certain range
@@ -230,6 +338,356 @@ template<typename A, typename B>
     }
 }
 
+/** @internal
+ *
+ * @brief Maximum relative error of @ref fastCubeRoot().
+ *
+ * This is the accuracy contract of @ref fastCubeRoot(): For every finite
+ * normal input value <em>x</em>, the result <em>r</em> fulfills
+ * <tt>|r − ∛x| ≤ fastCubeRootMaximumRelativeError × |∛x|</tt>.
+ * The actual maximum error, as measured by an exhaustive unit test, is
+ * about <tt>1.01 × 10⁻⁶</tt>.
+ *
+ * For the Oklab conversion, the cube root is applied to the LMS values,
+ * whose absolute value stays below 2 for all colors that are not
+ * extremely out-of-gamut. The result is then multiplied with
+ * a matrix whose maximum absolute row sum is smaller than 5. Therefore,
+ * the additional error in Oklab is smaller than
+ * <tt>2 × 5 × fastCubeRootMaximumRelativeError = 2 × 10⁻⁵</tt>,
+ * which is well below the <tt>oklabDeviationLimit</tt> of 0.001 that is
+ * used for gamut detection. */
+constexpr double fastCubeRootMaximumRelativeError = 2e-6;
+
+/** @internal
+ *
+ * @brief Fast approximation of the cube root.
+ *
+ * Other than <tt>std::pow(value, 1.0 / 3)</tt>, this function also accepts
+ * negative values, just like <tt>std::cbrt()</tt>.
+ *
+ * The initial guess comes from manipulating the bits of the IEEE 754
+ * representation directly: Dividing the biased exponent by 3 gives
+ * an estimate with a relative error of about 3 %. Two Newton iterations
+ * refine the estimate to the precision that is guaranteed
+ * by @ref fastCubeRootMaximumRelativeError.
+ *
+ * The function does not branch. Therefore, the compiler can
+ * auto-vectorize loops that call this function. See also
+ * @ref fastCubeRoot(const double *input, double *output, const qsizetype count)
+ * for a ready-to-use loop.
+ *
+ * Zero gives zero, infinity gives infinity and NaN gives NaN. Subnormal
+ * values (absolute value smaller than <tt>2.2 × 10⁻³⁰⁸</tt>) are flushed to
+ * zero; the absolute error is then smaller than <tt>3 × 10⁻¹⁰³</tt>.
+ *
+ * @tparam T A floating point type. Calculation is done with
+ * <tt>double</tt> precision.
+ *
+ * @param value The radicand
+ *
+ * @returns An approximation of the cube root of <em>value</em>, with the
+ * precision given by @ref fastCubeRootMaximumRelativeError. */
+template<typename T>
+[[nodiscard]] T fastCubeRoot(const T value)
+{
+    static_assert( //
+        std::is_floating_point<T>::value, //
+        "Template fastCubeRoot() only works with floating point types");
+    static_assert(sizeof(double) == sizeof(std::uint64_t));
+    static_assert(std::numeric_limits<double>::is_iec559);
+
+    const double radicand = std::abs(static_cast<double>(value));
+
+    // Initial guess: Divide the high word (exponent and the most
+    // significant bits of the mantissa) by 3 and correct the bias. The
+    // magic number is from fdlibm’s cbrt() implementation.
+    std::uint64_t bits;
+    std::memcpy(&bits, &radicand, sizeof(bits));
+    const auto highWord = static_cast<std::uint32_t>(bits >> 32);
+    constexpr std::uint32_t magicNumber = 715094163;
+    const std::uint64_t guessBits = //
+        static_cast<std::uint64_t>(highWord / 3 + magicNumber) << 32;
+    double guess;
+    std::memcpy(&guess, &guessBits, sizeof(guess));
+
+    // Newton iterations for f(y) = y³ − x
+    guess = (2 * guess + radicand / (guess * guess)) / 3;
+    guess = (2 * guess + radicand / (guess * guess)) / 3;
+
+    // The bit manipulation does not work for zero and subnormal values
+    // (exponent bits are all zero). Flush them to zero. The test is done
+    // on the bits and not with a floating point comparison, and the
+    // result is masked instead of calculated conditionally: Floating
+    // point operations might raise floating
+    // point exceptions, so the compiler could not auto-vectorize the code
+    // if there were conditional floating point operations.
+    // Likewise, infinity and NaN (exponent bits are all one) are passed
+    // through unchanged.
+    const std::uint32_t exponentBits = highWord >> 20;
+    // Unsigned negation turns true into all bits set:
+    const std::uint64_t zeroMask = //
+        -static_cast<std::uint64_t>(exponentBits != 0);
+    const std::uint64_t passThroughMask = //
+        -static_cast<std::uint64_t>(exponentBits == 0x7FF);
+    std::uint64_t resultBits;
+    std::memcpy(&resultBits, &guess, sizeof(resultBits));
+    resultBits = ((resultBits & ~passThroughMask) | (bits & passThroughMask)) //
+        & zeroMask;
+    double result;
+    std::memcpy(&result, &resultBits, sizeof(result));
+    return static_cast<T>(std::copysign(result, static_cast<double>(value)));
+}
+
+void fastCubeRoot(const double *input, double *output, const qsizetype count);
+
+/** @internal
+ *
+ * @brief Fast approximation of the exponential function.
+ *
+ * The argument is split into <em>k</em> × ln 2 + <em>r</em>, with an integer
+ * <em>k</em> and <em>r</em> within <tt>[−ln 2 / 2, ln 2 / 2]</tt>. The
+ * exponential function of <em>r</em> is calculated with its Taylor series,
+ * and the factor 2ᵏ is applied by constructing its IEEE 754 representation
+ * directly.
+ *
+ * The function does not branch and does not call library functions.
+ * Therefore, the compiler can auto-vectorize loops that call this
+ * function. (<tt>std::exp()</tt> cannot be auto-vectorized.)
+ *
+ * @tparam T A floating point type. Calculation is done with
+ * <tt>double</tt> precision.
+ *
+ * @param value The exponent. Values outside of <tt>[−700, 700]</tt> are
+ * bound to this range, so the result is always finite and not
+ * subnormal. Must not be NaN.
+ *
+ * @returns An approximation of <em>e</em> to the power of <em>value</em>,
+ * with the precision given by @ref fastExpMaximumRelativeError. */
+template<typename T>
+[[nodiscard]] T fastExp(const T value)
+{
+    static_assert( //
+        std::is_floating_point<T>::value, //
+        "Template fastExp() only works with floating point types");
+    static_assert(sizeof(double) == sizeof(std::uint64_t));
+    static_assert(std::numeric_limits<double>::is_iec559);
+
+    const double x = qBound(-700., static_cast<double>(value), 700.);
+
+    // Round x/ln(2) to the nearest integer k by adding 1.5 × 2⁵². See
+    // fastSinCosDegree() for details. The least significant bits of
+    // the mantissa of “shifted” contain k then.
+    constexpr double roundingShift = 0x1.8p52;
+    constexpr double log2e = 1.44269504088896340736;
+    const double shifted = x * log2e + roundingShift;
+    const double k = shifted - roundingShift;
+
+    // ln(2) as sum of two doubles for more precision. The first summand
+    // has enough trailing zero bits, so that the product with k is exact.
+    constexpr double ln2High = 0x1.62e42fee00000p-1;
+    constexpr double ln2Low = 0x1.a39ef35793c76p-33;
+    const double r = (x - k * ln2High) - k * ln2Low;
+
+    // Taylor series. Within [−ln(2)/2, ln(2)/2], the terms up to r¹² are
+    // enough for full double precision.
+    // clang-format off
+    const double exponentialOfR = 1 + r * (1 + r * (1. / 2 + r * (1. / 6
+        + r * (1. / 24 + r * (1. / 120 + r * (1. / 720 + r * (1. / 5040
+        + r * (1. / 40320 + r * (1. / 362880 + r * (1. / 3628800
+        + r * (1. / 39916800 + r * (1. / 479001600))))))))))));
+    // clang-format on
+
+    // 2ᵏ: Put k + 1023 (the exponent bias) into the exponent bits.
+    std::uint64_t shiftedBits;
+    std::memcpy(&shiftedBits, &shifted, sizeof(shiftedBits));
+    constexpr std::uint64_t roundingShiftBits = 0x4338000000000000;
+    const std::uint64_t scaleBits = (shiftedBits - roundingShiftBits + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+
+    return static_cast<T>(exponentialOfR * scale);
+}
+
+/** @internal
+ *
+ * @brief Maximum absolute error of @ref fastSinCosDegree().
+ *
+ * This is the accuracy contract of @ref fastSinCosDegree(): For every angle
+ * within <tt>[−360 000°, 360 000°]</tt>, both the sine and the cosine
+ * differ by at most this value from the exact result. The actual maximum
+ * error, as measured by a unit test, is about <tt>2.1 × 10⁻¹⁴</tt>.
+ *
+ * For the conversion from LCh to Lab, the error is multiplied by
+ * the chroma. Even for a chroma of 1000, which is far beyond any
+ * real-world color, the resulting error is smaller than <tt>10⁻⁹</tt>, which
+ * is many orders of magnitude below @ref gamutPrecisionCielab. */
+constexpr double fastSinCosMaximumError = 1e-12;
+
+/** @internal
+ *
+ * @brief Maximum absolute error of @ref fastAtan2Degree(), measured in
+ * degree.
+ *
+ * This is the accuracy contract of @ref fastAtan2Degree(). The actual
+ * maximum error, as measured by a unit test, is about
+ * <tt>6 × 10⁻¹⁴</tt> degree. Even for a chroma of 1000, this corresponds
+ * to a distance of less than <tt>10⁻⁹</tt> in the Lab plane, which
+ * is many orders of magnitude below @ref gamutPrecisionCielab. */
+constexpr double fastAtan2MaximumErrorDegree = 1e-12;
+
+/** @internal
+ *
+ * @brief Maximum relative error of @ref fastExp().
+ *
+ * This is the accuracy contract of @ref fastExp() for arguments within
+ * <tt>[−700, 700]</tt>. The actual maximum error, as measured by a unit
+ * test, is about <tt>4 × 10⁻¹⁶</tt>. */
+constexpr double fastExpMaximumRelativeError = 1e-14;
+
+/** @internal
+ *
+ * @brief Fast approximation of sine and cosine for angles in degree.
+ *
+ * The angle is reduced to the range <tt>[−45°, 45°]</tt>, and the sine and
+ * the cosine of the reduced angle are calculated with their Taylor series.
+ * The quadrant determines which of both values goes where and which
+ * sign it gets.
+ *
+ * The function does not branch and does not call library functions.
+ * Therefore, the compiler can auto-vectorize loops that call this
+ * function. (<tt>std::sin()</tt> and <tt>std::cos()</tt> cannot be
+ * auto-vectorized.)
+ *
+ * @tparam T A floating point type. Calculation is done with
+ * <tt>double</tt> precision.
+ *
+ * @param angleDegree The angle, measured in degree. Must be a finite value
+ * within <tt>[−360 000°, 360 000°]</tt>.
+ * @param sine Receives the sine of the angle.
+ * @param cosine Receives the cosine of the angle.
+ *
+ * The precision is given by @ref fastSinCosMaximumError. */
+template<typename T>
+void fastSinCosDegree(const T angleDegree, T &sine, T &cosine)
+{
+    static_assert( //
+        std::is_floating_point<T>::value, //
+        "Template fastSinCosDegree() only works with floating point types");
+    static_assert(sizeof(double) == sizeof(std::uint64_t));
+    static_assert(std::numeric_limits<double>::is_iec559);
+
+    const double angle = static_cast<double>(angleDegree);
+
+    // Round angle/90° to the nearest integer by adding 1.5 × 2⁵². At this
+    // magnitude, the spacing of doubles is exactly 1, so the addition
+    // rounds to an integer, which then is stored in the least
+    // significant bits of the mantissa. This works without
+    // conversion between floating point and integer types, which not all
+    // instruction sets can vectorize.
+    constexpr double roundingShift = 0x1.8p52;
+    const double shifted = angle * (1. / 90) + roundingShift;
+    const double quadrantCount = shifted - roundingShift;
+    std::uint64_t shiftedBits;
+    std::memcpy(&shiftedBits, &shifted, sizeof(shiftedBits));
+    const std::uint64_t quadrant = shiftedBits & 3;
+
+    // Reduced angle in radian, within [−π/4, π/4]
+    const double x = (angle - quadrantCount * 90) * (pi / 180);
+    const double x2 = x * x;
+
+    // Taylor series. Within [−π/4, π/4], the terms up to x¹³ (sine)
+    // respectively x¹⁴ (cosine) are enough for full double precision.
+    // clang-format off
+    const double sineReduced = x + x * x2 * (-1. / 6 + x2 * (1. / 120
+        + x2 * (-1. / 5040 + x2 * (1. / 362880 + x2 * (-1. / 39916800
+        + x2 * (1. / 6227020800))))));
+    const double cosineReduced = 1 + x2 * (-1. / 2 + x2 * (1. / 24
+        + x2 * (-1. / 720 + x2 * (1. / 40320 + x2 * (-1. / 3628800
+        + x2 * (1. / 479001600 + x2 * (-1. / 87178291200)))))));
+    // clang-format on
+
+    // Quadrant 1 and 3: sin(x + 90°) = cos(x), cos(x + 90°) = −sin(x)
+    const bool swap = (quadrant & 1) != 0;
+    const double sineUnsigned = swap ? cosineReduced : sineReduced;
+    const double cosineUnsigned = swap ? sineReduced : cosineReduced;
+    // Sine is negative in quadrant 2 and 3, cosine in quadrant 1 and 2.
+    const bool sineIsNegative = (quadrant & 2) != 0;
+    const bool cosineIsNegative = ((quadrant + 1) & 2) != 0;
+    sine = static_cast<T>(sineIsNegative ? -sineUnsigned : sineUnsigned);
+    cosine = static_cast<T>(cosineIsNegative ? -cosineUnsigned : cosineUnsigned);
+}
+
+/** @internal
+ *
+ * @brief Fast approximation of <tt>atan2</tt>, with the result in degree.
+ *
+ * The rational approximation for the arc tangent is the one
+ * from the <a href="https://www.netlib.org/cephes/">Cephes</a> library.
+ * The octant is handled without branching. Therefore, the compiler can
+ * auto-vectorize loops that call this function. (<tt>std::atan2()</tt>
+ * cannot be auto-vectorized.)
+ *
+ * @tparam T A floating point type. Calculation is done with
+ * <tt>double</tt> precision.
+ *
+ * @param y The y coordinate. Must be finite.
+ * @param x The x coordinate. Must be finite.
+ *
+ * @returns The angle of the point (x, y), measured in degree,
+ * normalized to the range <tt>[0°, 360°]</tt>. (Because of rounding, angles
+ * that are very slightly below 0° might give exactly 360°.) The angle of
+ * (0, 0) is 0°. The precision is given by
+ * @ref fastAtan2MaximumErrorDegree. */
+template<typename T>
+[[nodiscard]] T fastAtan2Degree(const T y, const T x)
+{
+    static_assert( //
+        std::is_floating_point<T>::value, //
+        "Template fastAtan2Degree() only works with floating point types");
+    const double xValue = static_cast<double>(x);
+    const double yValue = static_cast<double>(y);
+    const double absoluteX = std::abs(xValue);
+    const double absoluteY = std::abs(yValue);
+    const double maximum = qMax(absoluteX, absoluteY);
+    const double minimum = qMin(absoluteX, absoluteY);
+    // Within [0, 1]. Avoid division by zero for (0, 0).
+    const double ratio = minimum / ((maximum == 0) ? 1. : maximum);
+
+    // For ratios above tan(3π/8)−1 ≈ 0.66, use the identity
+    // atan(t) = π/4 + atan((t−1)/(t+1)), which gives a smaller argument.
+    const bool isBig = ratio > 0.66;
+    const double argument = isBig ? (ratio - 1) / (ratio + 1) : ratio;
+    const double z = argument * argument;
+    // clang-format off
+    const double numerator = (((-8.750608600031904122785e-1 * z
+        - 1.615753718733365076637e1) * z
+        - 7.500855792314704667340e1) * z
+        - 1.228866684490136173410e2) * z
+        - 6.485021904942025371773e1;
+    const double denominator = ((((z
+        + 2.485846490142306297962e1) * z
+        + 1.650270098316988542046e2) * z
+        + 4.328810604912902668951e2) * z
+        + 4.853903996359136964868e2) * z
+        + 1.945506571482613964425e2;
+    // clang-format on
+    // π/4 as sum of two doubles for more precision, like in Cephes: The
+    // low part is added to the small result of the polynomial before the
+    // high part is added.
+    constexpr double piQuarterLow = 0.5 * 6.123233995736765886130e-17;
+    const double polynomial = argument * z * numerator / denominator //
+        + argument //
+        + (isBig ? piQuarterLow : 0.);
+    const double firstOctant = (isBig ? pi / 4 : 0.) + polynomial;
+
+    // Reconstruct the full circle from the first octant.
+    double radian = (absoluteY > absoluteX) ? pi / 2 - firstOctant : firstOctant;
+    radian = (xValue < 0) ? pi - radian : radian;
+    radian = (yValue < 0) ? -radian : radian;
+    const double degree = radian * (180 / pi);
+    return static_cast<T>((degree < 0) ? degree + 360 : degree);
+}
+
 /** @internal
  *
  * @brief Normalizes an angle.
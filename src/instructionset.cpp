@@ -0,0 +1,137 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own header
+#include "instructionset.h"
+
+#include <qglobal.h>
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Name of the environment variable that forces a specific
+ * instruction set.
+ *
+ * @sa @ref activeInstructionSet() */
+constexpr char instructionSetEnvironmentVariable[] = "PERCEPTUALCOLOR_INSTRUCTION_SET";
+
+/** @internal
+ *
+ * @brief Detects the best instruction set that is supported by both,
+ * the CPU and the operating system.
+ *
+ * @returns The best instruction set that can be used on this machine.
+ *
+ * @sa @ref activeInstructionSet() */
+InstructionSet detectInstructionSet()
+{
+#ifdef PERCEPTUALCOLOR_X86_DISPATCH
+    // __builtin_cpu_supports() also checks (with XGETBV) if the operating
+    // system saves the extended registers on context switches.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return InstructionSet::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return InstructionSet::Avx2;
+    }
+#endif
+    return InstructionSet::Baseline;
+}
+
+/** @internal
+ *
+ * @returns All instruction sets that can be used on this machine, ordered
+ * from the simplest to the most advanced one. */
+QList<InstructionSet> availableInstructionSets()
+{
+    const auto detected = detectInstructionSet();
+    QList<InstructionSet> result;
+    for (int i = static_cast<int>(InstructionSet::Scalar); //
+         i <= static_cast<int>(detected);
+         ++i) {
+        result.append(static_cast<InstructionSet>(i));
+    }
+    return result;
+}
+
+/** @internal
+ *
+ * @param instructionSet The instruction set
+ *
+ * @returns A lower-case name of the instruction set, as accepted by
+ * @ref instructionSetFromName(). */
+QString instructionSetName(const InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+    case InstructionSet::Scalar:
+        return QStringLiteral("scalar");
+    case InstructionSet::Baseline:
+        return QStringLiteral("baseline");
+    case InstructionSet::Avx2:
+        return QStringLiteral("avx2");
+    case InstructionSet::Avx512:
+        return QStringLiteral("avx512");
+    }
+    return QString();
+}
+
+/** @internal
+ *
+ * @param name The name of an instruction set, as returned by
+ * @ref instructionSetName(). Case-insensitive. Additionally, “sse2” is
+ * accepted as an alias for @ref InstructionSet::Baseline.
+ *
+ * @returns The corresponding instruction set, or an empty value if the
+ * name is not known. */
+std::optional<InstructionSet> instructionSetFromName(const QString &name)
+{
+    const QString normalized = name.trimmed().toLower();
+    if (normalized == QStringLiteral("sse2")) {
+        return InstructionSet::Baseline;
+    }
+    for (int i = static_cast<int>(InstructionSet::Scalar); //
+         i <= static_cast<int>(InstructionSet::Avx512);
+         ++i) {
+        const auto candidate = static_cast<InstructionSet>(i);
+        if (normalized == instructionSetName(candidate)) {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+
+/** @internal
+ *
+ * @brief The instruction set that is actually used by the batch color
+ * conversion kernels.
+ *
+ * By default, this is @ref detectInstructionSet(). For testing and for
+ * benchmarking, the environment variable
+ * <tt>PERCEPTUALCOLOR_INSTRUCTION_SET</tt> can force a specific code path.
+ * Valid values are those of @ref instructionSetFromName(). Requesting an
+ * instruction set that is not supported by this machine falls back to
+ * the best supported one. Invalid values are ignored.
+ *
+ * The value is determined once, when this function is called for the
+ * first time. Later changes of the environment variable have no effect.
+ *
+ * @returns The instruction set that is used by @ref colorKernels(). */
+InstructionSet activeInstructionSet()
+{
+    static const InstructionSet result = []() {
+        const auto detected = detectInstructionSet();
+        const auto forced = instructionSetFromName( //
+            qEnvironmentVariable(instructionSetEnvironmentVariable));
+        if (!forced.has_value()) {
+            return detected;
+        }
+        return static_cast<InstructionSet>( //
+            qMin(static_cast<int>(forced.value()), static_cast<int>(detected)));
+    }();
+    return result;
+}
+
+} // namespace PerceptualColor
@@ -0,0 +1,74 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef INSTRUCTIONSET_H
+#define INSTRUCTIONSET_H
+
+#include <optional>
+#include <qlist.h>
+#include <qstring.h>
+
+/** @internal
+ *
+ * @file
+ *
+ * Runtime detection of the CPU instruction set that is used for the
+ * batch color conversion kernels.
+ *
+ * @sa @ref colorKernels() */
+
+/** @internal
+ *
+ * @brief Defined if the compiler and the architecture allow code paths
+ * for specific x86-64 instruction sets within a single binary.
+ *
+ * This requires the GCC-style <tt>target</tt> attribute and
+ * <tt>__builtin_cpu_supports()</tt>, which are available in GCC and Clang.
+ * Otherwise, only @ref PerceptualColor::InstructionSet::Scalar and
+ * @ref PerceptualColor::InstructionSet::Baseline are available. */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PERCEPTUALCOLOR_X86_DISPATCH
+#endif
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Instruction sets for which the batch color conversion kernels
+ * have specialized code paths.
+ *
+ * The enumerators are ordered: Each instruction set is a superset of
+ * the previous ones.
+ *
+ * @sa @ref activeInstructionSet()
+ * @sa @ref colorKernels() */
+enum class InstructionSet {
+    /** Reference implementation: The batch functions simply call the
+     * single-value functions for each value, without any vectorization.
+     * This is slow, but it is available on all platforms and serves as
+     * reference for testing the other code paths. */
+    Scalar = 0,
+    /** The instruction set that the library is compiled for by default.
+     * On x86-64, this is SSE2. On other architectures, this is whatever
+     * the compiler targets by default (for example NEON on AArch64). */
+    Baseline = 1,
+    /** AVX2 and FMA (x86-64 only). */
+    Avx2 = 2,
+    /** AVX-512 Foundation and AVX-512 DQ (x86-64 only). */
+    Avx512 = 3
+};
+
+[[nodiscard]] InstructionSet activeInstructionSet();
+
+[[nodiscard]] QList<InstructionSet> availableInstructionSets();
+
+[[nodiscard]] InstructionSet detectInstructionSet();
+
+[[nodiscard]] QString instructionSetName(const InstructionSet instructionSet);
+
+[[nodiscard]] std::optional<InstructionSet> instructionSetFromName(const QString &name);
+
+} // namespace PerceptualColor
+
+#endif // INSTRUCTIONSET_H
@@ -0,0 +1,93 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+// Own header
+#include "polarcoordinatetable.h"
+
+#include "helperconversion.h"
+#include "helpermath.h"
+#include <algorithm>
+#include <qlist.h>
+#include <qmutex.h>
+
+namespace PerceptualColor
+{
+
+/** @brief Constructor
+ *
+ * Calculates the table.
+ *
+ * @param imageSize The image size (width and height), measured in
+ *        pixels. */
+PolarCoordinateTable::PolarCoordinateTable(const int imageSize)
+    : m_half(qMax(imageSize, 0) / 2)
+    , m_imageSize(qMax(imageSize, 0))
+    , m_quadrantSize(m_imageSize - m_half)
+{
+    const auto quadrantSize = static_cast<std::size_t>(m_quadrantSize);
+    m_angleDegree.resize(quadrantSize * quadrantSize);
+    m_radius.resize(quadrantSize * quadrantSize);
+    // For odd image sizes, the center is in the middle of a pixel. For even
+    // image sizes, the center is between two pixels.
+    const double offset = isOdd(m_imageSize) ? 0 : 0.5;
+    std::vector<double> cartesianX(quadrantSize);
+    for (std::size_t column = 0; column < quadrantSize; ++column) {
+        cartesianX[column] = static_cast<double>(column) + offset;
+    }
+    std::vector<double> cartesianY(quadrantSize);
+    std::vector<double> radius(quadrantSize);
+    std::vector<double> angleDegree(quadrantSize);
+    for (std::size_t row = 0; row < quadrantSize; ++row) {
+        std::fill(cartesianY.begin(), cartesianY.end(), static_cast<double>(row) + offset);
+        fromCartesianToPolar(cartesianX.data(), //
+                             cartesianY.data(),
+                             radius.data(),
+                             angleDegree.data(),
+                             m_quadrantSize);
+        const auto rowBegin = row * quadrantSize;
+        for (std::size_t column = 0; column < quadrantSize; ++column) {
+            m_radius[rowBegin + column] = static_cast<float>(radius[column]);
+            m_angleDegree[rowBegin + column] = static_cast<float>(angleDegree[column]);
+        }
+    }
+}
+
+/** @brief Table for a given image size.
+ *
+ * @param imageSize The image size (width and height), measured in
+ *        pixels.
+ *
+ * @returns The table for the given image size. If a table for this image
+ * size is in the cache, it is returned immediately. Otherwise, a new table
+ * is calculated and added to the cache, which keeps the tables of the
+ * @ref cacheCapacity most recently used image sizes.
+ *
+ * This function is thread-safe. */
+QSharedPointer<const PolarCoordinateTable> PolarCoordinateTable::forImageSize(const int imageSize)
+{
+    static QMutex mutex;
+    // Most recently used table first
+    static QList<QSharedPointer<const PolarCoordinateTable>> cache;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QMutexLocker<QMutex> locker(&mutex);
+#else
+    QMutexLocker locker(&mutex);
+#endif
+    const int boundedSize = qMax(imageSize, 0);
+    for (int i = 0; i < cache.count(); ++i) {
+        if (cache.at(i)->imageSize() == boundedSize) {
+            const auto result = cache.at(i);
+            cache.move(i, 0);
+            return result;
+        }
+    }
+    QSharedPointer<const PolarCoordinateTable> result( //
+        new PolarCoordinateTable(boundedSize));
+    cache.prepend(result);
+    while (cache.count() > cacheCapacity) {
+        cache.removeLast();
+    }
+    return result;
+}
+
+} // namespace PerceptualColor
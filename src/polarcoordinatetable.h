@@ -0,0 +1,134 @@
+﻿// SPDX-FileCopyrightText: Lukas Sommer <sommerluk@gmail.com>
+// SPDX-License-Identifier: BSD-2-Clause OR MIT
+
+#ifndef POLARCOORDINATETABLE_H
+#define POLARCOORDINATETABLE_H
+
+#include <qglobal.h>
+#include <qsharedpointer.h>
+#include <vector>
+
+namespace PerceptualColor
+{
+
+/** @internal
+ *
+ * @brief Precalculated polar coordinates for the pixels of a square image.
+ *
+ * Diagrams with a circular form (like the color wheel or the chroma-hue
+ * diagram) need the polar coordinates of each pixel of their image.
+ * Calculating them for each pixel on each rendering is expensive. This
+ * class provides a table with the polar coordinates of all pixels of
+ * a square image of a given size.
+ *
+ * The coordinates refer to the middle of the pixel (the pixel at position
+ * (x, y) covers the square from (x, y) to (x + 1, y + 1)). The origin is the
+ * center of the image. The y axis points upwards (other than the y axis of
+ * <tt>QImage</tt>), so the angle is counterclockwise, like the hue in LCH.
+ * For a pixel at position (x, y) this means:
+ *
+ * - Cartesian x coordinate: <tt>x − (imageSize − 1) / 2</tt>
+ * - Cartesian y coordinate: <tt>(imageSize − 1) / 2 − y</tt>
+ *
+ * The table makes use of the symmetry of the square: It stores only one
+ * quadrant; the other quadrants are derived by mirroring. Values are
+ * stored as <tt>float</tt>, which is precise enough for rendering:
+ * The radius has a precision better than <tt>10⁻³</tt> pixels and the
+ * angle a precision better than <tt>10⁻⁴</tt>°, even for very big images.
+ *
+ * Tables are immutable and can be used from several threads at the same
+ * time. Use @ref forImageSize() to get a table. Tables for recently
+ * used image sizes are cached, so that subsequent renderings
+ * with the same image size (for example when only the lightness
+ * changes) do not have to calculate the table again.
+ *
+ * @sa @ref PolarPointF */
+class PolarCoordinateTable final
+{
+public:
+    [[nodiscard]] static QSharedPointer<const PolarCoordinateTable> forImageSize(const int imageSize);
+
+    /** @brief Angle of a pixel.
+     *
+     * @param x The x position of the pixel. Range:
+     *        <tt>[0, @ref imageSize()[</tt>
+     * @param y The y position of the pixel. Range:
+     *        <tt>[0, @ref imageSize()[</tt>
+     *
+     * @returns The angle, measured in degree. Range: <tt>[0°, 360°[</tt>.
+     * For the pixel at the very center (images with odd size), the angle
+     * is <tt>0°</tt>. */
+    [[nodiscard]] float angleDegree(const int x, const int y) const
+    {
+        float result = m_angleDegree[static_cast<std::size_t>(index(x, y))];
+        // Mirror the quadrant. The multiplications by 2 avoid fractions
+        // when comparing with the center (imageSize − 1) / 2.
+        if (2 * x + 1 < m_imageSize) {
+            result = 180 - result;
+        }
+        if (2 * y + 1 > m_imageSize) {
+            result = 360 - result;
+        }
+        return result;
+    }
+
+    /** @brief Image size.
+     *
+     * @returns The image size (width and height), measured in pixels. */
+    [[nodiscard]] int imageSize() const
+    {
+        return m_imageSize;
+    }
+
+    /** @brief Radius of a pixel.
+     *
+     * @param x The x position of the pixel. Range:
+     *        <tt>[0, @ref imageSize()[</tt>
+     * @param y The y position of the pixel. Range:
+     *        <tt>[0, @ref imageSize()[</tt>
+     *
+     * @returns The distance from the middle of the pixel to the center of
+     * the image, measured in pixels. */
+    [[nodiscard]] float radius(const int x, const int y) const
+    {
+        return m_radius[static_cast<std::size_t>(index(x, y))];
+    }
+
+private:
+    explicit PolarCoordinateTable(const int imageSize);
+
+    /** @internal @brief Only for unit tests. */
+    friend class TestPolarCoordinateTable;
+
+    /** @brief Index within the quadrant.
+     *
+     * @param x The x position of the pixel.
+     * @param y The y position of the pixel.
+     *
+     * @returns The index of the corresponding pixel within the stored
+     * quadrant. */
+    [[nodiscard]] qsizetype index(const int x, const int y) const
+    {
+        const int column = (x >= m_half) ? x - m_half : m_imageSize - 1 - x - m_half;
+        const int row = (y >= m_half) ? y - m_half : m_imageSize - 1 - y - m_half;
+        return static_cast<qsizetype>(row) * m_quadrantSize + column;
+    }
+
+    /** @brief Maximum number of tables that @ref forImageSize() keeps in
+     * its cache. */
+    static constexpr int cacheCapacity = 4;
+    /** @brief Angles of the stored quadrant, measured in degree. */
+    std::vector<float> m_angleDegree;
+    /** @brief Half of the image size, rounded down. */
+    int m_half = 0;
+    /** @brief Image size, measured in pixels. */
+    int m_imageSize = 0;
+    /** @brief Width (and height) of the stored quadrant. */
+    int m_quadrantSize = 0;
+    /** @brief Radii of the stored quadrant, measured in pixels. */
+    std::vector<float> m_radius;
+};
+
+} // namespace PerceptualColor
+
+#endif // POLARCOORDINATETABLE_H
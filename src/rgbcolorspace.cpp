@@ -7,8 +7,11 @@
 // Second, the private implementation.
 #include "rgbcolorspace_p.h" // IWYU pragma: associated
 
+#include "colorbuffer.h"
+#include "colorkernels.h"
 #include "constpropagatingrawpointer.h"
 #include "constpropagatinguniquepointer.h"
+#include "gamutoccupancygrid.h"
 #include "helperconstants.h"
 #include "helperconversion.h"
 #include "helpermath.h"
@@ -19,6 +22,7 @@
 #include "polarpointf.h"
 #include "rgbdouble.h"
 #include <limits>
+#include <memory>
 #include <optional>
 #include <qbytearray.h>
 #include <qcolor.h>
@@ -30,6 +34,8 @@
 #include <qrgba64.h>
 #include <qsharedpointer.h>
 #include <qstringliteral.h>
+#include <qtconcurrentrun.h>
+#include <vector>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <qcontainerfwd.h>
@@ -45,6 +51,85 @@
 
 namespace PerceptualColor
 {
+
+namespace
+{
+
+/** @internal
+ *
+ * @brief Number of colors that the buffer-based functions convert at once.
+ *
+ * LittleCMS expects interleaved channels. Therefore, the buffer-based
+ * functions copy the channels in chunks to interleaved temporary arrays.
+ * The chunks are small enough to stay in the cache. */
+constexpr qsizetype bufferChunkSize = 1024;
+
+/** @internal
+ *
+ * @brief Copies colors from a buffer to an interleaved array.
+ *
+ * @param lab The buffer
+ * @param begin Index of the first color to copy
+ * @param count Number of colors to copy
+ * @param result Array that will receive the colors */
+void copyToInterleaved(const LabBuffer &lab, const qsizetype begin, const qsizetype count, cmsCIELab *result)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = cmsCIELab{lab.l()[begin + i], lab.a()[begin + i], lab.b()[begin + i]};
+    }
+}
+
+/** @internal
+ *
+ * @brief Copies colors from a buffer to an interleaved array.
+ *
+ * @param rgb The buffer
+ * @param begin Index of the first color to copy
+ * @param count Number of colors to copy
+ * @param result Array that will receive the colors */
+void copyToInterleaved(const RgbBuffer &rgb, const qsizetype begin, const qsizetype count, RgbDouble *result)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result[i] = RgbDouble{rgb.red()[begin + i], rgb.green()[begin + i], rgb.blue()[begin + i]};
+    }
+}
+
+/** @internal
+ *
+ * @brief Copies colors from an interleaved array to a buffer.
+ *
+ * @param lab The interleaved array
+ * @param count Number of colors to copy
+ * @param result The buffer
+ * @param begin Index within the buffer for the first color */
+void copyFromInterleaved(const cmsCIELab *lab, const qsizetype count, LabBuffer &result, const qsizetype begin)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result.l()[begin + i] = lab[i].L;
+        result.a()[begin + i] = lab[i].a;
+        result.b()[begin + i] = lab[i].b;
+    }
+}
+
+/** @internal
+ *
+ * @brief Copies colors from an interleaved array to a buffer.
+ *
+ * @param rgb The interleaved array
+ * @param count Number of colors to copy
+ * @param result The buffer
+ * @param begin Index within the buffer for the first color */
+void copyFromInterleaved(const RgbDouble *rgb, const qsizetype count, RgbBuffer &result, const qsizetype begin)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        result.red()[begin + i] = rgb[i].red;
+        result.green()[begin + i] = rgb[i].green;
+        result.blue()[begin + i] = rgb[i].blue;
+    }
+}
+
+} // namespace
+
 /** @internal
  *
  * @brief Constructor
@@ -359,9 +444,59 @@ bool RgbColorSpacePrivate::initialize(cmsHPROFILE rgbProfileHandle)
     return true;
 }
 
+/** @brief Starts building the gamut occupancy grid in a background thread,
+ * unless this has been done yet.
+ *
+ * The build runs in @ref m_gamutOccupancyGridThreadPool. The grid is
+ * shared by all users of this color space, for example all diagrams
+ * that display it.
+ *
+ * This function is thread-safe.
+ *
+ * @pre The object is initialized completely; the grid relies on the
+ * transforms and on @ref m_profileMaximumCielchD50Chroma.
+ *
+ * @sa @ref gamutOccupancyGrid() */
+void RgbColorSpacePrivate::startGamutOccupancyGridBuild() const
+{
+    if (m_gamutOccupancyGridBuildStarted.exchange(true)) {
+        return;
+    }
+    m_gamutOccupancyGridThreadPool.setMaxThreadCount(1);
+    m_gamutOccupancyGridFuture = QtConcurrent::run(&m_gamutOccupancyGridThreadPool, [this]() {
+        const auto exactTest = [this](const cmsCIELab *lab, bool *result, const qsizetype count) {
+            isCielabD50InGamutExact(lab, result, count);
+        };
+        QSharedPointer<const GamutOccupancyGrid> grid{
+            new GamutOccupancyGrid(exactTest, //
+                                   m_profileMaximumCielchD50Chroma,
+                                   gamutOccupancyGridCellSize,
+                                   &m_gamutOccupancyGridAbort)};
+        if (grid->isValid()) {
+            m_gamutOccupancyGrid.store(grid.data(), std::memory_order_release);
+        }
+        return grid;
+    });
+}
+
+/** @brief The gamut occupancy grid.
+ *
+ * This function is thread-safe.
+ *
+ * @returns The gamut occupancy grid, or <tt>nullptr</tt> if it is not
+ * yet available. */
+const GamutOccupancyGrid *RgbColorSpacePrivate::gamutOccupancyGrid() const
+{
+    return m_gamutOccupancyGrid.load(std::memory_order_acquire);
+}
+
 /** @brief Destructor */
 RgbColorSpace::~RgbColorSpace() noexcept
 {
+    // The background build uses the transforms, so it has to
+    // finish before the transforms are deleted.
+    d_pointer->m_gamutOccupancyGridAbort.store(true);
+    d_pointer->m_gamutOccupancyGridFuture.waitForFinished();
     RgbColorSpacePrivate::deleteTransform( //
         &d_pointer->m_transformCielabD50ToRgb16Handle);
     RgbColorSpacePrivate::deleteTransform( //
@@ -987,6 +1122,49 @@ QRgb RgbColorSpace::fromCielchD50ToQRgbBound(const LchDouble &lch) const
                 qRound(rgb_int[2] / channelMaximumQReal * rgbMaximum));
 }
 
+/** @brief Conversion to QRgb.
+ *
+ * Buffer version of
+ * @ref fromCielchD50ToQRgbBound(const PerceptualColor::LchDouble &lch) const
+ * that gives the same results.
+ *
+ * @param lch Array with the colors
+ * @param result Array that will receive the results
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements. */
+void RgbColorSpace::fromCielchD50ToQRgbBound(const PerceptualColor::LchDouble *lch, QRgb *result, const qsizetype count) const
+{
+    // Process the data in chunks to limit the memory usage
+    // of the temporary buffers.
+    constexpr qsizetype chunkSize = 1024;
+    const auto bufferSize = static_cast<std::size_t>(qMin(count, chunkSize));
+    std::vector<cmsCIELab> lab(bufferSize);
+    std::vector<cmsUInt16Number> rgb16(3 * bufferSize);
+    constexpr qreal channelMaximumQReal = //
+        std::numeric_limits<cmsUInt16Number>::max();
+    constexpr quint8 rgbMaximum = 255;
+    for (qsizetype begin = 0; begin < count; begin += chunkSize) {
+        const qsizetype size = qMin(chunkSize, count - begin);
+        for (qsizetype i = 0; i < size; ++i) {
+            const cmsCIELCh myCmsCieLch = toCmsLch(lch[begin + i]);
+            cmsLCh2Lab(&lab[static_cast<std::size_t>(i)], // output
+                       &myCmsCieLch // input
+            );
+        }
+        cmsDoTransform(d_pointer->m_transformCielabD50ToRgb16Handle, // handle
+                       lab.data(), // input
+                       rgb16.data(), // output
+                       static_cast<cmsUInt32Number>(size));
+        for (qsizetype i = 0; i < size; ++i) {
+            const auto *const rgbInt = &rgb16[3 * static_cast<std::size_t>(i)];
+            result[begin + i] = //
+                qRgb(qRound(rgbInt[0] / channelMaximumQReal * rgbMaximum), //
+                     qRound(rgbInt[1] / channelMaximumQReal * rgbMaximum), //
+                     qRound(rgbInt[2] / channelMaximumQReal * rgbMaximum));
+        }
+    }
+}
+
 /** @brief Check if a color is within the gamut.
  * @param lch the color
  * @returns <tt>true</tt> if the color is in the gamut.
@@ -1048,6 +1226,127 @@ bool RgbColorSpace::isCielabD50InGamut(const cmsCIELab &lab) const
     return qAlpha(fromCielabD50ToQRgbOrTransparent(lab)) != 0;
 }
 
+/** @brief Check if colors are within the gamut.
+ *
+ * Batch version of @ref isCielabD50InGamut(const cmsCIELab &lab) const
+ * that gives the same results. It is considerably faster for many values:
+ * LittleCMS converts the whole batch at once, and the evaluation of the
+ * round-trip is done by @ref colorKernels(), which uses the best instruction
+ * set of the CPU.
+ *
+ * @param lab Array with the colors
+ * @param result Array that will receive the results: <tt>true</tt> if
+ *        the color is in the gamut. <tt>false</tt> otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements.
+ *
+ * @sa @ref isCielabD50InGamutApproximate() */
+void RgbColorSpace::isCielabD50InGamut(const cmsCIELab *lab, bool *result, const qsizetype count) const
+{
+    d_pointer->isCielabD50InGamutExact(lab, result, count);
+}
+
+/** @brief Check approximately if colors are within the gamut.
+ *
+ * Like @ref isCielabD50InGamut(const cmsCIELab *lab, bool *result, const qsizetype count) const
+ * but faster, at the price of being approximate: The answer is taken from
+ * a gamut occupancy grid, which samples the gamut at a cell size of
+ * 2 (in CIELab units). Only colors in cells near to the gamut boundary get
+ * the exact test. This is a heuristic: Gamut details that are smaller than
+ * a cell can be missed, so the result might differ from the exact test.
+ * Use this function only where an occasional wrong result is acceptable,
+ * for example to render a diagram; use the exact function where the result
+ * matters.
+ *
+ * The first call of this function starts building the grid in a background
+ * thread. As long as the grid is not available, all colors get the exact
+ * test. Therefore, the results for the same color might change once the
+ * grid is available.
+ *
+ * This function is thread-safe.
+ *
+ * @param lab Array with the colors
+ * @param result Array that will receive the results: <tt>true</tt> if
+ *        the color is in the gamut. <tt>false</tt> otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements. */
+void RgbColorSpace::isCielabD50InGamutApproximate(const cmsCIELab *lab, bool *result, const qsizetype count) const
+{
+    d_pointer->startGamutOccupancyGridBuild();
+    const GamutOccupancyGrid *const grid = d_pointer->gamutOccupancyGrid();
+    if (grid == nullptr) {
+        d_pointer->isCielabD50InGamutExact(lab, result, count);
+        return;
+    }
+    // Answer from the grid what is possible, and collect the
+    // colors near to the gamut boundary for the exact test.
+    std::vector<cmsCIELab> boundaryLab;
+    std::vector<qsizetype> boundaryIndex;
+    for (qsizetype i = 0; i < count; ++i) {
+        switch (grid->occupancy(lab[i])) {
+        case GamutOccupancyGrid::Occupancy::Inside:
+            result[i] = true;
+            break;
+        case GamutOccupancyGrid::Occupancy::Outside:
+            result[i] = false;
+            break;
+        case GamutOccupancyGrid::Occupancy::Boundary:
+            boundaryLab.push_back(lab[i]);
+            boundaryIndex.push_back(i);
+            break;
+        }
+    }
+    if (boundaryLab.empty()) {
+        return;
+    }
+    const auto boundaryCount = static_cast<qsizetype>(boundaryLab.size());
+    std::unique_ptr<bool[]> boundaryResult(new bool[boundaryLab.size()]);
+    d_pointer->isCielabD50InGamutExact(boundaryLab.data(), //
+                                       boundaryResult.get(),
+                                       boundaryCount);
+    for (qsizetype i = 0; i < boundaryCount; ++i) {
+        result[boundaryIndex[static_cast<std::size_t>(i)]] = //
+            boundaryResult[static_cast<std::size_t>(i)];
+    }
+}
+
+/** @brief Check if colors are within the gamut, without using the
+ * gamut occupancy grid.
+ *
+ * This function is thread-safe.
+ *
+ * @param lab Array with the colors
+ * @param result Array that will receive the results: <tt>true</tt> if
+ *        the color is in the gamut. <tt>false</tt> otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements.
+ *
+ * @sa @ref RgbColorSpace::isCielabD50InGamut(const cmsCIELab *lab, bool *result, const qsizetype count) const */
+void RgbColorSpacePrivate::isCielabD50InGamutExact(const cmsCIELab *lab, bool *result, const qsizetype count) const
+{
+    // Process the data in chunks to limit the memory usage
+    // of the temporary buffers.
+    constexpr qsizetype chunkSize = 1024;
+    std::vector<RgbDouble> rgb(static_cast<std::size_t>(qMin(count, chunkSize)));
+    std::vector<cmsCIELab> roundtrip(rgb.size());
+    const double maximumChromaSquare = //
+        m_profileMaximumCielchD50Chroma //
+        * m_profileMaximumCielchD50Chroma;
+    constexpr auto cielabDeviationLimitSquare = //
+        cielabDeviationLimit * cielabDeviationLimit;
+    for (qsizetype begin = 0; begin < count; begin += chunkSize) {
+        const qsizetype size = qMin(chunkSize, count - begin);
+        roundtripCielabD50(lab + begin, rgb.data(), roundtrip.data(), size);
+        colorKernels().cielabD50InGamut(lab + begin,
+                                        rgb.data(),
+                                        roundtrip.data(),
+                                        result + begin,
+                                        size,
+                                        maximumChromaSquare,
+                                        cielabDeviationLimitSquare);
+    }
+}
+
 /** @brief Conversion to QRgb.
  *
  * @pre
@@ -1111,10 +1410,200 @@ QRgb RgbColorSpace::fromCielabD50ToQRgbOrTransparent(const cmsCIELab &lab) const
     }
 
     // If in-gamut, return an opaque color.
-    QColor temp = QColor::fromRgbF(static_cast<QColorFloatType>(rgb.red), //
-                                   static_cast<QColorFloatType>(rgb.green), //
-                                   static_cast<QColorFloatType>(rgb.blue));
-    return temp.rgb();
+    return fromRgbDoubleToQRgb(rgb.red, rgb.green, rgb.blue);
+}
+
+/** @brief Conversion to QRgb.
+ *
+ * Batch version of
+ * @ref fromCielabD50ToQRgbOrTransparent(const cmsCIELab &lab) const
+ * that is considerably faster for many values: LittleCMS converts the
+ * whole batch at once, and the evaluation of the round-trip and the
+ * quantization to 8 bit are done by @ref colorKernels(), which uses
+ * the best instruction set of the CPU. The quantization uses fixed-point
+ * arithmetic; no <tt>QColor</tt> objects are involved. The result can be
+ * written directly to the scanline of a <tt>QImage</tt> with the format
+ * <tt>QImage::Format_ARGB32_Premultiplied</tt> (opaque and fully
+ * transparent values are identical in premultiplied and non-premultiplied
+ * form).
+ *
+ * Other than the single-value version, this function has no preconditions:
+ * Values with a lightness or chroma out of range give a transparent color.
+ *
+ * @param lab Array with the colors
+ * @param result Array that will receive the results: The corresponding
+ *        opaque color if the original color is in-gamut. A transparent
+ *        color otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements. */
+void RgbColorSpace::fromCielabD50ToQRgbOrTransparent(const cmsCIELab *lab, QRgb *result, const qsizetype count) const
+{
+    // Process the data in chunks to limit the memory usage
+    // of the temporary buffers.
+    constexpr qsizetype chunkSize = 1024;
+    std::vector<RgbDouble> rgb(static_cast<std::size_t>(qMin(count, chunkSize)));
+    std::vector<cmsCIELab> roundtrip(rgb.size());
+    const double maximumChromaSquare = //
+        d_pointer->m_profileMaximumCielchD50Chroma //
+        * d_pointer->m_profileMaximumCielchD50Chroma;
+    constexpr auto cielabDeviationLimitSquare = //
+        RgbColorSpacePrivate::cielabDeviationLimit //
+        * RgbColorSpacePrivate::cielabDeviationLimit;
+    for (qsizetype begin = 0; begin < count; begin += chunkSize) {
+        const qsizetype size = qMin(chunkSize, count - begin);
+        d_pointer->roundtripCielabD50(lab + begin, rgb.data(), roundtrip.data(), size);
+        colorKernels().cielabD50ToQRgbOrTransparent(lab + begin,
+                                                    rgb.data(),
+                                                    roundtrip.data(),
+                                                    result + begin,
+                                                    size,
+                                                    maximumChromaSquare,
+                                                    cielabDeviationLimitSquare);
+    }
+}
+
+/** @brief Conversion to QRgb without gamut test.
+ *
+ * Only the forward transform from CIELab to RGB is done, so this is about
+ * twice as fast as
+ * @ref fromCielabD50ToQRgbOrTransparent(const cmsCIELab *lab, QRgb *result, const qsizetype count) const.
+ * For in-gamut colors, the results of both functions are identical.
+ *
+ * @param lab Array with the colors
+ * @param result Array that will receive the results: The corresponding
+ *        opaque color if the original color is in-gamut. A more or less
+ *        similar opaque color otherwise.
+ * @param count Number of colors. Both arrays must hold at least this
+ *        number of elements.
+ *
+ * @note There is no guarantee <em>which</em> specific algorithm is used
+ * to fit out-of-gamut colors into the gamut. */
+void RgbColorSpace::fromCielabD50ToQRgbBound(const cmsCIELab *lab, QRgb *result, const qsizetype count) const
+{
+    // Process the data in chunks to limit the memory usage
+    // of the temporary buffer.
+    constexpr qsizetype chunkSize = 1024;
+    std::vector<RgbDouble> rgb(static_cast<std::size_t>(qMin(count, chunkSize)));
+    for (qsizetype begin = 0; begin < count; begin += chunkSize) {
+        const qsizetype size = qMin(chunkSize, count - begin);
+        cmsDoTransform(d_pointer->m_transformCielabD50ToRgbHandle, // handle
+                       lab + begin, // input
+                       rgb.data(), // output
+                       static_cast<cmsUInt32Number>(size));
+        for (qsizetype i = 0; i < size; ++i) {
+            const RgbDouble &color = rgb[static_cast<std::size_t>(i)];
+            result[begin + i] = //
+                fromRgbDoubleToQRgb(color.red, color.green, color.blue);
+        }
+    }
+}
+
+/** @brief Check if colors are within the gamut.
+ *
+ * Buffer version of @ref isCielabD50InGamut(const cmsCIELab &lab) const
+ * that gives the same results.
+ *
+ * @param lab Buffer with the colors
+ * @param result Array that will receive the results: <tt>true</tt> if
+ *        the color is in the gamut. <tt>false</tt> otherwise. Must hold at
+ *        least as many elements as <tt>lab</tt>. */
+void RgbColorSpace::isCielabD50InGamut(const LabBuffer &lab, bool *result) const
+{
+    std::vector<cmsCIELab> chunk(static_cast<std::size_t>(qMin(lab.size(), bufferChunkSize)));
+    for (qsizetype begin = 0; begin < lab.size(); begin += bufferChunkSize) {
+        const qsizetype size = qMin(bufferChunkSize, lab.size() - begin);
+        copyToInterleaved(lab, begin, size, chunk.data());
+        isCielabD50InGamut(chunk.data(), result + begin, size);
+    }
+}
+
+/** @brief Conversion to QRgb.
+ *
+ * Buffer version of
+ * @ref fromCielabD50ToQRgbOrTransparent(const cmsCIELab *lab, QRgb *result, const qsizetype count) const
+ * that gives the same results.
+ *
+ * @param lab Buffer with the colors
+ * @param result Array that will receive the results. Must hold at least
+ *        as many elements as <tt>lab</tt>. */
+void RgbColorSpace::fromCielabD50ToQRgbOrTransparent(const LabBuffer &lab, QRgb *result) const
+{
+    std::vector<cmsCIELab> chunk(static_cast<std::size_t>(qMin(lab.size(), bufferChunkSize)));
+    for (qsizetype begin = 0; begin < lab.size(); begin += bufferChunkSize) {
+        const qsizetype size = qMin(bufferChunkSize, lab.size() - begin);
+        copyToInterleaved(lab, begin, size, chunk.data());
+        fromCielabD50ToQRgbOrTransparent(chunk.data(), result + begin, size);
+    }
+}
+
+/** @brief Conversion to RGB.
+ *
+ * Buffer version of @ref fromCielchD50ToRgbDoubleUnbound(const PerceptualColor::LchDouble &lch) const
+ * that takes CIELab-D50 colors.
+ *
+ * @param lab Buffer with the original colors
+ * @param rgb Buffer that will receive the converted colors. It is resized
+ *        to the size of <tt>lab</tt>. For in-gamut colors, the result is
+ *        the corresponding in-range RGB color. For out-of-gamut colors,
+ *        the result might be in-range or out-of-range. */
+void RgbColorSpace::fromCielabD50ToRgbDoubleUnbound(const LabBuffer &lab, RgbBuffer &rgb) const
+{
+    rgb.resize(lab.size());
+    std::vector<cmsCIELab> labChunk(static_cast<std::size_t>(qMin(lab.size(), bufferChunkSize)));
+    std::vector<RgbDouble> rgbChunk(labChunk.size());
+    for (qsizetype begin = 0; begin < lab.size(); begin += bufferChunkSize) {
+        const qsizetype size = qMin(bufferChunkSize, lab.size() - begin);
+        copyToInterleaved(lab, begin, size, labChunk.data());
+        cmsDoTransform(d_pointer->m_transformCielabD50ToRgbHandle, // handle
+                       labChunk.data(), // input
+                       rgbChunk.data(), // output
+                       static_cast<cmsUInt32Number>(size));
+        copyFromInterleaved(rgbChunk.data(), size, rgb, begin);
+    }
+}
+
+/** @brief Conversion to CIELab.
+ *
+ * Buffer version of @ref toCielabD50(const QRgba64 rgbColor) const
+ *
+ * @param rgb Buffer with the original colors. Range of the values:
+ *        <tt>[0, 1]</tt>
+ * @param lab Buffer that will receive the converted colors. It is resized
+ *        to the size of <tt>rgb</tt>. */
+void RgbColorSpace::toCielabD50(const RgbBuffer &rgb, LabBuffer &lab) const
+{
+    lab.resize(rgb.size());
+    std::vector<RgbDouble> rgbChunk(static_cast<std::size_t>(qMin(rgb.size(), bufferChunkSize)));
+    std::vector<cmsCIELab> labChunk(rgbChunk.size());
+    for (qsizetype begin = 0; begin < rgb.size(); begin += bufferChunkSize) {
+        const qsizetype size = qMin(bufferChunkSize, rgb.size() - begin);
+        copyToInterleaved(rgb, begin, size, rgbChunk.data());
+        cmsDoTransform(d_pointer->m_transformRgbToCielabD50Handle, // handle
+                       rgbChunk.data(), // input
+                       labChunk.data(), // output
+                       static_cast<cmsUInt32Number>(size));
+        copyFromInterleaved(labChunk.data(), size, lab, begin);
+    }
+}
+
+/** @brief Round-trip conversion for the batch gamut detection.
+ *
+ * @param lab Array with the original colors
+ * @param rgb Array that will receive the corresponding RGB values
+ * @param roundtrip Array that will receive the round-trip values (the
+ *        RGB values converted back to CIELab-D50)
+ * @param count Number of colors. All arrays must hold at least this
+ *        number of elements. */
+void RgbColorSpacePrivate::roundtripCielabD50(const cmsCIELab *lab, RgbDouble *rgb, cmsCIELab *roundtrip, const qsizetype count) const
+{
+    cmsDoTransform(m_transformCielabD50ToRgbHandle, // handle
+                   lab, // input
+                   rgb, // output
+                   static_cast<cmsUInt32Number>(count));
+    cmsDoTransform(m_transformRgbToCielabD50Handle, // handle
+                   rgb, // input
+                   roundtrip, // output
+                   static_cast<cmsUInt32Number>(count));
 }
 
 /** @brief Conversion to @ref RgbDouble.
@@ -1180,7 +1669,11 @@ double RgbColorSpacePrivate::detectMaximumOklchChroma() const
         const auto qColorHue = static_cast<QColorFloatType>(hue / 360.);
         const auto rgbColor = QColor::fromHsvF(qColorHue, 1, 1).rgba64();
         const auto cielabD50Color = q_pointer->toCielabD50(rgbColor);
-        const auto oklab = fromCmscielabD50ToOklab(cielabD50Color);
+        // The deviation of the fast cube root is way below
+        // oklabDeviationLimit, which is added to the result anyway.
+        const auto oklab = fromCmscielabD50ToOklab( //
+            cielabD50Color,
+            ConversionPrecision::Fast);
         chromaSquare = qMax(chromaSquare, oklab.a * oklab.a + oklab.b * oklab.b);
         hue += chromaDetectionHuePrecision;
     }
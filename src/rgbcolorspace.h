@@ -29,6 +29,8 @@ Q_DECLARE_METATYPE(cmsProfileClassSignature)
 
 namespace PerceptualColor
 {
+class LabBuffer;
+class RgbBuffer;
 class RgbColorSpacePrivate;
 
 /** @internal
@@ -258,6 +260,9 @@ public: // Static factory functions
 public:
     virtual ~RgbColorSpace() noexcept override;
     [[nodiscard]] Q_INVOKABLE virtual bool isCielabD50InGamut(const cmsCIELab &lab) const;
+    virtual void isCielabD50InGamut(const cmsCIELab *lab, bool *result, const qsizetype count) const;
+    virtual void isCielabD50InGamutApproximate(const cmsCIELab *lab, bool *result, const qsizetype count) const;
+    virtual void isCielabD50InGamut(const PerceptualColor::LabBuffer &lab, bool *result) const;
     [[nodiscard]] Q_INVOKABLE virtual bool isCielchD50InGamut(const PerceptualColor::LchDouble &lch) const;
     [[nodiscard]] Q_INVOKABLE virtual bool isOklchInGamut(const PerceptualColor::LchDouble &lch) const;
     /** @brief Getter for property @ref profileAbsoluteFilePath
@@ -308,10 +313,16 @@ public:
     [[nodiscard]] Q_INVOKABLE virtual PerceptualColor::LchDouble reduceCielchD50ChromaToFitIntoGamut(const PerceptualColor::LchDouble &cielchD50color) const;
     [[nodiscard]] Q_INVOKABLE virtual PerceptualColor::LchDouble reduceOklchChromaToFitIntoGamut(const PerceptualColor::LchDouble &oklchColor) const;
     [[nodiscard]] Q_INVOKABLE virtual cmsCIELab toCielabD50(const QRgba64 rgbColor) const;
+    virtual void toCielabD50(const PerceptualColor::RgbBuffer &rgb, PerceptualColor::LabBuffer &lab) const;
     [[nodiscard]] Q_INVOKABLE virtual PerceptualColor::LchDouble toCielchD50Double(const QRgba64 rgbColor) const;
     [[nodiscard]] Q_INVOKABLE virtual QRgb fromCielchD50ToQRgbBound(const PerceptualColor::LchDouble &lch) const;
+    virtual void fromCielchD50ToQRgbBound(const PerceptualColor::LchDouble *lch, QRgb *result, const qsizetype count) const;
+    virtual void fromCielabD50ToQRgbBound(const cmsCIELab *lab, QRgb *result, const qsizetype count) const;
     [[nodiscard]] Q_INVOKABLE virtual QRgb fromCielabD50ToQRgbOrTransparent(const cmsCIELab &lab) const;
+    virtual void fromCielabD50ToQRgbOrTransparent(const cmsCIELab *lab, QRgb *result, const qsizetype count) const;
+    virtual void fromCielabD50ToQRgbOrTransparent(const PerceptualColor::LabBuffer &lab, QRgb *result) const;
     [[nodiscard]] Q_INVOKABLE virtual PerceptualColor::RgbDouble fromCielchD50ToRgbDoubleUnbound(const PerceptualColor::LchDouble &lch) const;
+    virtual void fromCielabD50ToRgbDoubleUnbound(const PerceptualColor::LabBuffer &lab, PerceptualColor::RgbBuffer &rgb) const;
 
 private:
     Q_DISABLE_COPY(RgbColorSpace)
@@ -334,6 +345,8 @@ private:
     /** @brief Pointer to implementation (pimpl) */
     ConstPropagatingUniquePointer<RgbColorSpacePrivate> d_pointer;
 
+    /** @internal @brief Only for unit tests. */
+    friend class TestColorKernelAccuracy;
     /** @internal @brief Only for unit tests. */
     friend class TestRgbColorSpace;
 };
@@ -9,18 +9,24 @@
 
 #include "cielchd50values.h"
 #include "constpropagatingrawpointer.h"
+#include "gamutoccupancygrid.h"
 #include "helperconstants.h"
 #include "oklchvalues.h"
+#include <atomic>
 #include <lcms2.h>
 #include <qdatetime.h>
+#include <qfuture.h>
 #include <qglobal.h>
 #include <qmap.h>
+#include <qsharedpointer.h>
 #include <qstring.h>
+#include <qthreadpool.h>
 #include <qversionnumber.h>
 
 namespace PerceptualColor
 {
 class RgbColorSpace;
+struct RgbDouble;
 
 /** @internal
  *
@@ -51,6 +57,33 @@ public:
     /** @brief The lightest in-gamut point on the L* axis.
      * @sa blackpointL() */
     qreal m_cielabD50WhitepointL = 100;
+    /** @brief The gamut occupancy grid, or <tt>nullptr</tt> as long
+     * as it is not yet available.
+     *
+     * The grid is owned by @ref m_gamutOccupancyGridFuture. This pointer
+     * is published by the background thread once the grid is complete;
+     * reading it needs no lock.
+     *
+     * @sa @ref gamutOccupancyGrid() */
+    mutable std::atomic<const GamutOccupancyGrid *> m_gamutOccupancyGrid{nullptr};
+    /** @brief Requests the background thread to abort building
+     * the gamut occupancy grid. */
+    std::atomic<bool> m_gamutOccupancyGridAbort{false};
+    /** @brief Whether the build of the gamut occupancy grid has
+     * been started.
+     *
+     * @sa @ref startGamutOccupancyGridBuild() */
+    mutable std::atomic<bool> m_gamutOccupancyGridBuildStarted{false};
+    /** @brief The background build of the gamut occupancy grid.
+     *
+     * @sa @ref startGamutOccupancyGridBuild() */
+    mutable QFuture<QSharedPointer<const GamutOccupancyGrid>> m_gamutOccupancyGridFuture;
+    /** @brief The thread pool for building the gamut occupancy grid.
+     *
+     * A dedicated pool with a single thread, so that the build does
+     * not occupy the global thread pool, which is used for rendering
+     * diagrams. */
+    mutable QThreadPool m_gamutOccupancyGridThreadPool;
     /** @brief The darkest in-gamut point on the L* axis.
      * @sa whitepointL
      *
@@ -118,10 +151,14 @@ public:
     static void deleteTransform(cmsHTRANSFORM *transformHandle);
     [[nodiscard]] double detectMaximumCielchD50Chroma() const;
     [[nodiscard]] double detectMaximumOklchChroma() const;
+    [[nodiscard]] const GamutOccupancyGrid *gamutOccupancyGrid() const;
     [[nodiscard]] static QDateTime getCreationDateTimeFromProfile(cmsHPROFILE profileHandle);
     [[nodiscard]] static QVersionNumber getIccVersionFromProfile(cmsHPROFILE profileHandle);
     [[nodiscard]] static QString getInformationFromProfile(cmsHPROFILE profileHandle, cmsInfoType infoType);
     [[nodiscard]] bool initialize(cmsHPROFILE rgbProfileHandle);
+    void isCielabD50InGamutExact(const cmsCIELab *lab, bool *result, const qsizetype count) const;
+    void roundtripCielabD50(const cmsCIELab *lab, RgbDouble *rgb, cmsCIELab *roundtrip, const qsizetype count) const;
+    void startGamutOccupancyGridBuild() const;
 
     /** @brief The rendering intents supported by the LittleCMS library.
      *
@@ -198,6 +235,14 @@ public:
      * gamut boundary. But it must unfortunately also be big enough to ignore
      * rounding errors. The current value was chosen by trial-and-error. */
     static constexpr qreal oklabDeviationLimit = 0.001;
+    /** @brief The cell size of the gamut occupancy grid.
+     *
+     * Measured in CIELab units. With this value, the grid for sRGB needs
+     * about 230 KiB and its background build takes some hundred
+     * milliseconds.
+     *
+     * @sa @ref GamutOccupancyGrid::cellSize() */
+    static constexpr double gamutOccupancyGridCellSize = 2;
 
 private:
     Q_DISABLE_COPY(RgbColorSpacePrivate)